@@ -0,0 +1,204 @@
+/******************************************************************************
+ * Benchmark matrix of the library on the host register simulator: every
+ * transfer mode (UART A0, SPI B0 and I2C B1 operations, interrupt and DMA
+ * driven) at each clock divisor and transfer size. Built against the FR5739
+ * register stand-in, once as is and once with -DUSIM_F5XX_MAP (the DMA
+ * trigger numbers and interrupt priority order of the F5510/F5342 on the same
+ * FR5739 model, not an F5xx simulation). Each case prints the
+ * usciSimBenchReport() line, named <map>/<operation>/brw<divisor>/<bytes>:
+ *
+ *	bench= bytes= cycles= bus_cycles= bytes_per_s= isr_per_byte= cpu_per_byte= access_per_byte= result=PASS|FAIL[,<checks>]
+ *
+ * and is checked for the data moved (result=FAIL,data) and, from BENCH_BLOCK
+ * bytes on (single bytes are dominated by the call setup), against the limits
+ * of its operation: throughput as a share of the wire rate, ISR entries and
+ * CPU cycles per byte. The exit status is non-zero when any case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#ifdef USIM_F5XX_MAP
+#define BENCH_HAL	"fr5739-f5xxdma"	///< Stand-in name (FR5739 model, F5xx DMA triggers and priorities)
+#else
+#define BENCH_HAL	"fr5739"	///< Stand-in name
+#endif // USIM_F5XX_MAP
+#define BENCH_MAX	1024		///< Largest transfer size
+#define BENCH_BLOCK	16		///< Smallest transfer size checked against the limits
+#define BENCH_I2C_ADDR	0x50		///< Address of the simulated I2C slave
+
+/// Operation of the matrix
+typedef struct benchop
+{
+	const char *name;		///< Name of the operation
+	unsigned char mod;		///< Simulated module
+	unsigned char op;		///< BENCH_xxx operation code
+	unsigned char dma;		///< Non-zero for the USCI_OPT_DMA app
+	unsigned int bits;		///< Bus clocks per byte (bits per frame)
+	unsigned int minWire;		///< Lowest throughput in % of the wire rate (0 for none)
+	usciSimLimits lim;		///< ISR and CPU limits (minBytesPerSec set per case)
+} benchOp;
+
+// Operation codes
+#define BENCH_WRITE	0		///< Write
+#define BENCH_READ	1		///< Read
+#define BENCH_SWAP	2		///< Byte swaps (SPI)
+#define BENCH_XFER	3		///< Full-duplex transfer (SPI)
+
+static const benchOp ops[] = {
+	{"uartA0Write", USIM_A0, BENCH_WRITE, 0, 10, 95, {0, 1100, 40}},
+	{"uartA0Read", USIM_A0, BENCH_READ, 0, 10, 95, {0, 1100, 50}},
+	{"uartA0WriteDma", USIM_A0, BENCH_WRITE, 1, 10, 95, {0, 200, 10}},
+	{"spiB0Write", USIM_B0, BENCH_WRITE, 0, 8, 55, {0, 1200, 40}},
+	{"spiB0Read", USIM_B0, BENCH_READ, 0, 8, 35, {0, 2100, 80}},
+	{"spiB0Swap", USIM_B0, BENCH_SWAP, 0, 8, 50, {0, 2100, 200}},
+	{"spiB0Transfer", USIM_B0, BENCH_XFER, 0, 8, 35, {0, 2100, 80}},
+	{"spiB0WriteDma", USIM_B0, BENCH_WRITE, 1, 8, 75, {0, 300, 10}},
+	{"spiB0ReadDma", USIM_B0, BENCH_READ, 1, 8, 75, {0, 100, 10}},
+	{"spiB0TransferDma", USIM_B0, BENCH_XFER, 1, 8, 75, {0, 100, 10}},
+	{"i2cB1Write", USIM_B1, BENCH_WRITE, 0, 9, 80, {0, 1300, 30}},
+	{"i2cB1Read", USIM_B1, BENCH_READ, 0, 9, 80, {0, 1300, 30}},
+};
+static const unsigned int uartDiv[] = {833, 69, 17};	///< UART divisors (9600, 115200 and 460800 baud at 8 MHz)
+static const unsigned int spiDiv[] = {16, 4, 2};	///< SPI bit clock divisors
+static const unsigned int i2cDiv[] = {80, 20};		///< I2C bit clock divisors (100 and 400 kHz at 8 MHz)
+static const unsigned int sizes[] = {1, 16, 256, BENCH_MAX};
+
+unsigned char data[BENCH_MAX];		///< Test pattern
+unsigned char rx[BENCH_MAX];		///< Receive buffer of the apps
+unsigned char out[USIM_BUF_SIZE];	///< Bytes captured from the bus
+usciConfig conf[] = {
+	{UCA0_UART, UART_8N1, DEF_CTLW1, 69, rx, 0},
+	{UCA0_UART, UART_8N1, DEF_CTLW1, 69, rx, USCI_OPT_DMA},
+	{UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, 4, rx, 0},
+	{UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, 4, rx, USCI_OPT_DMA},
+	{UCB1_I2C + BENCH_I2C_ADDR, I2C_7SMT, DEF_CTLW1, 20, rx, 0},
+};
+static int commID[sizeof(conf) / sizeof(conf[0])];	///< Comm IDs of the apps
+static unsigned int cases = 0;				///< Number of cases run
+static int fails = 0;					///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Comm ID of the app of an operation
+ *
+ * \param	*o	The operation
+ * \return	The comm ID
+ ******************************************************************************/
+static int opApp(const benchOp *o)
+{
+	if(o->mod == USIM_A0) return commID[o->dma];
+	if(o->mod == USIM_B0) return commID[2 + o->dma];
+	return commID[4];
+}
+/**************************************************************************//**
+ * \brief	Sets the clock divisor of the app of an operation and applies it
+ *
+ * The module is configured before the case starts (UART reads do not call
+ * confUCA0(), the configuration also resets the receive pointer).
+ *
+ * \param	*o	The operation
+ * \param	div	The divisor
+ ******************************************************************************/
+static void opBaud(const benchOp *o, unsigned int div)
+{
+	int id = opApp(o);
+
+	if(o->mod == USIM_A0){
+		setUCA0Baud(div, id);
+		confUCA0(id);
+	}
+	else if(o->mod == USIM_B0){
+		setUCB0Baud(div, id);
+		confUCB0(id);
+	}
+	else{
+		setUCB1Baud(div, id);
+		confUCB1(id);
+	}
+	usciSimIdle(USIM_LPM_TIMEOUT);
+}
+/**************************************************************************//**
+ * \brief	Runs and reports one case of the matrix
+ *
+ * \param	*o	The operation
+ * \param	div	The clock divisor
+ * \param	n	The transfer size
+ ******************************************************************************/
+static void runCase(const benchOp *o, unsigned int div, unsigned int n)
+{
+	usciSimLimits lim = o->lim;
+	usciSimBench res;
+	char name[64];
+	unsigned int k;
+	int id = opApp(o), ok;
+
+	opBaud(o, div);
+	memset(rx, 0, sizeof(rx));
+	usciSimDrain(o->mod, out, sizeof(out));
+	usciSimBenchStart(o->mod);
+	switch(o->op){
+	case BENCH_WRITE:
+		if(o->mod == USIM_A0) uartA0Write(data, n, id);
+		else if(o->mod == USIM_B0) spiB0Write(data, n, id);
+		else i2cB1Write(data, n, id);
+		break;
+	case BENCH_READ:
+		usciSimFeed(o->mod, data, n);
+		if(o->mod == USIM_B0) spiB0Read(n, id);
+		else if(o->mod == USIM_B1) i2cB1Read(n, id);
+		break;
+	case BENCH_SWAP:
+		usciSimFeed(o->mod, data, n);
+		for(k = 0; k < n; k++) rx[k] = spiB0Swap(data[k], id);
+		break;
+	case BENCH_XFER:
+		usciSimFeed(o->mod, data, n);
+		spiB0Transfer(data, rx, n, id);
+		break;
+	}
+	usciSimBenchEnd(o->mod, n, &res);
+	if(o->mod == USIM_A0 && o->op == BENCH_READ) uartA0Read(n, id);	// Bytes stored by the RX ISR as they came
+
+	if(o->minWire) lim.minBytesPerSec = USIM_SMCLK_FREQ / ((unsigned long)o->bits * div) * o->minWire / 100;
+	snprintf(name, sizeof(name), "%s/%s/brw%u/%u", BENCH_HAL, o->name, div, n);
+	cases++;
+	if(usciSimBenchReport(name, &res, n >= BENCH_BLOCK ? &lim : 0)) fails++;
+	if(o->op == BENCH_WRITE) ok = usciSimDrain(o->mod, out, sizeof(out)) == n && !memcmp(out, data, n);
+	else ok = !memcmp(rx, data, n);
+	if(!ok){
+		printf("bench=%s result=FAIL,data\n", name);
+		fails++;
+	}
+}
+
+int main(void)
+{
+	unsigned int i, d, s, nDiv;
+	const unsigned int *div;
+
+	for(i = 0; i < BENCH_MAX; i++) data[i] = i * 13 + 5;
+	usciSimReset();
+	__enable_interrupt();
+	for(i = 0; i < sizeof(conf) / sizeof(conf[0]); i++) commID[i] = registerComm(&conf[i]);
+	usciSimI2cSlave(USIM_B1, BENCH_I2C_ADDR);
+
+	for(i = 0; i < sizeof(ops) / sizeof(ops[0]); i++){
+		if(ops[i].mod == USIM_A0){
+			div = uartDiv;
+			nDiv = sizeof(uartDiv) / sizeof(uartDiv[0]);
+		}
+		else if(ops[i].mod == USIM_B0){
+			div = spiDiv;
+			nDiv = sizeof(spiDiv) / sizeof(spiDiv[0]);
+		}
+		else{
+			div = i2cDiv;
+			nDiv = sizeof(i2cDiv) / sizeof(i2cDiv[0]);
+		}
+		for(d = 0; d < nDiv; d++){
+			for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) runCase(&ops[i], div[d], sizes[s]);
+		}
+	}
+	printf("bench=%s cases=%u fails=%d\n", BENCH_HAL, cases, fails);
+	return fails != 0;
+}
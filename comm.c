@@ -1,1351 +1,853 @@
+#include <string.h>
 #include "comm.h"
 
-usciConfig *dev[MAX_DEVS];				///< Device config buffer (indexed by comm ID always non-zero)
-unsigned int devIndex = 0;				///< Device config buffer index
+USCI_CONF_CONST usciConfig *dev[MAX_DEVS+1];		///< Device config buffer (indexed by registry slot always non-zero, 0 when free)
+unsigned int devId[MAX_DEVS+1];				///< Comm ID issued for each registry slot (USCI_ID_FREE set once unregistered)
+#define USCI_SLOT_MASK		((1 << USCI_SLOT_BITS) - 1)			///< Registry slot bits of a comm ID
+#define USCI_GEN_MASK		(0x7FFF & ~USCI_SLOT_MASK)			///< Slot reuse count bits of a comm ID (comm IDs stay positive ints)
+#define USCI_ID_FREE		0x8000						///< Slot unregistered flag of devId[] (never part of a comm ID)
+#define USCI_SLOT(commID)	((commID) & USCI_SLOT_MASK)			///< Registry slot of a comm ID
+#define USCI_DEV(commID)	dev[USCI_SLOT(commID)]				///< Config of a registered comm ID
+#define USCI_ID_OK(commID)	commValid(commID)				///< O(1) check of a comm ID (registered and not stale)
+#ifdef USE_USCI_CONST_CONF
+unsigned int devBrw[MAX_DEVS+1];			///< Baud rate divisor of each registered app (const configs: setUCxxBaud() and auto-baud changes)
+#define USCI_BRW(commID)	devBrw[USCI_SLOT(commID)]			///< Current baud rate divisor of a registered comm ID
+#ifdef USE_UART_AUTOBAUD
+unsigned int devMctlw[MAX_DEVS+1];			///< UART modulation of each registered app (const configs: auto-baud changes)
+#define USCI_MCTLW(commID)	devMctlw[USCI_SLOT(commID)]			///< Current UART modulation of a registered comm ID
+#else
+#define USCI_MCTLW(commID)	USCI_DEV(commID)->mctlw				///< Current UART modulation of a registered comm ID (read only)
+#endif // USE_UART_AUTOBAUD
+#else
+#define USCI_BRW(commID)	USCI_DEV(commID)->baudDiv			///< Current baud rate divisor of a registered comm ID
+#define USCI_MCTLW(commID)	USCI_DEV(commID)->mctlw				///< Current UART modulation of a registered comm ID
+#endif // USE_USCI_CONST_CONF
+#ifdef USE_UART_IDLE
+unsigned int devIdle[MAX_DEVS+1];			///< Idle-line timeout ticks of each registered app at its current rate (0 for none)
+static unsigned int idleTicks(unsigned int commID);
+#endif // USE_UART_IDLE
 unsigned int devConf[4] = {0,0,0,0};			///< Currently applied configs buffer [A0, A1, B0, B1]
 unsigned char usciStat[4] = {OPEN, OPEN, OPEN, OPEN};	///< Store status (OPEN, TX, or RX) for [A0, A1, B0, B1]
+#ifdef USE_USCI_LPM
+unsigned char usciWait[4] = {0, 0, 0, 0};		///< Set while the app sleeps on the module for [A0, A1, B0, B1]
+#define USCI_WAKE(index)	do{ if(usciWait[index]) __bic_SR_register_on_exit(USCI_LPM_BITS); }while(0)	///< Leave the LPM on ISR exit if the app waits on the module
+#else
+#define USCI_WAKE(index)	do{ }while(0)		///< No low power waits
+#endif // USE_USCI_LPM
+#ifdef USE_USCI_CALLBACKS
+#define USCI_EVENT(index, hook)	do{ if(devConf[index] && USCI_DEV(devConf[index])->hook) USCI_DEV(devConf[index])->hook(devConf[index]); }while(0)	///< Call a completion hook of the configured app
+#define USCI_ERROR(index, err)	do{ if(devConf[index] && USCI_DEV(devConf[index])->onError) USCI_DEV(devConf[index])->onError(devConf[index], err); }while(0)	///< Call the error hook of the configured app
+#else
+#define USCI_EVENT(index, hook)	do{ }while(0)	///< No completion callbacks
+#define USCI_ERROR(index, err)	do{ }while(0)	///< No error callbacks
+#endif // USE_USCI_CALLBACKS
+#ifdef USE_USCI_STATS
+usciStats modStats[4];					///< Statistics counters for [A0, A1, B0, B1]
+usciStats commStats[MAX_DEVS+1];			///< Statistics counters per registry slot (0 counts UART bytes received with no app configured)
+#define USCI_STAT(index, commID, field, n)	do{ modStats[index].field += (n); commStats[USCI_SLOT(commID)].field += (n); }while(0)	///< Add to a counter of the module and of the app
+#define USCI_STAT_XFER(index, commID, tx, rx)	do{ USCI_STAT(index, commID, xfers, 1); USCI_STAT(index, commID, txBytes, tx); USCI_STAT(index, commID, rxBytes, rx); }while(0)	///< Count a transfer start
+#define USCI_BUSY(index, commID)	(modStats[index].busy++, commStats[USCI_SLOT(commID)].busy++, USCI_BUSY_ERROR)	///< Count a refused call (evaluates to USCI_BUSY_ERROR)
+#else
+#define USCI_STAT(index, commID, field, n)	do{ }while(0)	///< No statistics counters
+#define USCI_STAT_XFER(index, commID, tx, rx)	do{ }while(0)	///< No statistics counters
+#define USCI_BUSY(index, commID)	USCI_BUSY_ERROR	///< No statistics counters
+#endif // USE_USCI_STATS
+#ifdef USE_USCI_PROF
+usciProf modProf[4];					///< ISR and transfer timing profiles for [A0, A1, B0, B1]
+unsigned int profEntry[4];				///< Timer at the entry of the running ISR for [A0, A1, B0, B1]
+unsigned int profLast[4];				///< Timer when the running transfer was last accounted for [A0, A1, B0, B1]
+unsigned long profXfer[4];				///< Ticks accumulated by the running transfer for [A0, A1, B0, B1]
+unsigned char profRun[4] = {0, 0, 0, 0};		///< Set while a transfer is being timed for [A0, A1, B0, B1]
+#define USCI_PROF_ENTER(index)	profEnter(index, USCI_PROF_TIMER)	///< Timestamp the entry of a module ISR
+#define USCI_PROF_EXIT(index)	profExit(index, USCI_PROF_TIMER)	///< Timestamp the exit of a module ISR
+#define USCI_PROF_START(index)	profStart(index, USCI_PROF_TIMER)	///< Timestamp the start of a transfer
+#define USCI_PROF_DONE(index)	profDone(index, USCI_PROF_TIMER)	///< Timestamp the completion of a transfer
+#else
+#define USCI_PROF_ENTER(index)	do{ }while(0)	///< No ISR profiling
+#define USCI_PROF_EXIT(index)	do{ }while(0)	///< No ISR profiling
+#define USCI_PROF_START(index)	do{ }while(0)	///< No ISR profiling
+#define USCI_PROF_DONE(index)	do{ }while(0)	///< No ISR profiling
+#endif // USE_USCI_PROF
+#ifdef USE_USCI_CRC
+#ifdef CRCDIRB
+#define USCI_CRC(crc, byte)	do{ CRCINIRES = (crc); CRCDIRB_L = (byte); (crc) = CRCINIRES; }while(0)	///< CRC-16-CCITT update by the CRC16 module (bit reversed input: MSB first)
+#else
+static unsigned int crcCcitt(unsigned int crc, unsigned char byte);
+#define USCI_CRC(crc, byte)	((crc) = crcCcitt((crc), (byte)))	///< CRC-16-CCITT update in software (no CRC16 module, host build)
+#endif // CRCDIRB
+#endif // USE_USCI_CRC
+
+/**************************************************************************//**
+ * \brief	Checks a comm ID in constant time
+ *
+ * \param	commID	The comm ID to check
+ * \retval	1	Registered app (not unregistered since)
+ * \retval	0	Unknown or stale comm ID
+ ******************************************************************************/
+static int commValid(unsigned int commID)
+{
+	unsigned int slot = USCI_SLOT(commID);
 
+	return slot - 1 < MAX_DEVS && devId[slot] == commID;
+}
 /**************************************************************************//**
  * \brief Registers an application for use of a USCI module.
  *
  * Create a USCI "socket" by affiliating a unique comm ID with an
  * endpoint configuration for TI's eUSCI module.
  *
+ * The comm ID holds the registry slot taken (lowest free one) in its
+ * USCI_SLOT_BITS low bits and the number of times the slot was released in
+ * the bits above, so the ID of an unregistered app is refused (USCI_ID_ERROR)
+ * even once its slot has been reused. The first registration of each slot
+ * returns the slot number itself (1..MAX_DEVS).
+ *
  * \param	conf	The USCI configuration structure to be used (see comm.h)
  * \return	commID 	A positive (> 0) value representing the registered
  * 					app
  * \retval 	-1	The maximum number of apps (MAX_DEVS) has been registered
  ******************************************************************************/
-int registerComm(usciConfig *conf)
+int registerComm(USCI_CONF_CONST usciConfig *conf)
 {
-	if(devIndex >= MAX_DEVS) return -1;	// Check device list not full
-	dev[++devIndex] = conf;			// Copy config pointer into device list
-	return devIndex;
-}
-
-/****************************************************************
- * USCI A0 Variable Declarations
- ***************************************************************/
-#ifdef USE_UCA0
-unsigned char *uca0TxPtr;			///< USCI A0 TX Data Pointer
-unsigned char *uca0RxPtr;			///< USCI A0 RX Data Pointer
-unsigned int uca0TxSize = 0;			///< USCI A0 TX Size
-unsigned int uca0RxSize = 0;			///< USCI A0 RX Size
-// Conditional SPI Receive size
-#ifdef USE_UCA0_SPI
-unsigned int spiA0RxSize = 0;			///< USCI A0 To-RX Size (used for SPI RX)
-#endif //USE_UCA0_SPI
+	unsigned int status;
+	unsigned char slot;
 
-/**************************************************************
- * General Purpose USCI A0 Functions
- *************************************************************/
-// NOTE: This configuration is safe for use with single end-point UART and SPI config
-/**************************************************************************//**
- * \brief	Configures USCI A0 for operation
- *
- * Write control registers and clear system variables for the
- * USCI A0 module, which can be used as either a UART or SPI.
- *
- * NOTE: This config function is already called before any read/write function call
- * and therefore should (in almost all cases) never be called by the user.
- *
- * \param	commID	The communication ID for the registered app
+	enter_critical(status);
+	for(slot = 1; slot <= MAX_DEVS && dev[slot]; slot++);	// Lowest free slot
+	if(slot > MAX_DEVS){			// Check device list not full
+		exit_critical(status);
+		return -1;
+	}
+	dev[slot] = conf;			// Copy config pointer into device list
+	devId[slot] = (devId[slot] & USCI_GEN_MASK) | slot;
+#ifdef USE_USCI_CONST_CONF
+	devBrw[slot] = conf->baudDiv;
+#ifdef USE_UART_AUTOBAUD
+	devMctlw[slot] = conf->mctlw;
+#endif // USE_UART_AUTOBAUD
+#endif // USE_USCI_CONST_CONF
+#ifdef USE_UART_IDLE
+	devIdle[slot] = idleTicks(devId[slot]);	// Precomputed once, confUCxx() only copies it
+#endif // USE_UART_IDLE
+#ifdef USE_USCI_STATS
+	memset(&commStats[slot], 0, sizeof(usciStats));
+#endif // USE_USCI_STATS
+	exit_critical(status);
+	return devId[slot];
+}
+
+#ifdef USE_USCI_STATS
+/**************************************************************************//**
+ * \brief	Copies (and optionally clears) a set of statistics counters
+ *
+ * The copy is taken in a critical section, so the snapshot is consistent
+ * with respect to the ISRs updating the counters.
+ *
+ * \param	*src	The live counters
+ * \param	*stats	Destination for the snapshot (0 to only clear)
+ * \param	clear	Non-zero to reset the counters after the copy
  ******************************************************************************/
-void confUCA0(unsigned int commID)
+static void statsSnapshot(usciStats *src, usciStats *stats, unsigned char clear)
 {
 	unsigned int status;
 
-	if(devConf[UCA0_INDEX] == commID) return;		// Check if device is already configured
-	enter_critical(status);					// Perform config in critical section
-	UCA0CTL1 |= UCSWRST;					// Pause operation
-	UCA0_IO_CLEAR();					// Clear I/O for configuration
-
-	// Configure key control words
-	UCA0CTLW0 = dev[commID]->usciCtlW0 | UCSWRST;
-#ifdef UCA0CTLW1	// Check for control word 1 define (eUSCI vs USCI) future patch
-	UCA0CTLW1 = dev[commID]->usciCtlW1;
-#endif // UCA0CTLW1
-	UCA0BRW = dev[commID]->baudDiv;
-	uca0RxPtr = dev[commID]->rxPtr;
-
-	// Clear buffer sizes
-	uca0RxSize = 0;
-	uca0TxSize = 0;
-#ifdef USE_UCA0_SPI
-	spiA0RxSize = 0;
-#endif //USE_UCA0_SPI
-
-	UCA0_IO_CONF(dev[commID]->rAddr & ADDR_MASK);		// Port set up
-	UCA0CTL1 &= ~UCSWRST;					// Resume operation (clear software reset)
-	UCA0IE |= UCRXIE + UCTXIE;				// Enable Interrupts	
-
-	devConf[UCA0_INDEX] = commID;				// Store config
-	exit_critical(status);					// End critical section
+	enter_critical(status);
+	if(stats) *stats = *src;
+	if(clear) memset(src, 0, sizeof(usciStats));
+	exit_critical(status);
 }
 /**************************************************************************//**
- * \brief	Resets USCI A0 without writing over control regs
+ * \brief	Get method for the statistics counters of a USCI module
  *
- * This function is included to soft-reset the USCI A0 module
- * management variables without clearing the current config.
- * 
- * \param	commID	The comm ID of the registered app
- * \sideeffect	Sets the RX pointer to that registered w/ commID
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	*stats	Destination for the snapshot (0 to only clear)
+ * \param	clear	Non-zero to reset the module counters after the copy
  ******************************************************************************/
-void resetUCA0(unsigned int commID){
-	uca0RxPtr = dev[commID]->rxPtr;
-	uca0RxSize = 0;
-	uca0TxSize = 0;
-#ifdef USE_UCA0_SPI
-	spiA0RxSize = 0;
-#endif //USE_UCA0_SPI
-	usciStat[UCA0_INDEX] = OPEN;
-	return;
+void getModStats(unsigned char index, usciStats *stats, unsigned char clear)
+{
+	if(index < 4) statsSnapshot(&modStats[index], stats, clear);
 }
 /**************************************************************************//**
- * \brief	Get method for USCI A0 RX buffer size
- *
- * Returns the number of bytes which have been written
- * to the RX pointer (since the last read performed).
+ * \brief	Get method for the statistics counters of a registered app
  *
- * \return			The number of valid bytes following the rxPtr.
+ * \param	commID	The comm ID of the registered app (0 for the UART bytes
+ * 			received while no app was configured)
+ * \param	*stats	Destination for the snapshot (0 to only clear)
+ * \param	clear	Non-zero to reset the app counters after the copy
  ******************************************************************************/
-unsigned int getUCA0RxSize(void){
-	return uca0RxSize;
+void getCommStats(unsigned int commID, usciStats *stats, unsigned char clear)
+{
+	if(!commID || USCI_ID_OK(commID)) statsSnapshot(&commStats[USCI_SLOT(commID)], stats, clear);
 }
+#endif // USE_USCI_STATS
+
+/****************************************************************
+ * ISR and Transfer Profiling
+ ***************************************************************/
+#ifdef USE_USCI_PROF
 /**************************************************************************//**
- * \brief	Get method for USCI A0 status
+ * \brief	ISR entry hook: timestamps the entry of a module ISR
  *
- * Returns the status of the USCI module, either OPEN, TX, or RX
+ * The timer is read by the caller (first statement of the ISR), the time
+ * since the last ISR of a running transfer is added to the transfer, so
+ * transfers longer than the timer period are timed correctly as long as
+ * an ISR runs at least once per period.
  *
- * \retval	0	Indicates the OPEN status
- * \retval 	1	Indicates the TX Status
- * \retval 	2	Indicates the RX Status
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	now	The timer count at entry
  ******************************************************************************/
-unsigned char getUCA0Stat(void){
-	return usciStat[UCA0_INDEX];
-}
-
-/*************************************************************************//**
- * \brief	Set method for USCI A0 Baud Rate Divisor
- *
- * Sets the baud rate divisor of the USCI module, this divisor is generally
- * performed relative to the SMCLK rate of the system.
- *
- * \param 	baudDiv	The new divisor to apply
- * \param	commID	The communications ID number of the application
- *****************************************************************************/
-void setUCA0Baud(unsigned int baudDiv, unsigned int commID){
-	dev[commID]->baudDiv = baudDiv;		// Replace the baud divisor in memory
-	devConf[UCA0_INDEX] = 0;		// Reset the device config storage (config will be performed on next read/write)
-	return;
+static void profEnter(unsigned char index, unsigned int now)
+{
+	profEntry[index] = now;
+	if(profRun[index]){
+		profXfer[index] += (unsigned short)(now - profLast[index]);
+		profLast[index] = now;
+	}
 }
-/***************************************************************
-* UCA0 UART HANDLERS
- **************************************************************/
-#ifdef USE_UCA0_UART
 /**************************************************************************//**
- * \brief	Transmit method for USCI A0 UART operation
- *
- * This method initializes the transmission of len bytes from
- * the base of the *data pointer. The actual transmission itself
- * is finished a variable length of time from the write (based
- * upon len's value) in the TX ISR. Thus calling uartA0Write() twice in quick
- * succession will likely result in partial transmission of the first data.
- *
- * \param	*data	Pointer to data to be written
- * \param	len		Length (in bytes) of data to be written
- * \param	commID	Communication ID number of application
+ * \brief	ISR exit hook: accounts the duration of a module ISR
  *
- * \retval	-2		Incorrect resource code
- * \retval	-1		USCI A0 module busy
- * \retval	1		Transmit successfully started
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	now	The timer count at exit (last statement of the ISR)
  ******************************************************************************/
-int uartA0Write(unsigned char *data, unsigned int len, unsigned int commID)
+static void profExit(unsigned char index, unsigned int now)
 {
-	if(usciStat[UCA0_INDEX] != OPEN) return -1;		// Check that the USCI is available
-
-	confUCA0(commID);
+	usciProf *p = &modProf[index];
+	unsigned int ticks = (unsigned short)(now - profEntry[index]);	// 16 bit timer (wraps alike on any host int size)
+	unsigned int bin = ticks >> USCI_PROF_ISR_SHIFT;
 
-	// Copy over pointer and length
-	uca0TxPtr = data;
-	uca0TxSize = len-1;
-	// Write TXBUF (start of transmit) and set status
-	usciStat[UCA0_INDEX] = TX;
-	UCA0TXBUF = *uca0TxPtr;
-
-	return 1;
+	if(!p->isrCount || ticks < p->isrMin) p->isrMin = ticks;
+	if(ticks > p->isrMax) p->isrMax = ticks;
+	p->isrTicks += ticks;
+	p->isrCount++;
+	p->isrHist[bin < USCI_PROF_BINS ? bin : USCI_PROF_BINS - 1]++;
 }
 /**************************************************************************//**
- * \brief	Receive method for USCI A0 UART operation
+ * \brief	Transfer start hook: starts timing a transfer of a module
  *
- * This method spoofs an asynchronous read by providing the min of the
- * bytes available and the requested length. It decrements the buffer size
- * appropriately and returns bytes "read".
- *
- * \param	len	The number of bytes to be read from the buffer
- * \param	commID	The comm ID of the application
- * \return	The number of bytes available to read in the buffer. If the buffer
- * 			is empty this value will be 0.
- * \sideeffect	The uca0RxSize variable is decremented by the min of itself and
- * 				the requested amount of bytes (len).
- * \sa		This function does not make a call to #confUCA0 or check it the
- * 		state of the USCI module as it does  not interact with the
- * 		hardware module.
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	now	The timer count before the first byte is written
  ******************************************************************************/
-int uartA0Read(unsigned int len, unsigned int commID)
+static void profStart(unsigned char index, unsigned int now)
 {
-	// Read length determination = max(requested, available)
-	if(len > uca0RxSize) {
-		len = uca0RxSize;
-	}
-	uca0RxSize -= len;
-	return len;
+	profXfer[index] = 0;
+	profLast[index] = now;
+	profRun[index] = 1;
 }
-#endif // USE_UCA0_UART
-/***********************************************************
- * UCA0 SPI HANDLERS
- ***********************************************************/
-#ifdef USE_UCA0_SPI
 /**************************************************************************//**
- * \brief	Transmit method for USCI A0 SPI operation
- *
- * This method initializes a transmission of len bytes from the base of the
- * *data pointer. Similarly to uartA0Write(), the transmission uses the USCI A0
- * TX ISR to complete, so 2 sequential calls may result in partial transmission.
- *
- * \param	*data	Pointer to data to be written
- * \param	len	Length (in bytes) of data to be written
- * \param 	commID	Communication ID number of application
+ * \brief	Transfer completion hook: accounts the duration of a transfer
  *
- * \retval	-1	USCI A0 Module busy
- * \retval	1	Transmit successfully started
- *******************************************************************************/
-int spiA0Write(unsigned char *data, unsigned int len, unsigned int commID)
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	now	The timer count on completion
+ ******************************************************************************/
+static void profDone(unsigned char index, unsigned int now)
 {
-	if(usciStat[UCA0_INDEX] != OPEN) return -1;	// Check that USCI is available
+	usciProf *p = &modProf[index];
+	unsigned long ticks;
+	unsigned char bin = 0;
 
-	confUCA0(commID);
-	
-	// Copy over pointer and length
-	uca0TxPtr = data;
-	uca0TxSize = len-1;
-	// Start of TX
-	usciStat[UCA0_INDEX] = TX;
-	UCA0TXBUF = *uca0TxPtr;
+	if(!profRun[index]) return;
+	profRun[index] = 0;
+	ticks = profXfer[index] + (unsigned short)(now - profLast[index]);
 
-	return 1;
+	if(!p->xferCount || ticks < p->xferMin) p->xferMin = ticks;
+	if(ticks > p->xferMax) p->xferMax = ticks;
+	p->xferTicks += ticks;
+	p->xferCount++;
+	for(ticks >>= USCI_PROF_XFER_SHIFT; ticks && bin < USCI_PROF_BINS - 1; ticks >>= 1) bin++;	// Bit length of the scaled duration
+	p->xferHist[bin]++;
 }
 /**************************************************************************//**
- * \brief	Receive method for USCI A0 SPI operation
+ * \brief	Starts the profiling timer and clears the module profiles
  *
- * This method performs a synchronous read by storing the bytes to be read in
- * spiA0RxSize and then performing len dummy write to the bus to fetch the data
- * from a slave device. The RX size is cleared on this function call.
- *
- * \param	len	The number of bytes to be read from the bus
- * \param	commID	Communication ID number of the application
- *
- * \retval	-1	USCI A0 Module Busy
- * \retval	1	Receive successfully started
- *
- * \sideeffect	Reset the UCA0 RX size and data pointer
+ * Runs USCI_PROF_TIMER_INIT(), call once after the clock setup (and again
+ * whenever the timer clock changes).
  ******************************************************************************/
-int spiA0Read(unsigned int len, unsigned int commID)
+void startModProf(void)
 {
-	if(usciStat[UCA0_INDEX] != OPEN) return -1;	// Check that USCI is available
+	unsigned int status;
 
-	confUCA0(commID);
-	
-	// Clear RX Size/Buff and copy length
-	uca0RxSize = 0;					// Reset the rx size
-	uca0RxPtr = dev[commID]->rxPtr;			// Reset the rx pointer
-	spiA0RxSize = len;
-	// Start of RX
-	usciStat[UCA0_INDEX] = RX;
-	UCA0TXBUF = 0xFF;				// Start TX
-	return 1;
+	enter_critical(status);
+	USCI_PROF_TIMER_INIT();
+	memset(modProf, 0, sizeof(modProf));
+	memset(profRun, 0, sizeof(profRun));
+	exit_critical(status);
 }
 /**************************************************************************//**
- * \brief	Byte Swap method for USCI A0 SPI operation
- *
- * This blocking method allows the user to transmit a byte and receive the
- * response simultaneously clocked back in. TX and RX buffer sizes/content
- * are unaffected.
+ * \brief	Get method for the ISR and transfer timing profile of a module
  *
- * \param	byte	The byte to be sent via SPI
- * \param 	commID	Communication ID number of the application
+ * The copy is taken in a critical section, so the snapshot is consistent
+ * with respect to the ISRs updating the profile. The ISR budget per byte of
+ * a mode is read from the ISR histogram of a module running that mode (one
+ * ISR per byte, plus the start/stop conditions in I2C mode).
  *
- * \return	The byte shifted in from the SPI
- *************************************************************************/
-unsigned char spiA0Swap(unsigned char byte, unsigned int commID)
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	*prof	Destination for the snapshot (0 to only clear)
+ * \param	clear	Non-zero to reset the module profile after the copy
+ ******************************************************************************/
+void getModProf(unsigned char index, usciProf *prof, unsigned char clear)
 {
-	if(usciStat[UCA0_INDEX] != OPEN) return -1;	// Check that USCI is available
-
-	confUCA0(commID);
+	unsigned int status;
 
-	usciStat[UCA0_INDEX] = SWAP;			// Set status to swap (block other operation)	
-	UCA0TXBUF = byte;
-	while(UCA0STAT & UCBUSY);			// Wait for TX complete
-	usciStat[UCA0_INDEX] = OPEN;			// Set status to open (swap complete)
-	return UCA0RXBUF;				// Return RX contents
+	if(index >= 4) return;
+	enter_critical(status);
+	if(prof) *prof = modProf[index];
+	if(clear) memset(&modProf[index], 0, sizeof(usciProf));
+	exit_critical(status);
 }
-#endif //USE_UCA0_SPI
-/**********************************************************************//**
- * \brief	USCI A0 RX/TX Interrupt Service Routine
- *
- * This ISR manages all TX/RX proceedures with the exception of transfer
- * initialization. Once a transfer (read or write) is underway, this method
- * assures the correct amount of bytes are written to the correct location.
- *************************************************************************/
-#pragma vector=USCI_A0_VECTOR
-__interrupt void usciA0Isr(void)
-{
-	unsigned int dummy = 0xFF;
-	// Transmit Interrupt Flag Set
-	if(UCA0IFG & UCTXIFG){
-#ifdef USE_UCA0_SPI
-		if(usciStat[UCA0_INDEX] == TX){
-#endif
-		if(uca0TxSize > 0){
-			UCA0TXBUF = *(++uca0TxPtr);		// Transmit the next outgoing byte
-			uca0TxSize--;
-		}
-		else{
-			UCA0IFG &= ~UCTXIFG;			// Clear TX interrupt flag from vector on end of TX
-			usciStat[UCA0_INDEX] = OPEN; 		// Set status open if done with transmit
-		}
-#ifdef USE_UCA0_SPI
-		}
-#endif
-	}
-
-	// Receive Interrupt Flag Set
-	if(UCA0IFG & UCRXIFG){
-#ifdef USE_UCA0_SPI
-		if(usciStat[UCA0_INDEX] == RX){			// Check we are in RX mode for SPI
-#endif // USE_UCA0_SPI
-		if(UCA0STAT & UCRXERR) dummy = UCA0RXBUF;	// RX ERROR: Do a dummy read to clear interrupt flag
-		else {						// Otherwise write the value to the RX pointer
-			*(uca0RxPtr++) = UCA0RXBUF;
-			uca0RxSize++;				// RX Size decrement in read function
-#ifdef USE_UCA0_SPI
-			if(uca0RxSize < spiA0RxSize) UCA0TXBUF = dummy; // Perform another dummy write
-			else
-#endif
-			usciStat[UCA0_INDEX] = OPEN;
-		}
-#ifdef USE_UCA0_SPI
-		}
-#endif
-	}
-	UCA0IFG &= ~UCRXIFG;	// Clear RX interrupt flag from vector on end of RX
-}
-#endif // USE_UCA0
-
+#endif // USE_USCI_PROF
 
+#if defined(USE_USCI_CRC) && !defined(CRCDIRB)
 /****************************************************************
- * USCI A1 Variable Declarations
+ * Streaming CRC (software fallback)
  ***************************************************************/
-#ifdef USE_UCA1
-unsigned char *uca1TxPtr;		///< USCI A1 TX Data Pointer
-unsigned char *uca1RxPtr;		///< USCI A1 RX Data Pointer
-unsigned int uca1TxSize = 0;		///< USCI A1 TX Size
-unsigned int uca1RxSize = 0;		///< USCI A1 RX Size
-// Conditional SPI Receive size
-#ifdef USE_UCA1_SPI
-unsigned int spiA1RxSize = 0;		///< USCI A1 To-RX Size (used for SPI RX)
-#endif //USE_UCA1_SPI
-
-/**************************************************************
- * General Purpose USCI A1 Functions
- *************************************************************/
 /**************************************************************************//**
- * \brief	Configures USCI A1 for operation
- *
- * Write control registers and clear system variables for the
- * USCI A1 module, which can be used as either a UART or SPI.
+ * \brief	Updates a CRC-16-CCITT (polynomial 0x1021, MSB first) with a byte
  *
- * NOTE: This config function is already called before any read/write function call
- * and therefore should (in almost all cases) never be called by the user.
+ * Shift/XOR form of the byte-wise update (no table), for the targets (and the
+ * host build) without the CRC16 module.
  *
- * \param	commID	The communication ID for the registered app
+ * \param	crc	The running CRC
+ * \param	byte	The next data byte
+ * \return	The updated CRC
  ******************************************************************************/
-void confUCA1(unsigned int commID)
+static unsigned int crcCcitt(unsigned int crc, unsigned char byte)
 {
-	unsigned int status;
-	if(devConf[UCA1_INDEX] == commID) return;		// Check if device is already configured
-	enter_critical(status);					// Perform config in critical section
-	UCA1CTL1 |= UCSWRST;					// Pause operation
-	UCA1_IO_CLEAR();					// Clear I/O for config
-
-	// Configure key control words
-	UCA1CTLW0 = dev[commID]->usciCtlW0 | UCSWRST;
-#ifdef UCA1CTLW1	// Check for UCA1CTLW1 defined
-	UCA1CTLW1 = dev[commID]->usciCtlW1;
-#endif // UCA1CTLW1
-	UCA1BRW = dev[commID]->baudDiv;
-	uca1RxPtr = dev[commID]->rxPtr;
-
-	// Clear buffer sizes
-	uca1RxSize = 0;
-	uca1TxSize = 0;
-#ifdef USE_UCA1_SPI
-	spiA1RxSize = 0;
-#endif //USE_UCA1_SPI
-
-	UCA1_IO_CONF(dev[commID]->rAddr & ADDR_MASK);		// Port set up
-	UCA1CTL1 &= ~UCSWRST;					// Resume operation
-	UCA1IE |= UCRXIE + UCTXIE;				// Enable Interrupts	
-
-	devConf[UCA1_INDEX] = commID;				// Store config
-	exit_critical(status);					// End critical section
-}
-
-/**************************************************************************//**
- * \brief	Resets USCI A1 without writing over control regs
- *
- * This function is included to sof-reset the USCI A1 module
- * management variables without clearing the current config.
- *
- * \param	commID	The comm ID of the registered app
- * \sideeffect	Sets the RX pointer to that registered w/ commID
- ******************************************************************************/
-void resetUCA1(unsigned int commID){
-	uca1RxPtr = dev[commID]->rxPtr;
-	uca1RxSize = 0;
-	uca1TxSize = 0;
-#ifdef USE_UCA1_SPI
-	spiA1RxSize = 0;
-#endif //USE_UCA1_SPI
-	usciStat[UCA1_INDEX] = OPEN;
-	return;
-}
-/**************************************************************************//**
- * \brief	Get method for USCI A1 RX buffer size
- *
- * Returns the number of bytes which have been written
- * to the RX pointer (since the last read performed).
- *
- * \return	The number of valid bytes following the rxPtr.
- ******************************************************************************/
-unsigned int getUCA1RxSize(void){
-	return uca1RxSize;
-}
-/**************************************************************************//**
- * \brief	Get method for USCI A1 status
- *
- * Returns the status of the USCI module, either OPEN, TX, or RX
- *
- * \retval	0	Indicates the OPEN status
- * \retval 	1	Indicates the TX Status
- * \retval 	2	Indicates the RX Status
- ******************************************************************************/
-unsigned char getUCA1Stat(void){
-	return usciStat[UCA1_INDEX];
+	crc = ((crc >> 8) | (crc << 8)) & 0xFFFF;
+	crc ^= byte;
+	crc ^= (crc & 0xFF) >> 4;
+	crc ^= (crc << 12) & 0xFFFF;
+	crc ^= (crc & 0xFF) << 5;
+	return crc;
 }
+#endif // USE_USCI_CRC && !CRCDIRB
 
-/*************************************************************************//**
- * \brief	Set method for USCI A1 Baud Rate Divisor
- *
- * Sets the baud rate divisor of the USCI module, this divisor is generally
- * performed relative to the SMCLK rate of the system.
- *
- * \param 	baudDiv	The new divisor to apply
- * \param	commID	The communications ID number of the application
- *****************************************************************************/
-void setUCA1Baud(unsigned int baudDiv, unsigned int commID){
-	dev[commID]->baudDiv = baudDiv;		// Replace the baud divisor in memory
-	devConf[UCA1_INDEX] = 0;		// Reset the device config storage (config will be performed on next read/write)
-	return;
-}
-/***************************************************************
-* UCA1 UART HANDLERS
-***************************************************************/
-#ifdef USE_UCA1_UART
-/**************************************************************************//**
- * \brief	Transmit method for USCI A1 UART operation
- *
- * This method initializes the transmission of len bytes from
- * the base of the *data pointer. The actual transmission itself
- * is finished a variable length of time from the write (based
- * upon len's value) in the TX ISR. Thus calling uartA1Write() twice in quick
- * succession will likely result in partial transmission of the first data.
- *
- * \param	*data	Pointer to data to be written
- * \param	len		Length (in bytes) of data to be written
- * \param	commID	Communication ID number of application
- *
- * \retval	-2		Incorrect resource code
- * \retval	-1		USCI A1 module busy
- * \retval	1		Transmit successfully started
+#ifdef USE_UART_IDLE
+/****************************************************************
+ * UART Idle-Line Timeout
+ ***************************************************************/
+// Timer_A input dividers (ID and TAIDEX bits) of USCI_IDLE_TIMER_INIT()
+#if USCI_IDLE_TIMER_SHIFT == 0
+#define USCI_IDLE_TIMER_ID	ID__1
+#define USCI_IDLE_TIMER_IDEX	TAIDEX_0
+#elif USCI_IDLE_TIMER_SHIFT == 1
+#define USCI_IDLE_TIMER_ID	ID__2
+#define USCI_IDLE_TIMER_IDEX	TAIDEX_0
+#elif USCI_IDLE_TIMER_SHIFT == 2
+#define USCI_IDLE_TIMER_ID	ID__4
+#define USCI_IDLE_TIMER_IDEX	TAIDEX_0
+#elif USCI_IDLE_TIMER_SHIFT == 3
+#define USCI_IDLE_TIMER_ID	ID__8
+#define USCI_IDLE_TIMER_IDEX	TAIDEX_0
+#elif USCI_IDLE_TIMER_SHIFT == 4
+#define USCI_IDLE_TIMER_ID	ID__8
+#define USCI_IDLE_TIMER_IDEX	TAIDEX_1
+#elif USCI_IDLE_TIMER_SHIFT == 5
+#define USCI_IDLE_TIMER_ID	ID__8
+#define USCI_IDLE_TIMER_IDEX	TAIDEX_3
+#elif USCI_IDLE_TIMER_SHIFT == 6
+#define USCI_IDLE_TIMER_ID	ID__8
+#define USCI_IDLE_TIMER_IDEX	TAIDEX_7
+#else
+#error "USCI_IDLE_TIMER_SHIFT must be 0 to 6 (Timer_A divides by 64 at most)"
+#endif // USCI_IDLE_TIMER_SHIFT
+/**************************************************************************//**
+ * \brief	Converts the idle-line timeout of a UART app to timer ticks
+ *
+ * One bit lasts BRW SMCLK cycles, or 16 * UCBRx + UCBRFx in oversampling
+ * mode (the UCBRSx modulation is ignored). Timeouts past the timer range
+ * are clamped to 0xFFFF ticks (see USCI_IDLE_TIMER_SHIFT).
+ *
+ * \param	commID	The comm ID of the UART app (current rate)
+ * \return	The timeout in USCI_IDLE_TIMER ticks (0 for no timeout)
  ******************************************************************************/
-int uartA1Write(unsigned char *data, unsigned int len, unsigned int commID)
+static unsigned int idleTicks(unsigned int commID)
 {
-	if(usciStat[UCA1_INDEX] != OPEN) return -1;	// Check that the USCI is available
+	unsigned long bit = USCI_BRW(commID);
+	unsigned int mctlw = USCI_MCTLW(commID);
+	unsigned long ticks;
 
-	confUCA1(commID);
-
-	// Copy over pointer and length
-	uca1TxPtr = data;
-	uca1TxSize = len-1;
-	// Write TXBUF (start of transmit) and set status
-	usciStat[UCA1_INDEX] = TX;
-	UCA1TXBUF = *uca1TxPtr;
-
-	return 1;
+	if(!USCI_DEV(commID)->idleBits) return 0;
+	if(mctlw & UCOS16) bit = 16 * bit + ((mctlw >> 4) & 0x0F);
+	ticks = (bit * USCI_DEV(commID)->idleBits) >> USCI_IDLE_TIMER_SHIFT;
+	if(!ticks) return 1;
+	return ticks > 0xFFFF ? 0xFFFF : ticks;
 }
-/**************************************************************************//**
- * \brief	Receive method for USCI A1 UART operation
- *
- * This method spoofs an asynchronous read by providing the min of the
- * bytes available and the requested length. It decrements the buffer size
- * appropriately and returns bytes "read".
- *
- * \param	len		The number of bytes to be read from the buffer
- * \param	commID		The comm ID of the application
- * \return	The number of bytes available to read in the buffer. If the buffer
- * 		is empty this value will be 0.
- * \sideeffect	The ucA1RxSize variable is decremented by the min of itself and
- * 		the requested amount of bytes (len).
- * \sa		This function does not make a call to #confUCA0 or check it the
- * 		state of the USCI module as it does  not interact with the
- * 		hardware module.
+#endif // USE_UART_IDLE
+
+/****************************************************************
+ * DMA Transfer Engine
+ ***************************************************************/
+#ifdef USE_USCI_DMA
+#define DMA_FREE		0xFF		///< DMA engine owner code when no transfer is running
+#ifndef DMA_ADDR
+#define DMA_ADDR(reg, addr)	__data16_write_addr((unsigned short)&(reg), (unsigned long)(addr))	///< DMA address register write
+#endif // DMA_ADDR
+
+unsigned char dmaOwner = DMA_FREE;		///< USCI index of the module owning DMA channels 0 (TX) and 1 (RX)
+unsigned int dmaRxLen = 0;			///< Length of the running DMA receive (0 for transmit only)
+const unsigned char dmaDummy = 0xFF;		///< Dummy byte transmitted by DMA driven SPI reads
+
+/**************************************************************************//**
+ * \brief	Starts a DMA driven transfer on a USCI module
+ *
+ * Channel 0 feeds TXBUF on each rising edge of the module TX flag, channel 1
+ * (optional) empties RXBUF on each rising edge of the module RX flag. The
+ * caller writes the first byte to TXBUF itself (the triggers are edge
+ * sensitive) and masks the module interrupts so that the CPU is only involved
+ * at start and on completion (see usciDmaIsr()).
+ *
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	txTrig	The DMA trigger of the module TX flag
+ * \param	*txBuf	Address of the module TXBUF
+ * \param	*tx	Data to be transmitted (0 to transmit the 0xFF dummy byte)
+ * \param	txLen	Number of bytes channel 0 moves (the byte written by the caller excluded)
+ * \param	rxTrig	The DMA trigger of the module RX flag
+ * \param	*rxBuf	Address of the module RXBUF
+ * \param	*rx	Receive data pointer (0 for no receive channel)
+ * \param	rxLen	Number of bytes channel 1 moves
+ *
+ * \retval	0	DMA engine in use by another module (use the ISR instead)
+ * \retval	1	DMA channels armed
  ******************************************************************************/
-int uartA1Read(unsigned int len, unsigned int commID)
-{
-	if(len > uca1RxSize) {
-		len = uca1RxSize;
-	}
-	uca1RxSize -= len;
-	return len;
-}
-#endif // USE_UCA1_UART
-/***********************************************************
- * UCA1 SPI HANDLERS
- ***********************************************************/
-#ifdef USE_UCA1_SPI
-/**************************************************************************//**
- * \brief	Transmit method for USCI A1 SPI operation
- *
- * This method initializes a transmission of len bytes from the base of the
- * *data pointer. Similarly to uartA1Write(), the transmission uses the USCI A1
- * TX ISR to complete, so 2 sequential calls may result in partial transmission.
- *
- * \param	*data	Pointer to data to be written
- * \param	len		Length (in bytes) of data to be written
- * \param 	commID	Communication ID number of application
- *
- * \retval	-1		USCI A1 Module busy
- * \retval	1		Transmit successfully started
- *******************************************************************************/
-int spiA1Write(unsigned char *data, unsigned int len, unsigned int commID)
+static int dmaStart(unsigned char index, unsigned char txTrig, volatile void *txBuf, unsigned char *tx, unsigned int txLen,
+		unsigned char rxTrig, volatile void *rxBuf, unsigned char *rx, unsigned int rxLen)
 {
-	if(usciStat[UCA1_INDEX] != OPEN) return -1;	// Check that the USCI is available
-
-	confUCA1(commID);
-	
-	// Copy over pointer and length
-	uca1TxPtr = data;
-	uca1TxSize = len-1;
-	// Start of TX
-	usciStat[UCA1_INDEX] = TX;
-	UCA1TXBUF = *uca1TxPtr;
+	unsigned int status;
 
+	enter_critical(status);
+	if(dmaOwner != DMA_FREE){			// Check the DMA engine is available
+		exit_critical(status);
+		return 0;
+	}
+	dmaOwner = index;
+	dmaRxLen = rx ? rxLen : 0;
+	DMA0CTL = 0;
+	DMA1CTL = 0;
+	DMACTL0 = txTrig + (rxTrig << 8);		// Channel 0 on TX flag, channel 1 on RX flag
+
+	// Transmit channel (interrupts on completion for transmit only transfers)
+	DMA_ADDR(DMA0SA, tx ? tx : &dmaDummy);
+	DMA_ADDR(DMA0DA, txBuf);
+	DMA0SZ = txLen;
+	if(txLen) DMA0CTL = DMADT_0 + (tx ? DMASRCINCR_3 : DMASRCINCR_0) + DMADSTINCR_0 + DMASRCBYTE + DMADSTBYTE + (rx ? 0 : DMAIE) + DMAEN;
+
+	// Receive channel (interrupts on completion)
+	if(rx){
+		DMA_ADDR(DMA1SA, rxBuf);
+		DMA_ADDR(DMA1DA, rx);
+		DMA1SZ = rxLen;
+		DMA1CTL = DMADT_0 + DMASRCINCR_0 + DMADSTINCR_3 + DMASRCBYTE + DMADSTBYTE + DMAIE + DMAEN;
+	}
+	exit_critical(status);
 	return 1;
 }
 /**************************************************************************//**
- * \brief	Receive method for USCI A1 SPI operation
- *
- * This method performs a synchronous read by storing the bytes to be read in
- * spiA1RxSize and then performing len dummy write to the bus to fetch the data
- * from a slave device. The RX size is cleared on this function call.
- *
- * \param	len	The number of bytes to be read from the bus
- * \param	commID	Communication ID number of the application
- *
- * \retval	-1	USCI A1 Module Busy
- * \retval	1	Receive successfully started
- *
- * \sideeffect		Reset the UCA1 RX size and data pointer
+ * \brief	Stops the DMA channels and releases the DMA engine
  ******************************************************************************/
-int spiA1Read(unsigned int len, unsigned int commID)
+static void dmaStop(void)
 {
-	if(usciStat[UCA1_INDEX] != OPEN) return -1;	// Check that the USCI is available
-	
-	confUCA1(commID);
-	
-	// Clear RX Size and copy length
-	uca1RxSize = 0;					// Reset RX size
-	uca1RxPtr = dev[commID]->rxPtr;			// Reset RX pointer
-	spiA1RxSize = len;
-	// Start of RX
-	usciStat[UCA1_INDEX] = RX;
-	UCA1TXBUF = 0xFF;				// Start TX
-	return 1;
+	DMA0CTL = 0;
+	DMA1CTL = 0;
+	dmaRxLen = 0;
+	dmaOwner = DMA_FREE;
 }
-
-/**************************************************************************//**
- * \brief	Byte Swap method for USCI A1 SPI operation
- *
- * This blocking method allows the user to transmit a byte and receive the
- * response simultaneously clocked back in. TX and RX buffer sizes/content
- * are unaffected.
- *
- * \param	byte	The byte to be sent via SPI
- * \param 	commID	Communication ID number of the application
- *
- * \return	The byte shifted in from the SPI
- *************************************************************************/
-unsigned char spiA1Swap(unsigned char byte, unsigned int commID)
-{
-	if(usciStat[UCA1_INDEX] != OPEN) return -1;	// Check that the USCI is available
-
-	confUCA1(commID);
-
-	usciStat[UCA1_INDEX] = SWAP;			// Set status to swap (block other operation)
-	UCA1TXBUF = byte;
-	while(UCA1STAT & UCBUSY);			// Wait for TX complete
-	usciStat[UCA1_INDEX] = OPEN;			// Set status to open (swap complete)
-	return UCA1RXBUF;				// Return RX contents
-}
-#endif //USE_UCA1_SPI
-
-/**********************************************************************//**
- * \brief	USCI A1 RX/TX Interrupt Service Routine
- *
- * This ISR manages all TX/RX proceedures with the exception of transfer
- * initialization. Once a transfer (read or write) is underway, this method
- * assures the correct amount of bytes are written to the correct location.
- *************************************************************************/
-#pragma vector=USCI_A1_VECTOR
-__interrupt void usciA1Isr(void)
-{
-	unsigned int dummy = 0xFF;
-	// Transmit Interrupt Flag Set
-	if(UCA1IFG & UCTXIFG){
-#ifdef USE_UCA1_SPI
-		if(usciStat[UCA1_INDEX] == TX) {
-#endif
-		if(uca1TxSize > 0){
-			UCA1TXBUF = *(++uca1TxPtr);		// Transmit the next outgoing byte
-			uca1TxSize--;
-		}
-		else{
-			UCA1IFG &= ~UCTXIFG;			// Clear TX interrupt flag from vector on end of TX
-			usciStat[UCA1_INDEX] = OPEN; 		// Set status open if done with transmit
-		}
-#ifdef USE_UCA1_SPI
-		}
-#endif
-	}
-
-	// Receive Interrupt Flag Set
-	if(UCA1IFG & UCRXIFG){
-#ifdef USE_UCA1_SPI
-		if(usciStat[UCA1_INDEX] == RX){			// Check we are in RX mode for SPI
-#endif // USE_UCA1_SPI
-		if(UCA1STAT & UCRXERR) dummy = UCA1RXBUF;	// RX ERROR: Do a dummy read to clear interrupt flag
-		else {						// Otherwise write the value to the RX pointer
-			*(uca1RxPtr++) = UCA1RXBUF;
-			uca1RxSize++;				// RX Size decrement in read function
-#ifdef USE_UCA1_SPI
-			if(uca1RxSize < spiA1RxSize) UCA1TXBUF = dummy; // Perform another dummy write
-			else
-#endif
-			usciStat[UCA1_INDEX] = OPEN;
-		}
-#ifdef USE_UCA1_SPI
-		}
-#endif
-	}
-	UCA1IFG &= ~UCRXIFG;					// Clear RX interrupt flag from vector on end of RX
-}
-#endif // USE_UCA1
+#endif // USE_USCI_DMA
 
 /****************************************************************
- * USCI B0 Variable Declarations
+ * Transmit Queue
  ***************************************************************/
-#ifdef USE_UCB0
-unsigned char *ucb0TxPtr;			///< USCI B0 TX Data Pointer
-unsigned char *ucb0RxPtr;			///< USCI B0 RX Data Pointer
-unsigned int ucb0TxSize = 0;			///< USCI B0 TX Size
-unsigned int ucb0RxSize = 0;			///< USCI B0 RX Size
-unsigned int ucb0ToRxSize = 0;			///< USCI B0 to-RX Size
+#ifdef USE_USCI_TXQUEUE
+usciTxDesc txQueue[4][USCI_TXQ_SIZE];		///< Queued transmit descriptors for [A0, A1, B0, B1]
+unsigned char txqHead[4] = {0, 0, 0, 0};	///< Index of the next descriptor to start for [A0, A1, B0, B1]
+unsigned char txqCount[4] = {0, 0, 0, 0};	///< Number of queued descriptors for [A0, A1, B0, B1]
 
-/**************************************************************
- * General Purpose USCI B0 Functions
- *************************************************************/
 /**************************************************************************//**
- * \brief	Configures USCI B0 for operation
+ * \brief	Queues a write on a busy USCI module
  *
- * Write control registers and clear system variables for the
- * USCI B0 module, which can be used as either a UART or SPI.
+ * The status check and the queue insertion are performed in one critical
+ * section, so a transfer ending meanwhile cannot leave a descriptor behind
+ * which no ISR will chain.
  *
- * NOTE: This config function is already called before any read/write function call
- * and therefore should (in almost all cases) never be called by the user.
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	*data	Pointer to data to be written
+ * \param	len	Length (in bytes) of data to be written (non-zero, checked by the caller)
+ * \param	commID	Communication ID number of application
  *
- * \param	commID	The communication ID for the registered app
+ * \retval	-1	Module busy and transmit queue full
+ * \retval	0	Module OPEN (the caller starts the write itself)
+ * \retval	2	Write queued
  ******************************************************************************/
-void confUCB0(unsigned int commID)
+static int txqPush(unsigned char index, unsigned char *data, unsigned int len, unsigned int commID)
 {
 	unsigned int status;
-	if(devConf[UCB0_INDEX] == commID) return;	// Check if device is already configured
-	enter_critical(status);				// Perform config in critical section
-	UCB0CTL1 |= UCSWRST;				// Assert USCI software reset
-	UCB0_IO_CLEAR();				// Clear I/O for configuration
-
-	// Configure key control words
-	UCB0CTLW0 = dev[commID]->usciCtlW0 | UCSWRST;
-#ifdef UCB0CTLW1	// Check for UCB0CTLW1 defined
-	UCB0CTLW1 = dev[commID]->usciCtlW1;
-#endif //UCB0CTLW1
-	UCB0BRW = dev[commID]->baudDiv;
-	ucb0RxPtr = dev[commID]->rxPtr;
-
-	// Clear buffer sizes
-	ucb0RxSize = 0;
-	ucb0TxSize = 0;
-	ucb0ToRxSize = 0;
-
-#ifdef USE_UCB0_I2C
-	UCB0I2CSA = (dev[commID]->rAddr) & ADDR_MASK;	// Set up the slave address
-	UCB0I2CIE = UCNACKIE;				// Set up slave NACK interrupt
-#endif //USE_UCB0_I2C
+	usciTxDesc *desc;
 
-	UCB0_IO_CONF(dev[commID]->rAddr & ADDR_MASK);	// Port set up
-	UCB0CTL1 &= ~UCSWRST;				// Resume operation
-	UCB0IE |= UCRXIE + UCTXIE;			// Enable Interrupts	
-
-	devConf[UCB0_INDEX] = commID;			// Store config
-	exit_critical(status);				// End critical section
-}
-/**************************************************************************//**
- * \brief	Resets USCI B0 without writing over control regs
- *
- * This function is included to soft-reset the USCI B0 module
- * management variables without clearing the current config.
- *
- * \param	commID	The comm ID of the registered app
- * \sideeffect	Sets the RX pointer to that registered w/ commID
- ******************************************************************************/
-void resetUCB0(unsigned int commID){
-	ucb0RxPtr = dev[commID]->rxPtr;
-	ucb0RxSize = 0;
-	ucb0TxSize = 0;
-	ucb0ToRxSize = 0;
-	usciStat[UCB0_INDEX] = OPEN;
-	return;
-}
-/**************************************************************************//**
- * \brief	Get method for USCI B0 RX buffer size
- *
- * Returns the number of bytes which have been written
- * to the RX pointer (since the last read performed).
- *
- * \return	The number of valid bytes following the rxPtr.
- ******************************************************************************/
-unsigned int getUCB0RxSize(void){
-	return ucb0RxSize;
-}
-/**************************************************************************//**
- * \brief	Get method for USCI B0 status
- *
- * Returns the status of the USCI module, either OPEN, TX, or RX
- *
- * \retval	0	Indicates the OPEN status
- * \retval 	1	Indicates the TX Status
- * \retval 	2	Indicates the RX Status
+	enter_critical(status);
+	if(usciStat[index] == OPEN){			// Module available: no need to queue
+		exit_critical(status);
+		return 0;
+	}
+	if(txqCount[index] >= USCI_TXQ_SIZE){		// Queue full
+		exit_critical(status);
+		return USCI_BUSY(index, commID);
+	}
+	desc = &txQueue[index][(txqHead[index] + txqCount[index]) % USCI_TXQ_SIZE];
+	desc->data = data;
+	desc->len = len;
+	desc->commID = commID;
+#ifdef USE_USCI_PRIORITY
+	desc->age = 0;
+#endif // USE_USCI_PRIORITY
+	txqCount[index]++;
+	exit_critical(status);
+	return USCI_QUEUED;
+}
+#ifdef USE_USCI_PRIORITY
+/**************************************************************************//**
+ * \brief	Removes the queued descriptor of a USCI module to start next
+ *
+ * Picks the highest priority + age * USCI_TXQ_AGE_STEP (the oldest on a tie)
+ * and ages the ones passed over, so a write waits at most for
+ * 255 / USCI_TXQ_AGE_STEP + USCI_TXQ_SIZE other queued writes whatever the
+ * priorities. Only called from the module ISR (or the DMA ISR) on the end
+ * of a transfer.
+ *
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	*desc	Destination for the descriptor
+ *
+ * \retval	0	Queue empty
+ * \retval	1	Descriptor removed
  ******************************************************************************/
-unsigned char getUCB0Stat(void){
-	return usciStat[UCB0_INDEX];
-}
-
-/*************************************************************************//**
- * \brief	Set method for USCI B0 Baud Rate Divisor
- *
- * Sets the baud rate divisor of the USCI module, this divisor is generally
- * performed relative to the SMCLK rate of the system.
- *
- * \param 	baudDiv	The new divisor to apply
- * \param	commID	The communications ID number of the application
- *****************************************************************************/
-void setUCB0Baud(unsigned int baudDiv, unsigned int commID){
-	dev[commID]->baudDiv = baudDiv;		// Replace the baud divisor in memory
-	devConf[UCB0_INDEX] = 0;		// Reset the device config storage (config will be performed on next read/write)
-	return;
-}
-
-/***********************************************************
- * UCB0 SPI HANDLERS
- ***********************************************************/
-#ifdef USE_UCB0_SPI
-/**************************************************************************//**
- * \brief	Transmit method for USCI B0 SPI operation
- *
- * This method initializes a transmission of len bytes from the base of the
- * *data pointer. The transmission uses the USCI B0 TX ISR, so 2 sequential calls 
- * may result in partial transmission.
- *
- * \param	*data	Pointer to data to be written
- * \param	len		Length (in bytes) of data to be written
- * \param 	commID	Communication ID number of application
- *
- * \retval	-1		USCI B0 Module busy
- * \retval	1		Transmit successfully started
- *******************************************************************************/
-int spiB0Write(unsigned char *data, unsigned int len, unsigned int commID)
+static int txqPop(unsigned char index, usciTxDesc *desc)
 {
-	if(usciStat[UCB0_INDEX] != OPEN) return -1;	// Check that the USCI is available
-
-	confUCB0(commID);
-	
-	// Copy over pointer and length
-	ucb0TxPtr = data;
-	ucb0TxSize = len-1;
-	// Start of TX
-	usciStat[UCB0_INDEX] = TX;
-	UCB0TXBUF = *ucb0TxPtr;
+	usciTxDesc *q = txQueue[index];
+	unsigned char head = txqHead[index];
+	unsigned char n = txqCount[index];
+	unsigned char i, best = 0;
+	unsigned int score, top = 0;
+
+	if(!n) return 0;
+	for(i = 0; i < n; i++){				// Oldest first: ties keep the FIFO order
+		usciTxDesc *d = &q[(head + i) % USCI_TXQ_SIZE];
+
+		score = USCI_DEV(d->commID)->priority + (unsigned int)d->age * USCI_TXQ_AGE_STEP;
+		if(!i || score > top){
+			top = score;
+			best = i;
+		}
+	}
+	*desc = q[(head + best) % USCI_TXQ_SIZE];
+	for(i = best; i > 0; i--){			// Close the gap (older ones move up one slot)
+		q[(head + i) % USCI_TXQ_SIZE] = q[(head + i - 1) % USCI_TXQ_SIZE];
+	}
+	txqHead[index] = (head + 1) % USCI_TXQ_SIZE;
+	txqCount[index] = --n;
+	for(i = 0; i < n; i++){				// Age the writes passed over
+		usciTxDesc *d = &q[(txqHead[index] + i) % USCI_TXQ_SIZE];
 
+		if(d->age < 0xFF) d->age++;
+	}
 	return 1;
 }
+#else
 /**************************************************************************//**
- * \brief	Receive method for USCI B0 SPI operation
+ * \brief	Removes the next queued descriptor of a USCI module
  *
- * This method performs a synchronous read by storing the bytes to be read in
- * ucbB0ToRxSize and then performing len dummy write to the bus to fetch the data
- * from a slave device. The RX size is cleared on this function call.
+ * Only called from the module ISR (or the DMA ISR) on the end of a transfer.
  *
- * \param	len	The number of bytes to be read from the bus
- * \param	commID	Communication ID number of the application
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	*desc	Destination for the descriptor
  *
- * \retval	-1	USCI B0 Module Busy
- * \retval	1	Receive successfully started
- *
- * \sideeffect	Reset the UCB0 RX size and data pointer
+ * \retval	0	Queue empty
+ * \retval	1	Descriptor removed
  ******************************************************************************/
-int spiB0Read(unsigned int len, unsigned int commID)
-{
-	if(usciStat[UCB0_INDEX] != OPEN) return -1;	// Check that the USCI is available
-
-	confUCB0(commID);
-
-	// Clear RX Size and copy length
-	ucb0RxSize = 0;					// Reset the rx size
-	ucb0RxPtr = dev[commID]->rxPtr;			// Reset the rx pointer
-	ucb0ToRxSize = len;
-	// Start of RX
-	usciStat[UCB0_INDEX] = RX;
-	UCB0TXBUF = 0xFF;				// Start TX
-	
-	return 1;
-}
-
-/**************************************************************************//**
- * \brief	Byte Swap method for USCI B0 SPI operation
- *
- * This blocking method allows the user to transmit a byte and receive the
- * response simultaneously clocked back in. TX and RX buffer sizes/content
- * are unaffected.
- *
- * \param	byte	The byte to be sent via SPI
- * \param 	commID	Communication ID number of the application
- *
- * \return	The byte shifted in from the SPI
- *************************************************************************/
-unsigned char spiB0Swap(unsigned char byte, unsigned int commID)
+static int txqPop(unsigned char index, usciTxDesc *desc)
 {
-	if(usciStat[UCB0_INDEX] != OPEN) return -1;	// Check that the USCI is available
-	
-	confUCB0(commID);
-	
-	usciStat[UCB0_INDEX] = SWAP;			// Set status to swap (block other operation)
-	UCB0TXBUF = byte;
-	while(UCB0STAT & UCBUSY);			// Wait for TX complete
-	usciStat[UCB0_INDEX] = OPEN;			// Set status to open (swap complete)
-	return UCB0RXBUF;				// Return RX contents
-}
-#endif //USE_UCB0_SPI
-/***********************************************************
- * UCB0 I2C HANDLERS
- * \todo: NOT YET TESTED!!!!!!!!!
- ***********************************************************/
-#ifdef USE_UCB0_I2C
-/**************************************************************************//**
- * \brief	Transmit method for USCI B0 I2C operation
- *
- * This method initializes a transmission of len bytes from the base of the
- * *data pointer. Similarly to spiB0Write(), the transmission uses the USCI B0
- * TX ISR to complete, so 2 sequential calls may result in partial transmission.
- *
- * \param	*data	Pointer to data to be written
- * \param	len	Length (in bytes) of data to be written
- * \param 	commID	Communication ID number of application
- *
- * \retval	-1	USCI B0 Module busy
- * \retval	1	Transmit successfully started
- *******************************************************************************/
-int i2cB0Write(unsigned char *data, unsigned int len, unsigned int commID)
-{
-	if(usciStat[UCB0_INDEX] != OPEN) return -1; 	// Check that the USCI is available
-
-	confUCB0(commID);
-
-	ucb0TxPtr = data;
-	ucb0TxSize = len;
-	// Start of TX
-	usciStat[UCB0_INDEX] = TX;
-	UCB0CTL1 |= UCTR + UCTXSTT;	// Generate start condition
-
+	if(!txqCount[index]) return 0;
+	*desc = txQueue[index][txqHead[index]];
+	txqHead[index] = (txqHead[index] + 1) % USCI_TXQ_SIZE;
+	txqCount[index]--;
 	return 1;
 }
+#endif // USE_USCI_PRIORITY
 /**************************************************************************//**
- * \brief	Receive method for USCI B0 I2C operation
+ * \brief	Checks for queued writes of an app on a USCI module
  *
- * This method performs a synchronous read by storing the bytes to be read in
- * ucbB0ToRxSize and then performing len dummy write to the bus to fetch the data
- * from a slave device. The RX size is cleared on this function call.
- *
- * \param	len	The number of bytes to be read from the bus
- * \param	commID	Communication ID number of the application
- *
- * \retval	-1	USCI B0 Module Busy
- * \retval	1	Receive successfully started
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
+ * \param	commID	Communication ID number of application
  *
- * \sideeffect	Reset the UCB0 RX size and data pointer
+ * \retval	0	No write of the app queued
+ * \retval	1	The app has writes queued
  ******************************************************************************/
-int i2cB0Read(unsigned int len, unsigned int commID)
+static int txqHolds(unsigned char index, unsigned int commID)
 {
-	if(usciStat[UCB0_INDEX] != OPEN) return -1;	// Check that the USCI is available
-
-	confUCB0(commID);
+	unsigned char i;
 
-	ucb0RxSize = 0;
-	ucb0ToRxSize = len;
-	// Start of RX
-	usciStat[UCB0_INDEX] = RX;
-	UCB0CTL1 |= UCTXSTT;		// Generate start condition
-
-	return 1;
+	for(i = 0; i < txqCount[index]; i++){
+		if(txQueue[index][(txqHead[index] + i) % USCI_TXQ_SIZE].commID == commID) return 1;
+	}
+	return 0;
 }
+#endif // USE_USCI_TXQUEUE
+
+/****************************************************************
+ * Scatter-Gather Helpers
+ ***************************************************************/
+#ifdef USE_USCI_IOVEC
 /**************************************************************************//**
- * \brief	Ping (slave present) Method for USCI B0 I2C Operation
- *
- * This method tests for the presence of a slave at the address affiliated with
- * the registered commID. This is accomplished by sending a start, then stop
- * condition sequenitally on the bus, then reading the UCB0STAT register for
- * a NACK condition.
- *
- * \param	commID	Communication ID number of the application
- *
- * \retval	-1	USCI B0 Module Busy
- * \retval	0	Slave not present
- * \retval	1	Slave present
+ * \brief	Totals the length of a segment list
  *
- * \sideeffect	The USCI module will need to be reconfigured for the next
- * 		operation (even if it uses the same slave address or commID)
+ * \param	*seg	Array of segments
+ * \param	count	Number of segments in the array
+ * \return	The sum of the segment lengths, 0 for an empty list or if any
+ * 		segment is empty (or the sum overflows)
  ******************************************************************************/
-unsigned char i2cB0SlavePresent(unsigned int commID)
+static unsigned int segTotal(const usciSegment *seg, unsigned char count)
 {
-	unsigned char retval;
+	unsigned int total = 0;
 
-	if(usciStat[UCB0_INDEX] != OPEN) return -1;	// Check that USCI is available
-
-	UCB0IE &= ~(UCTXIE + UXRXIE + UCNACKIE);	// Clear NACK, RX, and TX interrupt conditions
-	UCB0I2CSA = dev[commID]->raddr & ADDR_MASK;	// Set slave address
-
-	__disable_interrupt();
-	UCB0CTL1 |= UCTR + UCTXSTT + UCTXSTP;		// TX w/ start and stop condition
-	while(UCB0CTL1 & UCTXSTP);			// Wait for stop condition
-	
-	retval = !(UCB0STAT & UCNACKIFG);
-	devConf[UCB0_INDEX] = 0;			// Clear dev conf slot for UCB1
-	__enable_interrupt();
-
-	return retval;
-}
-#endif //USE_UCB0_I2C
-/**********************************************************************//**
- * \brief	USCI B0 RX/TX Interrupt Service Routine
- *
- * This ISR manages all TX/RX proceedures with the exception of transfer
- * initialization. Once a transfer (read or write) is underway, this method
- * assures the correct amount of bytes are written to the correct location.
- *************************************************************************/
-#pragma vector=USCI_B0_VECTOR
-__interrupt void usciB0Isr(void)
-{
-	unsigned int dummy = 0xFF;
-	// Transmit Interrupt Flag Set
-	if(UCB0IFG & UCTXIFG){
-		if(usciStat[UCB0_INDEX] == TX) {
-			if(ucb0TxSize > 0){
-				UCB0TXBUF = *(++ucb0TxPtr);	// Transmit the next outgoing byte
-				ucb0TxSize--;
-			}
-			else{
-				usciStat[UCB0_INDEX] = OPEN; 	// Set status open if done with transmit
-				UCB0IFG &= ~UCTXIFG;		// Clear TX interrupt flag from vector on end of TX
-			}
-		}
-		else UCB0IFG &= ~UCTXIFG; // Clear the TX interrupt flag from vector on end of TX
-	}
-
-	// Receive Interrupt Flag Set
-	if(UCB0IFG & UCRXIFG){	// Check for interrupt flag and RX mode
-		if(usciStat[UCB0_INDEX] == RX){				// Check we are in RX mode for SPI
-			if(UCB0STAT & UCRXERR) dummy = UCB0RXBUF;	// RX ERROR: Do a dummy read to clear interrupt flag
-			else {	// Otherwise write the value to the RX pointer
-				*(ucb0RxPtr++) = UCB0RXBUF;
-				ucb0RxSize++;	// RX Size decrement in read function
-				if(ucb0RxSize < ucb0ToRxSize) UCB0TXBUF = dummy; // Perform another dummy write
-				else usciStat[UCB0_INDEX] = OPEN;
-			}
-		}
-		else UCB0IFG &= ~UCRXIFG; // Clear RX interrupt flag from vector on end of RX
+	if(!seg) return 0;
+	while(count--){
+		if(!seg->len || total + seg->len < total) return 0;
+		total += (seg++)->len;
 	}
+	return total;
 }
-#endif // USE_UCB0
+#endif // USE_USCI_IOVEC
 
 /****************************************************************
- * USCI B1 Variable Declarations
+ * USCI Module Instantiations (see comm_usci.h)
  ***************************************************************/
-#ifdef USE_UCB1
-unsigned char *ucb1TxPtr;			///< USCI B1 TX Data Pointer
-unsigned char *ucb1RxPtr;			///< USCI B1 RX Data Pointer
-unsigned int ucb1TxSize = 0;			///< USCI B1 TX Size
-unsigned int ucb1RxSize = 0;			///< USCI B1 RX Size
-unsigned int ucb1ToRxSize = 0;			///< USCI B1 to-RX Size
-
-/**************************************************************
- * General Purpose USCI B1 Functions
- *************************************************************/
-/**************************************************************************//**
- * \brief	Configures USCI B1 for operation
- *
- * Write control registers and clear system variables for the
- * USCI B0 module, which can be used as either a UART or SPI.
- *
- * NOTE: This config function is already called before any read/write function call
- * and therefore should (in almost all cases) never be called by the user.
- *
- * \param	commID	The communication ID for the registered app
- ******************************************************************************/
-void confUCB1(unsigned int commID)
-{
-	unsigned int status;
-	if(devConf[UCB1_INDEX] == commID) return;	// Check if device is already configured
-	enter_critical(status);				// Perform config in critical section
-	UCB1CTL1 |= UCSWRST;				// Assert USCI software reset
-	UCB1_IO_CLEAR();				// Clear I/O for configuration
-
-	// Configure key control words
-	UCB1CTLW0 = dev[commID]->usciCtlW0 | UCSWRST;
-#ifdef UCB1CTLW1	// Check for UCB1CTLW1 defined
-	UCB1CTLW1 = dev[commID]->usciCtlW1;
-#endif //UCB1CTLW1
-	UCB1BRW = dev[commID]->baudDiv;
-	ucb1RxPtr = dev[commID]->rxPtr;
+#ifdef USE_UCA0
+#define USCI_X		A0
+#define USCI_x		a0
+#ifdef USE_UCA0_SPI
+#define USCI_SPI
+#else
+#define USCI_UART
+#endif // USE_UCA0_SPI
+#include "comm_usci.h"
+#endif // USE_UCA0
 
-	// Clear buffer sizes
-	ucb1RxSize = 0;
-	ucb1TxSize = 0;
-	ucb1ToRxSize = 0;
+#ifdef USE_UCA1
+#define USCI_X		A1
+#define USCI_x		a1
+#ifdef USE_UCA1_SPI
+#define USCI_SPI
+#else
+#define USCI_UART
+#endif // USE_UCA1_SPI
+#include "comm_usci.h"
+#endif // USE_UCA1
 
-#ifdef USE_UCB1_I2C
-	UCB1I2CSA = (dev[commID]->rAddr) & ADDR_MASK;	// Set up the slave address
-	UCB1IE |= UCNACKIE;				// Set up slave NACK interrupt
-#endif //USE_UCB1_I2C
+#ifdef USE_UCB0
+#define USCI_X		B0
+#define USCI_x		b0
+#ifdef USE_UCB0_SPI
+#define USCI_SPI
+#else
+#define USCI_I2C
+#endif // USE_UCB0_SPI
+#include "comm_usci.h"
+#endif // USE_UCB0
 
-	UCB1_IO_CONF(dev[commID]->rAddr & ADDR_MASK);	// Port set up
-	UCB1CTL1 &= ~UCSWRST;				// Resume operation
-	UCB1IE |= UCRXIE + UCTXIE;			// Enable Interrupts	
+#ifdef USE_UCB1
+#define USCI_X		B1
+#define USCI_x		b1
+#ifdef USE_UCB1_SPI
+#define USCI_SPI
+#else
+#define USCI_I2C
+#endif // USE_UCB1_SPI
+#include "comm_usci.h"
+#endif // USE_UCB1
 
-	devConf[UCB1_INDEX] = commID;			// Store config
-	exit_critical(status);				// End critical section
-}
-/**************************************************************************//**
- * \brief	Resets USCI B1 without writing over control regs
- *
- * This function is included to soft-reset the USCI B1 module
- * management variables without clearing the current config.
- *
- * \param	commID	The comm ID of the registered app
- * \sideeffect	Sets the RX pointer to that registered w/ commID
- ******************************************************************************/
-void resetUCB1(unsigned int commID){
-	ucb1RxPtr = dev[commID]->rxPtr;
-	ucb1RxSize = 0;
-	ucb1TxSize = 0;
-	ucb1ToRxSize = 0;
-	usciStat[UCB1_INDEX] = OPEN;
-	return;
-}
-/**************************************************************************//**
- * \brief	Get method for USCI B1 RX buffer size
- *
- * Returns the number of bytes which have been written
- * to the RX pointer (since the last read performed).
- *
- * \return			The number of valid bytes following the rxPtr.
- ******************************************************************************/
-unsigned int getUCB1RxSize(void){
-	return ucb1RxSize;
-}
+/****************************************************************
+ * App Unregistration
+ ***************************************************************/
 /**************************************************************************//**
- * \brief	Get method for USCI B1 status
+ * \brief	Stops a USCI module configured for an app being unregistered
  *
- * Returns the status of the USCI module, either OPEN, TX, or RX
- *
- * \retval	0	Indicates the OPEN status
- * \retval 	1	Indicates the TX Status
- * \retval 	2	Indicates the RX Status
+ * \param	index	The USCI index of the module (UCA0_INDEX..UCB1_INDEX)
  ******************************************************************************/
-unsigned char getUCB1Stat(void){
-	return usciStat[UCB1_INDEX];
-}
-
-/*************************************************************************//**
- * \brief	Set method for USCI B1 Baud Rate Divisor
- *
- * Sets the baud rate divisor of the USCI module, this divisor is generally
- * performed relative to the SMCLK rate of the system.
- *
- * \param 	baudDiv	The new divisor to apply
- * \param	commID	The communications ID number of the application
- *****************************************************************************/
-void setUCB1Baud(unsigned int baudDiv, unsigned int commID){
-	dev[commID]->baudDiv = baudDiv;		// Replace the baud divisor in memory
-	devConf[UCB1_INDEX] = 0;		// Reset the device config storage (config will be performed on next read/write)
-	return;
-}
-
-/***********************************************************
- * UCB0 SPI HANDLERS
- ***********************************************************/
-#ifdef USE_UCB1_SPI
-/**************************************************************************//**
- * \brief	Transmit method for USCI B1 SPI operation
- *
- * This method initializes a transmission of len bytes from the base of the
- * *data pointer. Similarly to uartB0Write(), the transmission uses the USCI B1
- * TX ISR to complete, so 2 sequential calls may result in partial transmission.
- *
- * \param	*data	Pointer to data to be written
- * \param	len		Length (in bytes) of data to be written
- * \param 	commID	Communication ID number of application
- *
- * \retval	-1		USCI B1 Module busy
- * \retval	1		Transmit successfully started
- *******************************************************************************/
-int spiB1Write(unsigned char *data, unsigned int len, unsigned int commID)
+static void usciRelease(unsigned char index)
 {
-	if(usciStat[UCB1_INDEX] != OPEN) return -1;	// Check that the USCI is available
-
-	confUCB1(commID);
-	
-	// Copy over pointer and length
-	ucb1TxPtr = data;
-	ucb1TxSize = len-1;
-	// Start of TX
-	usciStat[UCB1_INDEX] = TX;
-	UCB1TXBUF = *ucb0TxPtr;
-
-	return 1;
+	switch(index){
+#ifdef USE_UCA0
+	case UCA0_INDEX:
+		uca0Release();
+		break;
+#endif // USE_UCA0
+#ifdef USE_UCA1
+	case UCA1_INDEX:
+		uca1Release();
+		break;
+#endif // USE_UCA1
+#ifdef USE_UCB0
+	case UCB0_INDEX:
+		ucb0Release();
+		break;
+#endif // USE_UCB0
+#ifdef USE_UCB1
+	case UCB1_INDEX:
+		ucb1Release();
+		break;
+#endif // USE_UCB1
+	default:
+		break;
+	}
 }
 /**************************************************************************//**
- * \brief	Receive method for USCI B1 SPI operation
- *
- * This method performs a synchronous read by storing the bytes to be read in
- * ucb1ToRxSize and then performing len dummy write to the bus to fetch the data
- * from a slave device. The RX size is cleared on this function call.
+ * \brief Unregisters an application, freeing its registry slot.
  *
- * \param	len		The number of bytes to be read from the bus
- * \param	commID	Communication ID number of the application
+ * The comm ID is refused by every call from then on and the slot is given
+ * to the next registerComm() under a new comm ID. If the app is the one
+ * configured on its USCI module, the module is held in reset (interrupts
+ * and pins released) until the next app is configured, so nothing is
+ * written to the app buffers anymore.
  *
- * \retval	-1		USCI B1 Module Busy
- * \retval	1		Receive successfully started
- * \sideeffect		Reset the UCB0 RX size and data pointer
+ * \param	commID	The comm ID of the registered app
+ * \retval	1	App unregistered
+ * \retval	-1	A transfer of the app is running or queued (retry once done)
+ * \retval	-3	Unknown or already unregistered comm ID
  ******************************************************************************/
-int spiB1Read(unsigned int len, unsigned int commID)
+int unregisterComm(unsigned int commID)
 {
-	if(usciStat[UCB1_INDEX] != OPEN) return -1;	// Check that the USCI is available
-
-	confUCB1(commID);
+	unsigned int status;
+	unsigned char slot = USCI_SLOT(commID);
+	unsigned char index;
 
-	// Clear RX Size and copy length
-	ucb1RxPtr = dev[commID]->rxPtr;			// Reset the rx pointer
-	ucb1RxSize = 0;					// Reset the rx size
-	ucb1ToRxSize = len;
-	// Start of RX
-	usciStat[UCB1_INDEX] = RX;
-	UCB1TXBUF = 0xFF;				// Start TX
-	
-	return 1;
+	enter_critical(status);
+	if(!USCI_ID_OK(commID)){
+		exit_critical(status);
+		return USCI_ID_ERROR;
+	}
+	index = dev[slot]->rAddr >> 14;		// USCI_MASK bits: the module index
+#ifdef USE_USCI_TXQUEUE
+	if(txqHolds(index, commID)){
+		exit_critical(status);
+		return USCI_BUSY_ERROR;
+	}
+#endif // USE_USCI_TXQUEUE
+	if(devConf[index] == commID){
+		if(usciStat[index] != OPEN){
+			exit_critical(status);
+			return USCI_BUSY_ERROR;
+		}
+		usciRelease(index);
+	}
+	dev[slot] = 0;
+	devId[slot] = ((devId[slot] + (1 << USCI_SLOT_BITS)) & USCI_GEN_MASK) | USCI_ID_FREE;	// Stale from now on
+	exit_critical(status);
+	return USCI_SUCCESS;
 }
 
-/**************************************************************************//**
- * \brief	Byte Swap method for USCI B1 SPI operation
- *
- * This blocking method allows the user to transmit a byte and receive the
- * response simultaneously clocked back in. TX and RX buffer sizes/content
- * are unaffected.
- *
- * \param	byte	The byte to be sent via SPI
- * \param 	commID	Communication ID number of the application
+/****************************************************************
+ * DMA Transfer Engine Completion
+ ***************************************************************/
+#ifdef USE_USCI_DMA
+/**********************************************************************//**
+ * \brief	DMA Interrupt Service Routine
  *
- * \return	The byte shifted in from the SPI
+ * Called once per DMA driven transfer (on the last channel to finish). Returns
+ * the owning USCI module to interrupt driven operation, updating the buffer
+ * sizes as the module ISR would have on the end of its transfer. A transmit
+ * only transfer completes with its last byte still waiting in TXBUF, so the
+ * module TX interrupt ends it (as on an interrupt driven write).
  *************************************************************************/
-unsigned char spiB1Swap(unsigned char byte, unsigned int commID)
+#pragma vector=DMA_VECTOR
+__interrupt void usciDmaIsr(void)
 {
-	if(usciStat[UCB1_INDEX] != OPEN) return -1;	// Check that the USCI is available
-	
-	confUCB1(commID);
-	
-	usciStat[UCB1_INDEX] = SWAP;			// Set status to swap (block other operation)
-	UCB1TXBUF = byte;
-	while(UCB1STAT & UCBUSY);			// Wait for TX complete
-	usciStat[UCB1_INDEX] = OPEN;			// Set status to open (swap complete)
-	return UCB1RXBUF;				// Return RX contents
-}
-#endif //USE_UCB1_SPI
-/***********************************************************
- * UCB1 I2C HANDLERS
- ***********************************************************/
-#ifdef USE_UCB1_I2C
-/**************************************************************************//**
- * \brief	Transmit method for USCI B1 I2C operation
- *
- * This method initializes a transmission of len bytes from the base of the
- * *data pointer. Similarly to spiB1Write(), the transmission uses the USCI B1
- * TX ISR to complete, so 2 sequential calls may result in partial transmission.
- *
- * \param	*data	Pointer to data to be written
- * \param	len	Length (in bytes) of data to be written
- * \param 	commID	Communication ID number of application
- *
- * \retval	-1	USCI B1 Module busy
- * \retval	1	Transmit successfully started
- *******************************************************************************/
-int i2cB1Write(unsigned char *data, unsigned int len, unsigned int commID)
-{
-	if(usciStat[UCB1_INDEX] != OPEN) return -1;
-
-	confUCB1(commID);
-
-	ucb1TxPtr = data;
-	ucb1RxSize = len;
-	// Start of TX
-	usciStat[UCB1_INDEX] = TX;
-	UCB1CTL1 |= UCTR + UCTXSTT;	// Generate start condition
+	unsigned char owner;
+
+	switch(__even_in_range(DMAIV, 16)){
+	case DMAIV_DMA0IFG:		// Transmit only transfer: last byte loaded to TXBUF
+	case DMAIV_DMA1IFG:		// Receive transfer complete
+		break;
+	default:
+		return;
+	}
 
-	return 1;
+	owner = dmaOwner;
+	switch(owner){
+#ifdef USE_UCA0
+	case UCA0_INDEX:
+		uca0DmaDone();
+		break;
+#endif // USE_UCA0
+#ifdef USE_UCA1
+	case UCA1_INDEX:
+		uca1DmaDone();
+		break;
+#endif // USE_UCA1
+#ifdef USE_UCB0
+	case UCB0_INDEX:
+		ucb0DmaDone();
+		break;
+#endif // USE_UCB0
+#ifdef USE_UCB1
+	case UCB1_INDEX:
+		ucb1DmaDone();
+		break;
+#endif // USE_UCB1
+	default:
+		dmaStop();
+		return;
+	}
+	USCI_WAKE(owner);
 }
-/**************************************************************************//**
- * \brief	Receive method for USCI B1 I2C operation
- *
- * This method performs a synchronous read by storing the bytes to be read in
- * ucbB1ToRxSize and then performing len dummy write to the bus to fetch the data
- * from a slave device. The RX size is cleared on this function call.
- *
- * \param	len	The number of bytes to be read from the bus
- * \param	commID	Communication ID number of the application
- *
- * \retval	-1	USCI B1 Module Busy
- * \retval	1	Receive successfully started
- *
- * \sideeffect	Reset the UCB1 RX size and data pointer
- ******************************************************************************/
-int i2cB1Read(unsigned int len, unsigned int commID)
-{
-	if(usciStat[UCB1_INDEX] != OPEN) return -1;
-
-	confUCB1(commID);
-
-	ucb1RxSize = 0;
-	ucb1ToRxSize = len;
-	// Start of RX
-	usciStat[UCB1_INDEX] = RX;
-	UCB1CTL1 |= UCTXSTT;		// Generate start condition
+#endif // USE_USCI_DMA
 
-	return 1;
-}
-/**************************************************************************//**
- * \brief	Ping (slave present) Method for USCI B1 I2C Operation
- *
- * This method tests for the presence of a slave at the address affiliated with
- * the registered commID. This is accomplished by sending a start, then stop
- * condition sequenitally on the bus, then reading the UCB1STAT register for
- * a NACK condition.
- *
- * \param	commID	Communication ID number of the application
- *
- * \retval	-1	USCI B1 Module Busy
- * \retval	0	Slave not present
- * \retval	1	Slave present
+/****************************************************************
+ * UART Idle-Line Timeout Completion
+ ***************************************************************/
+#ifdef USE_UART_IDLE
+/**********************************************************************//**
+ * \brief	UART Idle-Line Timer Interrupt Service Routine
  *
- * \sideeffect	The USCI module will need to be reconfigured for the next
- * 		operation (even if it uses the same slave address or commID)
- ******************************************************************************/
-unsigned char i2cB1SlavePresent(unsigned int commID)
+ * The compare channel of a UART module fires once its line has been quiet
+ * for the idle timeout of the app since the last byte received (the UART ISR
+ * moves the compare forward on every byte), ending the message.
+ *************************************************************************/
+#pragma vector=USCI_IDLE_VECTOR
+__interrupt void usciIdleIsr(void)
 {
-	unsigned char retval;
-
-	if(usciStat[UCB1_INDEX] != OPEN) return -1;	// Check that USCI is available
-
-	UCB1IE &= ~(UCTXIE + UXRXIE + UCNACKIE);	// Clear NACK, RX, and TX interrupt conditions
-	UCB1I2CSA = dev[commID]->rAddr & ADDR_MASK;	// Set slave address
-
-	__disable_interrupt();
-	UCB1CTL1 |= UCTR + UCTXSTT + UCTXSTP;		// TX w/ start and stop condition
-	while(UCB1CTL1 & UCTXSTP);			// Wait for stop condition
-	
-	retval = !(UCB1STAT & UCNACKIFG);
-	devConf[UCB1_INDEX] = 0;			// Clear dev conf slot for UCB1
-	__enable_interrupt();
-
-	return retval;
+	switch(__even_in_range(USCI_IDLE_IV, 14)){
+#ifdef USE_UCA0_UART
+	case UCA0_IDLE_IV:
+		uca0IdleDone();
+		break;
+#endif // USE_UCA0_UART
+#ifdef USE_UCA1_UART
+	case UCA1_IDLE_IV:
+		uca1IdleDone();
+		break;
+#endif // USE_UCA1_UART
+	default:
+		break;
+	}
 }
-#endif //USE_UCB1_I2C
+#endif // USE_UART_IDLE
+
+/****************************************************************
+ * UART RTS/CTS Flow Control
+ ***************************************************************/
+#ifdef USE_UART_FLOW
 /**********************************************************************//**
- * \brief	USCI B1 RX/TX Interrupt Service Routine
+ * \brief	UART CTS Interrupt Service Routine
  *
- * This ISR manages all TX/RX proceedures with the exception of transfer
- * initialization. Once a transfer (read or write) is underway, this method
- * assures the correct amount of bytes are written to the correct location.
+ * The CTS line of a UART module paused by its peer went low (ready), the
+ * write resumes from the byte held back.
  *************************************************************************/
-#pragma vector=USCI_B1_VECTOR
-__interrupt void usciB1Isr(void)
+#pragma vector=USCI_CTS_VECTOR
+__interrupt void usciCtsIsr(void)
 {
-	unsigned int dummy = 0xFF;
-	// Transmit Interrupt Flag Set
-	if(UCB1IFG & UCTXIFG){
-		if(usciStat[UCB1_INDEX] == TX) {
-			if(ucb1TxSize > 0){
-				UCB1TXBUF = *(++ucb1TxPtr);	// Transmit the next outgoing byte
-				ucb1TxSize--;
-			}
-			else{
-				usciStat[UCB1_INDEX] = OPEN; 	// Set status open if done with transmit
-				UCB1IFG &= ~UCTXIFG;		// Clear TX interrupt flag from vector on end of TX
-			}
-		}
-		else UCB1IFG &= ~UCTXIFG;	// Clear TX interrupt flag from vector on end of TX
-	}
-
-	// Receive Interrupt Flag Set
-	if(UCB1IFG & UCRXIFG){	// Check for interrupt flag and RX mode
-		if(usciStat[UCB1_INDEX] == RX)	{			// Check we are in RX mode for SPI
-			if(UCB1STAT & UCRXERR) dummy = UCB1RXBUF;	// RX ERROR: Do a dummy read to clear interrupt flag
-			else {	// Otherwise write the value to the RX pointer
-			*(ucb1RxPtr++) = UCB1RXBUF;
-			ucb1RxSize++;	// RX Size decrement in read function
-			if(ucb1RxSize < ucb1ToRxSize) UCB1TXBUF = dummy;	// Perform another dummy write
-			else
-			usciStat[UCB1_INDEX] = OPEN;
-			}
-		}
-		else UCB1IFG &= ~UCRXIFG;	// Clear RX interrupt flag from vector on end of RX
-	}
-
+#ifdef USE_UCA0_UART
+	if(USCI_FLOW_IFG & USCI_FLOW_IE & UCA0_CTS_PIN) uca0CtsResume();
+#endif // USE_UCA0_UART
+#ifdef USE_UCA1_UART
+	if(USCI_FLOW_IFG & USCI_FLOW_IE & UCA1_CTS_PIN) uca1CtsResume();
+#endif // USE_UCA1_UART
 }
-#endif // USE_UCB1
+#endif // USE_UART_FLOW
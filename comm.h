@@ -8,6 +8,7 @@
 #define SMCLK_FREQ	8000000
 
 #define MAX_DEVS	8		///< Maximum number of devices to be registered
+#define USCI_SLOT_BITS	4		///< Comm ID bits holding the registry slot (1..MAX_DEVS), the upper bits count the reuses of the slot
 
 // USCI Library Conditional Compilation Macros
 // NOTE: Only define at most 1 config for each USCI module, otherwise a Multiple Serial Endpoint error will be created on compilation
@@ -19,6 +20,54 @@
 #define USE_UCB0_I2C			///< USCI B0 I2C Mode Conditional Compilation Flag
 #define USE_UCB1_SPI			///< USCI B1 SPI Mode Conditional Compilation Flag
 #define USE_UCB1_I2C			///< USCI B1 I2C Mode Conditional Compilation Flag
+// Optional Feature Conditional Compilation Macros
+//#define USE_USCI_DMA			///< DMA Transfer Engine Conditional Compilation Flag (uses DMA channels 0 and 1 and the DMA vector)
+//#define USE_UART_RXRING		///< UART Receive Ring Buffer Conditional Compilation Flag (A0/A1 UART receive into a ring, read copies out)
+#define UCA0_RXRING_SIZE	64		///< USCI A0 UART receive ring size in bytes (power of 2)
+#define UCA1_RXRING_SIZE	64		///< USCI A1 UART receive ring size in bytes (power of 2)
+//#define USE_USCI_TXQUEUE		///< Transmit Queue Conditional Compilation Flag (UART/SPI writes to a busy module are queued and chained by the ISR)
+#define USCI_TXQ_SIZE		4		///< Transmit queue depth (descriptors per module)
+//#define USE_USCI_PRIORITY		///< Transmit Queue Priority Conditional Compilation Flag (queued writes started by usciConfig priority with aging instead of FIFO, requires USE_USCI_TXQUEUE)
+#define USCI_TXQ_AGE_STEP	16		///< Priority gained by a queued write each time another queued write is started before it
+//#define USE_USCI_IOVEC		///< Scatter-Gather Conditional Compilation Flag (segment list UART/SPI writes and SPI reads)
+//#define USE_USCI_CALLBACKS		///< Completion Callback Conditional Compilation Flag (usciConfig onTxDone/onRxDone/onError hooks called by the ISRs)
+//#define USE_USCI_LPM			///< Low Power Wait Conditional Compilation Flag (waitUCXX()/spiXxSwap() sleep until the ISR completes the transfer)
+#define USCI_LPM_BITS		LPM0_bits	///< Low power mode entered while waiting (LPM3_bits only if the USCI clock source runs on request in LPM3)
+//#define USE_USCI_STATS		///< Statistics Counter Conditional Compilation Flag (per module and per app counters, see getModStats()/getCommStats())
+//#define USE_USCI_REGS			///< Register Access Conditional Compilation Flag (spiXxRegRead/Write(), i2cBxRegRead/Write() address + data transactions)
+//#define USE_SPI_STREAM		///< SPI Streaming Read Conditional Compilation Flag (continuous ping-pong block reads, see spiXxStream())
+//#define USE_USCI_PROF			///< ISR Profiling Conditional Compilation Flag (ISR and transfer durations per module from a free running timer, see getModProf())
+#define USCI_PROF_TIMER		TA0R		///< Free running 16 bit timer counter read by the profiling hooks
+#define USCI_PROF_TIMER_INIT()	(TA0CTL = TASSEL__SMCLK + MC__CONTINUOUS + TACLR)	///< Starts USCI_PROF_TIMER (SMCLK: one tick per CPU cycle at MCLK = SMCLK)
+#define USCI_PROF_BINS		16		///< Number of histogram bins (the last bin also counts longer durations)
+#define USCI_PROF_ISR_SHIFT	3		///< ISR histogram bin width (2^n timer ticks)
+#define USCI_PROF_XFER_SHIFT	6		///< Transfer histogram base (bin 0 counts transfers under 2^n ticks, each next bin doubles)
+//#define USE_USCI_FRAMING		///< UART Packet Framing Conditional Compilation Flag (USCI_OPT_COBS/USCI_OPT_SLIP apps, see uartAxGetFrame())
+#define USCI_FRAME_MAX		128		///< Largest decoded frame in bytes (framed apps need an rxPtr buffer of 2 * USCI_FRAME_MAX)
+//#define USE_USCI_CRC			///< Streaming CRC Conditional Compilation Flag (USCI_OPT_CRC apps, CRC-16-CCITT of the data computed by the ISRs, see getUCxxTxCrc())
+#define USCI_CRC_SEED		0xFFFF		///< CRC-16-CCITT initial value (CRC restarted on each transfer start)
+//#define USE_UART_IDLE			///< UART Idle-Line Timeout Conditional Compilation Flag (end of message after idleBits of silence, see uartAxRxIdle(), uses the compare channels below)
+#define USCI_IDLE_TIMER		TA0R		///< 16 bit timer counter timing the UART receive gaps (may be shared with USCI_PROF_TIMER)
+#define USCI_IDLE_TIMER_SHIFT	0		///< USCI_IDLE_TIMER input divider as a power of 2 (2^n SMCLK cycles per tick, for gaps over 65535 SMCLK cycles, 0 to 6, 0 if shared with USCI_PROF_TIMER)
+#define USCI_IDLE_TIMER_INIT()	do{ if(!(TA0CTL & MC_3)){ TA0EX0 = USCI_IDLE_TIMER_IDEX; TA0CTL = TASSEL__SMCLK + USCI_IDLE_TIMER_ID + MC__CONTINUOUS + TACLR; } }while(0)	///< Starts USCI_IDLE_TIMER divided by 2^USCI_IDLE_TIMER_SHIFT (dividers set by comm.c, left alone once running so running timeouts are kept)
+#define USCI_IDLE_VECTOR	TIMER0_A1_VECTOR	///< Interrupt vector of the compare channels
+#define USCI_IDLE_IV		TA0IV		///< Interrupt vector register of the compare channels
+#define UCA0_IDLE_CCR		TA0CCR1		///< USCI A0 UART idle timeout compare register
+#define UCA0_IDLE_CCTL		TA0CCTL1	///< USCI A0 UART idle timeout compare control
+#define UCA0_IDLE_IV		TA0IV_TACCR1	///< USCI A0 UART idle timeout USCI_IDLE_IV value
+#define UCA1_IDLE_CCR		TA0CCR2		///< USCI A1 UART idle timeout compare register
+#define UCA1_IDLE_CCTL		TA0CCTL2	///< USCI A1 UART idle timeout compare control
+#define UCA1_IDLE_IV		TA0IV_TACCR2	///< USCI A1 UART idle timeout USCI_IDLE_IV value
+//#define USE_UART_FLOW			///< UART RTS/CTS Flow Control Conditional Compilation Flag (USCI_OPT_RTSCTS apps, RTS/CTS pins and port vector from comm_hal_xxx.h)
+#define UART_RTS_STOP		48		///< Unread received bytes at which RTS is deasserted (below UCAx_RXRING_SIZE, leaving room for the bytes the peer sends before stopping)
+#define UART_RTS_GO		16		///< Unread received bytes at or below which uartAxRead() asserts RTS again
+//#define USE_UART_AUTOBAUD		///< UART Automatic Baud Rate Detection Conditional Compilation Flag (USCI_OPT_AUTOBAUD apps measure the break + 0x55 sync field of the peer, see uartAxBaudLocked())
+//#define USE_USCI_CONST_CONF		///< Const Configuration Conditional Compilation Flag (registerComm() takes const configs the compiler places in FRAM/flash, the rate of each app kept in RAM)
+
+// Host (Linux) build: simulated eUSCI registers, see usci_sim.h (compile with -DUSCI_HOST_SIM)
+#ifdef USCI_HOST_SIM
+#include "comm_hal_host.h"
+#endif // USCI_HOST_SIM
 
 /// USCI Configuration Data Structure
 typedef struct uconf
@@ -26,9 +75,75 @@ typedef struct uconf
 	unsigned int rAddr;		///< 16-Bit Resource Code [ USCI # (2 bits) ] [  USCI mode (2 bits) ] [ CS or I2C Address (12 bits) ]
 	unsigned int usciCtlW0;		///< 16-Bit USCI Control Word0 (see TI User Guide)
 	unsigned int usciCtlW1;		///< 16-Bit USCI Control Word1 (see TI User Guide)
-	unsigned int baudDiv;		///< Sourced clock rate divisor (can use FREQ_2_BAUDDIV(x) macro included below)
+	unsigned int baudDiv;		///< Sourced clock rate divisor (can use UBR_DIV(x), or UBR_BRW(x) for a modulated UART, included below)
 	unsigned char *rxPtr;		///< Data write back pointer
+	unsigned int opts;		///< Transfer option flags (USCI_OPT_XXX codes below, 0 for ISR driven transfers)
+	unsigned int mctlw;		///< UART Modulation Control Word (can use UBR_MCTLW(x) macro included below, 0 for no modulation)
+#ifdef USE_USCI_CALLBACKS
+	void (*onTxDone)(unsigned int commID);			///< Write complete hook (ISR context, 0 for none)
+	void (*onRxDone)(unsigned int commID);			///< SPI read/transfer complete, UART byte (or framed app: frame) received hook (ISR context, 0 for none)
+	void (*onError)(unsigned int commID, unsigned int err);	///< Receive error hook, err holds the STATW error flags, USCI_ERR_RXRING, USCI_ERR_NACK or USCI_ERR_FRAME (ISR context, 0 for none)
+#endif // USE_USCI_CALLBACKS
+#ifdef USE_UART_IDLE
+	unsigned int idleBits;		///< UART receive idle-line timeout in bit times after the last byte (e.g. 35 for the Modbus 3.5 character gap at 8N1, 0 for none)
+#ifdef USE_USCI_CALLBACKS
+	void (*onRxIdle)(unsigned int commID);			///< UART receive line idle for idleBits (end of message) hook (ISR context, 0 for none)
+#endif // USE_USCI_CALLBACKS
+#endif // USE_UART_IDLE
+#ifdef USE_USCI_PRIORITY
+	unsigned char priority;		///< Transmit queue priority of the app (0 lowest to 255 highest, see USCI_TXQ_AGE_STEP)
+#endif // USE_USCI_PRIORITY
 } usciConfig;
+#ifdef USE_USCI_CONST_CONF
+#define USCI_CONF_CONST		const	///< Registered configs are read only (declare them const usciConfig to keep them out of RAM)
+#else
+#define USCI_CONF_CONST			///< Registered configs are writable (setUCxxBaud() and auto-baud store the rate in them)
+#endif // USE_USCI_CONST_CONF
+
+/// USCI Queued Transmit Descriptor (see USE_USCI_TXQUEUE)
+typedef struct utxdesc
+{
+	unsigned char *data;		///< Data to be written (must remain valid until transmitted)
+	unsigned int len;		///< Length (in bytes) of data to be written
+	unsigned int commID;		///< Communication ID of the app which queued the write
+#ifdef USE_USCI_PRIORITY
+	unsigned char age;		///< Number of queued writes started before this one (aging)
+#endif // USE_USCI_PRIORITY
+} usciTxDesc;
+
+/// USCI Statistics Counters (see USE_USCI_STATS)
+typedef struct ustats
+{
+	unsigned long txBytes;		///< Bytes of the transfers started (written, exchanged or register addresses)
+	unsigned long rxBytes;		///< Bytes of the SPI/I2C reads started, UART bytes received
+	unsigned int xfers;		///< Transfers started (queued writes once started)
+	unsigned int busy;		///< Calls refused with USCI_BUSY_ERROR (module busy or transmit queue full)
+	unsigned int reconf;		///< Module reprogrammings by confUCxx() (app switches)
+	unsigned int rxErrors;		///< Received bytes dropped (UCRXERR dummy read or full UART receive ring)
+	unsigned int nacks;		///< I2C transfers ended by a slave NACK
+} usciStats;
+
+/// USCI ISR and Transfer Timing Profile (see USE_USCI_PROF, durations in USCI_PROF_TIMER ticks)
+typedef struct uprof
+{
+	unsigned long isrTicks;			///< Total ticks spent in the ISR (entry hook to exit hook)
+	unsigned long isrCount;			///< ISR entries profiled
+	unsigned int isrMin;			///< Shortest ISR
+	unsigned int isrMax;			///< Longest ISR
+	unsigned int isrHist[USCI_PROF_BINS];	///< ISR durations, bin n counts [n, n+1) << USCI_PROF_ISR_SHIFT ticks
+	unsigned long xferTicks;		///< Total ticks from transfer start to completion (ISR or DMA)
+	unsigned long xferMin;			///< Shortest transfer
+	unsigned long xferMax;			///< Longest transfer
+	unsigned int xferCount;			///< Transfers profiled
+	unsigned int xferHist[USCI_PROF_BINS];	///< Transfer durations, bin n > 0 counts [2^(n-1), 2^n) << USCI_PROF_XFER_SHIFT ticks
+} usciProf;
+
+/// USCI Transfer Segment (scatter-gather element, see USE_USCI_IOVEC)
+typedef struct useg
+{
+	unsigned char *data;		///< Segment data pointer
+	unsigned int len;		///< Segment length in bytes (non-zero)
+} usciSegment;
 
 /*********************************************************
  * Resource address control codes
@@ -81,18 +196,35 @@ typedef struct uconf
 #define SPI_S8M3_LE		((UCSYNC + UCCKPH + UCCKPL) << 8) + UCSSEL__SMCLK			///< UCTLW0: 8 bit Mode 3 SPI Slave LSB first
 #define SPI_S8M3_BE		((UCSYNC + UCCKPH + UCCKPL + UCMSB) << 8 ) + UCSSEL__SMCLK		///< UCTLW0: 8 bit Mode 3 SPI Slave MSB first
 // I2C MODE
-/* THESE MACROS NEED UPDATING/TESTING
-#define I2C_10SMT		UCA10 + UCSLA10 + UCMST + UCMODE_3 + UCSSEL1 + UCTR + UCSYNC		///< UCTLW0: 10 bit addressed I2C (master and slave), single master mode, transmitter w/ baud from SMCLK
-#define I2C_10SMR		UCA10 + UCSLA10 + UCMST + UCMODE_3 + UCSSEL1 + UCSYNC			///< UCTLW0: 10 bit addressed I2C (master and slave), single master mode, receiver w/ baud from SMCLK
-#define I2C_7SMT		UCMST + UCMODE_3 + UCSYNC + UCSSEL__SMCLK + UCTR			///< UCTLW0: 7 bit addressed I2C (master and slave), single master mode, transmitter w/ baud from SMCLK
-#define I2C_7SMR		UCMST + UCMODE_3 + UCSYNC + UCSSEL__SMCLK				///< UCTLW0: 7 bit addressed I2C (master and slave), single master mode, receiver w/ baud from SMCLK
-*/
+#define I2C_10SMT		((UCA10 + UCSLA10 + UCMST + UCMODE_3 + UCSYNC) << 8) + UCSSEL__SMCLK + UCTR	///< UCTLW0: 10 bit addressed I2C (master and slave), single master mode, transmitter w/ baud from SMCLK
+#define I2C_10SMR		((UCA10 + UCSLA10 + UCMST + UCMODE_3 + UCSYNC) << 8) + UCSSEL__SMCLK		///< UCTLW0: 10 bit addressed I2C (master and slave), single master mode, receiver w/ baud from SMCLK
+#define I2C_7SMT		((UCMST + UCMODE_3 + UCSYNC) << 8) + UCSSEL__SMCLK + UCTR			///< UCTLW0: 7 bit addressed I2C (master and slave), single master mode, transmitter w/ baud from SMCLK
+#define I2C_7SMR		((UCMST + UCMODE_3 + UCSYNC) << 8) + UCSSEL__SMCLK				///< UCTLW0: 7 bit addressed I2C (master and slave), single master mode, receiver w/ baud from SMCLK
 
 // USCI CTL Work 1 Defaults
 #define DEF_CTLW1		0x0003			///< CTLW1: 200ns deglitch time
 // USCI Baud Rate Defaults
 #define UCLK_FREQ		SMCLK_FREQ		///< USCI Clock Rate [use SMCLK to source our UART (from timing.h)]
 #define UBR_DIV(x)		UCLK_FREQ/x		///< Baud rate frequency to divisor macro (uses timing.h)
+#define UBR_BRW(x)		UART_BRW(UCLK_FREQ, x)	///< UART baud rate to (modulated) BRW macro (use with UBR_MCTLW)
+#define UBR_MCTLW(x)		UART_MCTLW(UCLK_FREQ, x)	///< UART baud rate to MCTLW macro (use with UBR_BRW)
+// eUSCI_A UART Baud Rate Generator (TI user guide algorithm, integer constant expressions evaluated at compile time)
+#define UART_N(clk, baud)	((clk) / (baud))					///< Integer part of N = clk/baud
+#define UART_NFRAC(clk, baud)	(((clk) % (baud)) * 10000ULL / (baud))	///< Fractional part of N (1/10000)
+#define UART_OS16(clk, baud)	((clk) > 16UL * (baud))					///< Oversampling for N > 16
+#define UART_BRW(clk, baud)	(UART_OS16(clk, baud) ? UART_N(clk, baud) / 16 : UART_N(clk, baud))	///< UCBRx
+#define UART_BRF(clk, baud)	(UART_OS16(clk, baud) ? UART_N(clk, baud) % 16 : 0)	///< UCBRFx (fraction of N/16)
+#define UART_BRS(frac)		((frac) >= 9288 ? 0xFE : (frac) >= 9170 ? 0xFD : (frac) >= 9004 ? 0xFB : (frac) >= 8751 ? 0xF7 : \
+				(frac) >= 8572 ? 0xEF : (frac) >= 8464 ? 0xDF : (frac) >= 8333 ? 0xBF : (frac) >= 8004 ? 0xEE : \
+				(frac) >= 7861 ? 0xED : (frac) >= 7503 ? 0xDD : (frac) >= 7147 ? 0xBB : (frac) >= 7001 ? 0xB7 : \
+				(frac) >= 6667 ? 0xD6 : (frac) >= 6432 ? 0xB6 : (frac) >= 6254 ? 0xB5 : (frac) >= 6003 ? 0xAD : \
+				(frac) >= 5715 ? 0x6B : (frac) >= 5002 ? 0xAA : (frac) >= 4378 ? 0x55 : (frac) >= 4286 ? 0x53 : \
+				(frac) >= 4003 ? 0x92 : (frac) >= 3753 ? 0x52 : (frac) >= 3575 ? 0x4A : (frac) >= 3335 ? 0x49 : \
+				(frac) >= 3000 ? 0x25 : (frac) >= 2503 ? 0x44 : (frac) >= 2224 ? 0x22 : (frac) >= 2147 ? 0x21 : \
+				(frac) >= 1670 ? 0x11 : (frac) >= 1430 ? 0x20 : (frac) >= 1252 ? 0x10 : (frac) >= 1001 ? 0x08 : \
+				(frac) >= 835 ? 0x04 : (frac) >= 715 ? 0x02 : (frac) >= 529 ? 0x01 : 0x00)	///< UCBRSx from the fraction of N (UG table)
+#define UART_MCTLW(clk, baud)	((UART_BRS(UART_NFRAC(clk, baud)) << 8) + (UART_BRF(clk, baud) << 4) + \
+				(UART_OS16(clk, baud) ? UCOS16 : 0))			///< MCTLW register image (UCBRSx, UCBRFx, UCOS16)
 
 // Resource config buffer index
 #define UCA0_INDEX		0			///< USCI A0 shared buffer index
@@ -104,13 +236,55 @@ typedef struct uconf
 #define	TX			1			///< USCI TX Status code
 #define	RX			2			///< USCI RX Status code
 #define SWAP			3			///< USCI Byte Swap Status code
+#define XFER			4			///< USCI SPI Full-Duplex Transfer Status code
+#define STOP			5			///< USCI I2C Stop Pending (after a slave NACK) Status code
+#define REG			6			///< USCI Register Address Phase Status code
+#define STREAM			7			///< USCI SPI Streaming Read Status code
+// Transfer Option Flags (usciConfig opts)
+#define USCI_OPT_DMA		0x0001			///< Move read/write data with the DMA controller (requires USE_USCI_DMA)
+#define USCI_OPT_COBS		0x0002			///< UART frames COBS encoded, 0x00 delimited (requires USE_USCI_FRAMING, overrides USCI_OPT_DMA)
+#define USCI_OPT_SLIP		0x0004			///< UART frames SLIP encoded (RFC 1055, requires USE_USCI_FRAMING, overrides USCI_OPT_DMA)
+#define USCI_OPT_CRC		0x0008			///< CRC-16-CCITT of the data sent and received computed by the ISRs (requires USE_USCI_CRC, overrides USCI_OPT_DMA)
+#define USCI_OPT_RTSCTS		0x0010			///< UART RTS/CTS flow control (requires USE_UART_FLOW, overrides USCI_OPT_DMA, ignored with USCI_OPT_FRAMING)
+#define USCI_OPT_AUTOBAUD	0x0020			///< UART baud rate measured by the module on each break + sync field (requires USE_UART_AUTOBAUD, baudDiv/mctlw updated)
+#define USCI_OPT_FRAMING	(USCI_OPT_COBS + USCI_OPT_SLIP)	///< Framing option mask
+#define USCI_OPT_BYTEWISE	(USCI_OPT_FRAMING + USCI_OPT_CRC + USCI_OPT_RTSCTS)	///< Options needing the ISR on every byte (USCI_OPT_DMA ignored)
+// SLIP Special Characters
+#define SLIP_END		0xC0			///< SLIP frame delimiter
+#define SLIP_ESC		0xDB			///< SLIP escape
+#define SLIP_ESC_END		0xDC			///< SLIP escaped frame delimiter
+#define SLIP_ESC_ESC		0xDD			///< SLIP escaped escape
+// Receive Error Codes (onError hook, besides the STATW UCRXERR/UCFE/UCOE/UCPE/UCBRK flags)
+#define USCI_ERR_RXRING		0x0100			///< UART byte dropped on a full receive ring
+#define USCI_ERR_NACK		0x0200			///< I2C address or data byte not acknowledged by the slave
+#define USCI_ERR_FRAME		0x0400			///< UART frame dropped (malformed, longer than USCI_FRAME_MAX or previous frame not released)
+#define USCI_ERR_BAUD		0x0800			///< UART break or sync field timeout (baud rate not measured)
+#define USCI_ERR_STREAM		0x1000			///< SPI stream block dropped (previous block not released in time)
 // Read/Write Routine Return Codes
 #define USCI_CONF_ERROR		-2			///< USCI configuration error return code
 #define	USCI_BUSY_ERROR		-1			///< USCI busy error return code
 #define	USCI_SUCCESS		1			///< TX/RX success return code
+#define USCI_QUEUED		2			///< Write queued behind the running transfer return code
+#define USCI_ID_ERROR		-3			///< Unknown or unregistered (stale) comm ID return code
+
+#if MAX_DEVS < 1 || MAX_DEVS >= (1 << USCI_SLOT_BITS)
+#error MAX_DEVS must be 1 to (1 << USCI_SLOT_BITS) - 1
+#endif // MAX_DEVS check
+#if defined(USE_USCI_PRIORITY) && !defined(USE_USCI_TXQUEUE)
+#error USE_USCI_PRIORITY requires USE_USCI_TXQUEUE
+#endif // USE_USCI_PRIORITY check
 
-// App. registration function prototype
-int registerComm(usciConfig *conf);
+// App. registration function prototypes
+int registerComm(USCI_CONF_CONST usciConfig *conf);
+int unregisterComm(unsigned int commID);
+#ifdef USE_USCI_STATS
+void getModStats(unsigned char index, usciStats *stats, unsigned char clear);
+void getCommStats(unsigned int commID, usciStats *stats, unsigned char clear);
+#endif // USE_USCI_STATS
+#ifdef USE_USCI_PROF
+void startModProf(void);
+void getModProf(unsigned char index, usciProf *prof, unsigned char clear);
+#endif // USE_USCI_PROF
 /*************************************************************************
  * UCA0 Macro Logic
  ************************************************************************/
@@ -120,11 +294,41 @@ void resetUCA0(unsigned int commID);
 unsigned int getUCA0RxSize(void);
 unsigned char getUCA0Stat(void);
 void setUCA0Baud(unsigned int baudDiv, unsigned int commID);
+#ifdef USE_USCI_LPM
+void waitUCA0(void);
+#endif // USE_USCI_LPM
+#ifdef USE_USCI_CRC
+unsigned int getUCA0TxCrc(void);
+unsigned int getUCA0RxCrc(unsigned char restart);
+#endif // USE_USCI_CRC
 /************************* UCA0 UART MODE ********************************/
 #ifdef USE_UCA0_UART
 // Function prototypes
 int uartA0Write(unsigned char* data, unsigned int len, unsigned int commID);
 int uartA0Read(unsigned int len, unsigned int commID);
+#ifdef USE_USCI_IOVEC
+int uartA0WriteV(const usciSegment *seg, unsigned char count, unsigned int commID);
+#endif // USE_USCI_IOVEC
+#ifdef USE_USCI_FRAMING
+unsigned int uartA0GetFrame(unsigned char **frame);
+void uartA0ReleaseFrame(void);
+#endif // USE_USCI_FRAMING
+#ifdef USE_UART_IDLE
+unsigned char uartA0RxIdle(void);
+#ifdef USE_USCI_LPM
+void uartA0WaitIdle(void);
+#endif // USE_USCI_LPM
+#endif // USE_UART_IDLE
+#ifdef USE_UART_AUTOBAUD
+unsigned char uartA0BaudLocked(void);
+#endif // USE_UART_AUTOBAUD
+#ifdef USE_UART_RXRING
+unsigned int getUCA0RxOverflow(void);
+#define UCA0_RXRING	///< USCI A0 UART Receive Ring Active Definition
+#if UCA0_RXRING_SIZE < 2 || UCA0_RXRING_SIZE > 32768 || (UCA0_RXRING_SIZE & (UCA0_RXRING_SIZE - 1))
+#error UCA0_RXRING_SIZE must be a power of 2 (2 to 32768)
+#endif // UCA0_RXRING_SIZE check
+#endif // USE_UART_RXRING
 // Other useful macros
 #define USE_UCA0	///< UCA0 Active Definition
 // Multiple endpoint config detection
@@ -137,7 +341,23 @@ int uartA0Read(unsigned int len, unsigned int commID);
 // Function prototypes
 int spiA0Write(unsigned char* data, unsigned int len, unsigned int commID);
 int spiA0Read(unsigned int len, unsigned int commID);
-unsigned char spiA0Swap(unsigned char byte, unsigned int commID);
+int spiA0Swap(unsigned char byte, unsigned int commID);
+int spiA0Transfer(unsigned char *tx, unsigned char *rx, unsigned int len, unsigned int commID);
+#ifdef USE_USCI_IOVEC
+int spiA0WriteV(const usciSegment *seg, unsigned char count, unsigned int commID);
+int spiA0ReadV(const usciSegment *seg, unsigned char count, unsigned int commID);
+#endif // USE_USCI_IOVEC
+#ifdef USE_USCI_REGS
+int spiA0RegRead(unsigned char reg, unsigned char *buf, unsigned int len, unsigned int commID);
+int spiA0RegWrite(unsigned char reg, unsigned char *data, unsigned int len, unsigned int commID);
+#endif // USE_USCI_REGS
+#ifdef USE_SPI_STREAM
+int spiA0Stream(unsigned char *bufA, unsigned char *bufB, unsigned int len, unsigned int commID);
+unsigned int spiA0StreamGet(unsigned char **block);
+void spiA0StreamRelease(void);
+void spiA0StreamStop(void);
+unsigned int getUCA0StreamDrops(void);
+#endif // USE_SPI_STREAM
 // Multiple Endpoint Config Compiler Error
 #define USE_UCA0	///< USCI A0 Active Definition
 #ifdef USE_UCA0_UART
@@ -154,11 +374,41 @@ void resetUCA1(unsigned int commID);
 unsigned int getUCA1RxSize(void);
 unsigned char getUCA1Stat(void);
 void setUCA1Baud(unsigned int baudDiv, unsigned int commID);
+#ifdef USE_USCI_LPM
+void waitUCA1(void);
+#endif // USE_USCI_LPM
+#ifdef USE_USCI_CRC
+unsigned int getUCA1TxCrc(void);
+unsigned int getUCA1RxCrc(unsigned char restart);
+#endif // USE_USCI_CRC
 /************************* UCA1 UART MODE ********************************/
 #ifdef USE_UCA1_UART
 // Function prototypes
 int uartA1Write(unsigned char* data, unsigned int len, unsigned int commID);
 int uartA1Read(unsigned int len, unsigned int commID);
+#ifdef USE_USCI_IOVEC
+int uartA1WriteV(const usciSegment *seg, unsigned char count, unsigned int commID);
+#endif // USE_USCI_IOVEC
+#ifdef USE_USCI_FRAMING
+unsigned int uartA1GetFrame(unsigned char **frame);
+void uartA1ReleaseFrame(void);
+#endif // USE_USCI_FRAMING
+#ifdef USE_UART_IDLE
+unsigned char uartA1RxIdle(void);
+#ifdef USE_USCI_LPM
+void uartA1WaitIdle(void);
+#endif // USE_USCI_LPM
+#endif // USE_UART_IDLE
+#ifdef USE_UART_AUTOBAUD
+unsigned char uartA1BaudLocked(void);
+#endif // USE_UART_AUTOBAUD
+#ifdef USE_UART_RXRING
+unsigned int getUCA1RxOverflow(void);
+#define UCA1_RXRING	///< USCI A1 UART Receive Ring Active Definition
+#if UCA1_RXRING_SIZE < 2 || UCA1_RXRING_SIZE > 32768 || (UCA1_RXRING_SIZE & (UCA1_RXRING_SIZE - 1))
+#error UCA1_RXRING_SIZE must be a power of 2 (2 to 32768)
+#endif // UCA1_RXRING_SIZE check
+#endif // USE_UART_RXRING
 // Other useful macros
 #define USE_UCA1	///< USCI A1 Active Definition
 // Multiple endpoint config detection
@@ -171,7 +421,23 @@ int uartA1Read(unsigned int len, unsigned int commID);
 // Function prototypes
 int spiA1Write(unsigned char* data, unsigned int len, unsigned int commID);
 int spiA1Read(unsigned int len, unsigned int commID);
-unsigned char spiA1Swap(unsigned char byte, unsigned int commID);
+int spiA1Swap(unsigned char byte, unsigned int commID);
+int spiA1Transfer(unsigned char *tx, unsigned char *rx, unsigned int len, unsigned int commID);
+#ifdef USE_USCI_IOVEC
+int spiA1WriteV(const usciSegment *seg, unsigned char count, unsigned int commID);
+int spiA1ReadV(const usciSegment *seg, unsigned char count, unsigned int commID);
+#endif // USE_USCI_IOVEC
+#ifdef USE_USCI_REGS
+int spiA1RegRead(unsigned char reg, unsigned char *buf, unsigned int len, unsigned int commID);
+int spiA1RegWrite(unsigned char reg, unsigned char *data, unsigned int len, unsigned int commID);
+#endif // USE_USCI_REGS
+#ifdef USE_SPI_STREAM
+int spiA1Stream(unsigned char *bufA, unsigned char *bufB, unsigned int len, unsigned int commID);
+unsigned int spiA1StreamGet(unsigned char **block);
+void spiA1StreamRelease(void);
+void spiA1StreamStop(void);
+unsigned int getUCA1StreamDrops(void);
+#endif // USE_SPI_STREAM
 // Other useful macros
 #define USE_UCA1	///< USCI A1 Active Definition
 // Multiple endpoint config detection
@@ -189,12 +455,35 @@ void resetUCB0(unsigned int commID);
 unsigned int getUCB0RxSize(void);
 unsigned char getUCB0Stat(void);
 void setUCB0Baud(unsigned int baudDiv, unsigned int commID);
+#ifdef USE_USCI_LPM
+void waitUCB0(void);
+#endif // USE_USCI_LPM
+#ifdef USE_USCI_CRC
+unsigned int getUCB0TxCrc(void);
+unsigned int getUCB0RxCrc(unsigned char restart);
+#endif // USE_USCI_CRC
 /************************* UCB0 SPI MODE *********************************/
 #ifdef USE_UCB0_SPI
 // Function prototypes
 int spiB0Write(unsigned char* data, unsigned int len, unsigned int commID);
 int spiB0Read(unsigned int len, unsigned int commID);
-unsigned char spiB0Swap(unsigned char byte, unsigned int commID);
+int spiB0Swap(unsigned char byte, unsigned int commID);
+int spiB0Transfer(unsigned char *tx, unsigned char *rx, unsigned int len, unsigned int commID);
+#ifdef USE_USCI_IOVEC
+int spiB0WriteV(const usciSegment *seg, unsigned char count, unsigned int commID);
+int spiB0ReadV(const usciSegment *seg, unsigned char count, unsigned int commID);
+#endif // USE_USCI_IOVEC
+#ifdef USE_USCI_REGS
+int spiB0RegRead(unsigned char reg, unsigned char *buf, unsigned int len, unsigned int commID);
+int spiB0RegWrite(unsigned char reg, unsigned char *data, unsigned int len, unsigned int commID);
+#endif // USE_USCI_REGS
+#ifdef USE_SPI_STREAM
+int spiB0Stream(unsigned char *bufA, unsigned char *bufB, unsigned int len, unsigned int commID);
+unsigned int spiB0StreamGet(unsigned char **block);
+void spiB0StreamRelease(void);
+void spiB0StreamStop(void);
+unsigned int getUCB0StreamDrops(void);
+#endif // USE_SPI_STREAM
 // Other useful macros
 #define USE_UCB0	///< USCI B0 Active Definition
 // Multiple endpoint config detection
@@ -207,7 +496,12 @@ unsigned char spiB0Swap(unsigned char byte, unsigned int commID);
 // Function prototypes
 int i2cB0Write(unsigned char* data, unsigned int len, unsigned int commID);
 int i2cB0Read(unsigned int len, unsigned int commID);
+int i2cB0Transfer(unsigned char *tx, unsigned int txLen, unsigned int rxLen, unsigned int commID);
 int i2cB0SlavePresent(unsigned int commID);
+#ifdef USE_USCI_REGS
+int i2cB0RegRead(unsigned char reg, unsigned char *buf, unsigned int len, unsigned int commID);
+int i2cB0RegWrite(unsigned char reg, unsigned char *data, unsigned int len, unsigned int commID);
+#endif // USE_USCI_REGS
 // Other useful macros
 #define USE_UCB0	///< USCI B0 Active Definition
 /// Muleiple endpoint config detection
@@ -225,12 +519,35 @@ void resetUCB1(unsigned int commID);
 unsigned int getUCB1RxSize(void);
 unsigned char getUCB1Stat(void);
 void setUCB1Baud(unsigned int baudDiv, unsigned int commID);
+#ifdef USE_USCI_LPM
+void waitUCB1(void);
+#endif // USE_USCI_LPM
+#ifdef USE_USCI_CRC
+unsigned int getUCB1TxCrc(void);
+unsigned int getUCB1RxCrc(unsigned char restart);
+#endif // USE_USCI_CRC
 /************************* UCB1 SPI MODE *********************************/
 #ifdef USE_UCB1_SPI
 // Function prototypes
 int spiB1Write(unsigned char* data, unsigned int len, unsigned int commID);
 int spiB1Read(unsigned int len, unsigned int commID);
-unsigned char spiB1Swap(unsigned char byte, unsigned int commID);
+int spiB1Swap(unsigned char byte, unsigned int commID);
+int spiB1Transfer(unsigned char *tx, unsigned char *rx, unsigned int len, unsigned int commID);
+#ifdef USE_USCI_IOVEC
+int spiB1WriteV(const usciSegment *seg, unsigned char count, unsigned int commID);
+int spiB1ReadV(const usciSegment *seg, unsigned char count, unsigned int commID);
+#endif // USE_USCI_IOVEC
+#ifdef USE_USCI_REGS
+int spiB1RegRead(unsigned char reg, unsigned char *buf, unsigned int len, unsigned int commID);
+int spiB1RegWrite(unsigned char reg, unsigned char *data, unsigned int len, unsigned int commID);
+#endif // USE_USCI_REGS
+#ifdef USE_SPI_STREAM
+int spiB1Stream(unsigned char *bufA, unsigned char *bufB, unsigned int len, unsigned int commID);
+unsigned int spiB1StreamGet(unsigned char **block);
+void spiB1StreamRelease(void);
+void spiB1StreamStop(void);
+unsigned int getUCB1StreamDrops(void);
+#endif // USE_SPI_STREAM
 // Other useful macros
 #define USE_UCB1	///< USCI B1 Active Definition
 // Multiple endpoint config detection
@@ -243,7 +560,12 @@ unsigned char spiB1Swap(unsigned char byte, unsigned int commID);
 // Function prototypes
 int i2cB1Write(unsigned char* data, unsigned int len, unsigned int commID);
 int i2cB1Read(unsigned int len, unsigned int commID);
+int i2cB1Transfer(unsigned char *tx, unsigned int txLen, unsigned int rxLen, unsigned int commID);
 int i2cB1SlavePresent(unsigned int commID);
+#ifdef USE_USCI_REGS
+int i2cB1RegRead(unsigned char reg, unsigned char *buf, unsigned int len, unsigned int commID);
+int i2cB1RegWrite(unsigned char reg, unsigned char *data, unsigned int len, unsigned int commID);
+#endif // USE_USCI_REGS
 // Other useful macros
 #define USE_UCB1	///< USCI B1 Active Definition
 /// Multiple endpoint config detection
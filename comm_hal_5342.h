@@ -12,10 +12,12 @@
 // UCA0TXD/SIMO = P3.3 (Pin 25)
 // UCA0RXD/SOMI = P3.4 (Pin 26)
 // UCA0SCLK = P2.7 (Pin 21)
+// UCA0RTS/CTS = P1.0/P1.1 (GPIO, USE_UART_FLOW)
 //*********** UCA1 **************//
 // UCA1TXD/SIMO = P4.4 (Pin 33)
 // UCA1RXD/SOMI = P4.5 (Pin 34)
 // UCA1SCLK = P4.0 (Pin 27)
+// UCA1RTS/CTS = P1.2/P1.3 (GPIO, USE_UART_FLOW)
 //*********** UCB0 **************//
 // UCB0SIMO/SDA = P3.0 (Pin 22)
 // UCB0SOMI/SCL = P3.1 (Pin 23)
@@ -28,51 +30,71 @@
 
 // UCA0 UART Mode Defines
 #ifdef USE_UCA0_UART 
-#define	UCA0_IO_CONF(x)	P3SEL |= (BIT3 + BIT4)				///< USCI A0 UART I/O Configuration
-#define UCA0_IO_CLEAR()	P3SEL &= ~(BIT3 + BIT4)				///< USCI A0 UART I/O Clear
+#define	UCA0_IO_CONF(x)	do{ P3SEL |= (BIT3 + BIT4); }while(0)				///< USCI A0 UART I/O Configuration
+#define UCA0_IO_CLEAR()	do{ P3SEL &= ~(BIT3 + BIT4); }while(0)				///< USCI A0 UART I/O Clear
+#define UCA0_RTS_PIN	BIT0	///< USCI A0 UART RTS output (P1.0, USE_UART_FLOW)
+#define UCA0_CTS_PIN	BIT1	///< USCI A0 UART CTS input (P1.1, USE_UART_FLOW)
 #endif
 
 // UCA0 SPI Mode Defines
 #ifdef USE_UCA0_SPI 
-#define UCA0_IO_CONF(x) P3SEL |= (BIT3 + BIT4); P2SEL |= BIT7		///< USCI A0 SPI I/O Configuration
-#define UCA0_IO_CLEAR()	P3SEL &= ~(BIT3 + BIT4); P2SEL &= ~BIT7		///< USCI A0 SPI I/O Clear
+#define UCA0_IO_CONF(x) do{ P3SEL |= (BIT3 + BIT4); P2SEL |= BIT7; }while(0)		///< USCI A0 SPI I/O Configuration
+#define UCA0_IO_CLEAR()	do{ P3SEL &= ~(BIT3 + BIT4); P2SEL &= ~BIT7; }while(0)		///< USCI A0 SPI I/O Clear
 #endif
 
 // UCA1 UART Mode Defines
 #ifdef USE_UCA1_UART
-#define	UCA1_IO_CONF(x)	P4SEL |= (BIT4 + BIT5)				///< USCI A1 UART I/O Configuration
-#define UCA1_IO_CLEAR()	P4SEL &= ~(BIT4 + BIT5)				///< USCI A1 UART I/O Clear
+#define	UCA1_IO_CONF(x)	do{ P4SEL |= (BIT4 + BIT5); }while(0)				///< USCI A1 UART I/O Configuration
+#define UCA1_IO_CLEAR()	do{ P4SEL &= ~(BIT4 + BIT5); }while(0)				///< USCI A1 UART I/O Clear
+#define UCA1_RTS_PIN	BIT2	///< USCI A1 UART RTS output (P1.2, USE_UART_FLOW)
+#define UCA1_CTS_PIN	BIT3	///< USCI A1 UART CTS input (P1.3, USE_UART_FLOW)
 #endif
 
 // UCA1 SPI Mode Defines
 #ifdef USE_UCA1_SPI	
-#define	UCA1_IO_CONF(x) P4SEL |= (BIT0 + BIT4 + BIT5)			///< USCI A1 SPI I/O Configuration
-#define UCA1_IO_CLEAR()	P4SEL &= ~(BIT0 + BIT4 + BIT5)			///< USCI A1 SPI I/O Clear
+#define	UCA1_IO_CONF(x) do{ P4SEL |= (BIT0 + BIT4 + BIT5); }while(0)			///< USCI A1 SPI I/O Configuration
+#define UCA1_IO_CLEAR()	do{ P4SEL &= ~(BIT0 + BIT4 + BIT5); }while(0)			///< USCI A1 SPI I/O Clear
 #endif
 
 // UCB0 SPI Mode Defines
 #ifdef USE_UCB0_SPI 
-#define UCB0_IO_CONF(x)	P3SEL |= (BIT0 + BIT1 + BIT2)			///< USCI B0 SPI I/O Configuration
-#define	UCB0_IO_CLEAR()	P3SEL &= ~(BIT0 + BIT1 + BIT2)			///< USCI B0 SPI I/O Clear
+#define UCB0_IO_CONF(x)	do{ P3SEL |= (BIT0 + BIT1 + BIT2); }while(0)			///< USCI B0 SPI I/O Configuration
+#define	UCB0_IO_CLEAR()	do{ P3SEL &= ~(BIT0 + BIT1 + BIT2); }while(0)			///< USCI B0 SPI I/O Clear
 #endif
 
 // UCB0 I2C Mode Defines
-// NOTE: Need to add I2C addressing control here
 #ifdef USE_UCB0_I2C 
-	#define	UCB0_IO_CONF(x) P3SEL |= (BIT0 + BIT1)//; I2C_ADDR(x)	///< USCI B0 I2C I/O Configuration
-	#define	UCB0_IO_CLEAR()	P3SEL &= ~(BIT0 + BIT1 + BIT2)		///< USCI B0 I2C I/O Clear
+	#define	UCB0_IO_CONF(x) do{ P3SEL |= (BIT0 + BIT1); }while(0)	///< USCI B0 I2C I/O Configuration
+	#define	UCB0_IO_CLEAR()	do{ P3SEL &= ~(BIT0 + BIT1 + BIT2); }while(0)		///< USCI B0 I2C I/O Clear
 #endif
 
 // UCB1 SPI Mode Defines
 #ifdef USE_UCB1_SPI
-	#define	UCB1_IO_CONF(x)	P4SEL |= (BIT1 + BIT2 + BIT3)		///< USCI B1 SPI I/O Configuration
-	#define UCB1_IO_CLEAR()	P4SEL &= ~(BIT1 + BIT2 + BIT3)		///< USCI B1 SPI I/O Clear
+	#define	UCB1_IO_CONF(x)	do{ P4SEL |= (BIT1 + BIT2 + BIT3); }while(0)		///< USCI B1 SPI I/O Configuration
+	#define UCB1_IO_CLEAR()	do{ P4SEL &= ~(BIT1 + BIT2 + BIT3); }while(0)		///< USCI B1 SPI I/O Clear
 #endif
 
 // UCB1 I2C Mode Defines
-// // NOTE: Need to add I2C addressing control here
 #ifdef USE_UCB1_I2C
-	#define UCB1_IO_CONF(x) P4SEL |= (BIT1 + BIT2)//; I2C_ADDR(x)	///< USCI B1 I2C I/O Configuration
-	#define UCB1_IO_CLEAR()	P4SEL &= ~(BIT1 + BIT2)			///< USCI B1 I2C I/O Clear
+	#define UCB1_IO_CONF(x) do{ P4SEL |= (BIT1 + BIT2); }while(0)	///< USCI B1 I2C I/O Configuration
+	#define UCB1_IO_CLEAR()	do{ P4SEL &= ~(BIT1 + BIT2); }while(0)			///< USCI B1 I2C I/O Clear
 #endif
+// DMA Trigger Sources (DMAxTSEL)
+#define UCA0_DMA_RXTRIG		16	///< USCI A0 receive DMA trigger (UCA0RXIFG)
+#define UCA0_DMA_TXTRIG		17	///< USCI A0 transmit DMA trigger (UCA0TXIFG)
+#define UCB0_DMA_RXTRIG		18	///< USCI B0 receive DMA trigger (UCB0RXIFG)
+#define UCB0_DMA_TXTRIG		19	///< USCI B0 transmit DMA trigger (UCB0TXIFG)
+#define UCA1_DMA_RXTRIG		20	///< USCI A1 receive DMA trigger (UCA1RXIFG)
+#define UCA1_DMA_TXTRIG		21	///< USCI A1 transmit DMA trigger (UCA1TXIFG)
+#define UCB1_DMA_RXTRIG		22	///< USCI B1 receive DMA trigger (UCB1RXIFG)
+#define UCB1_DMA_TXTRIG		23	///< USCI B1 transmit DMA trigger (UCB1TXIFG)
+// UART RTS/CTS Flow Control Port (USE_UART_FLOW: RTS GPIO output, CTS GPIO input with edge interrupt)
+#define USCI_FLOW_IN		P1IN	///< CTS input register
+#define USCI_FLOW_OUT		P1OUT	///< RTS output register
+#define USCI_FLOW_DIR		P1DIR	///< RTS/CTS direction register
+#define USCI_FLOW_IES		P1IES	///< CTS interrupt edge select register
+#define USCI_FLOW_IE		P1IE	///< CTS interrupt enable register
+#define USCI_FLOW_IFG		P1IFG	///< CTS interrupt flag register
+#define USCI_FLOW_SEL(pins)	do{ P1SEL &= ~(pins); }while(0)	///< Select the GPIO function of the RTS/CTS pins
+#define USCI_CTS_VECTOR		PORT1_VECTOR	///< CTS interrupt vector (owned by comm.c when USE_UART_FLOW)
 #endif /* COMM_HAL_5342_H_ */
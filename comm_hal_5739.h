@@ -12,10 +12,12 @@
 // UCA0TXD/SIMO	= P2.0 (Pin 21)
 // UCA0RXS/SOMI = P2.1 (Pin 22)
 // UCA0SCLK = P1.5 (Pin 10)
+// UCA0RTS/CTS = P1.0/P1.1 (GPIO, USE_UART_FLOW)
 //*********** UCA1 *************//
 // UCA1TXD/SIMO = P2.5 (Pin 17)
 // UCA1RXD/SOMI = P2.6 (Pin 18)
 // UCA1CLK = P2.4 (Pin 35)
+// UCA1RTS/CTS = P1.2/P1.3 (GPIO, USE_UART_FLOW)
 //*********** UCB0 *************//
 // UCB0SIMO/UCBSDA = P1.6 (Pin 28)
 // UCB0SOMI/UCBSCL = P1.7 (Pin 29)
@@ -23,30 +25,49 @@
 //******************************//
 
 #ifdef USE_UCA0_UART	// UCA0 UART Mode Defines
-	#define UCA0_IO_CONF(x)	P2SEL1 |= BIT0 + BIT1; P2SEL0 &= ~(BIT0 + BIT1)						///< USCI A0 UART I/O Configuration
-	#define	UCA0_IO_CLEAR()	P2SEL1 &= ~(BIT0 + BIT1); P2SEL0 &= ~(BIT0 + BIT1)					///< USCI A0 UART I/O Clear
+	#define UCA0_IO_CONF(x)	do{ P2SEL1 |= BIT0 + BIT1; P2SEL0 &= ~(BIT0 + BIT1); }while(0)						///< USCI A0 UART I/O Configuration
+	#define	UCA0_IO_CLEAR()	do{ P2SEL1 &= ~(BIT0 + BIT1); P2SEL0 &= ~(BIT0 + BIT1); }while(0)					///< USCI A0 UART I/O Clear
+	#define UCA0_RTS_PIN	BIT0	///< USCI A0 UART RTS output (P1.0, USE_UART_FLOW)
+	#define UCA0_CTS_PIN	BIT1	///< USCI A0 UART CTS input (P1.1, USE_UART_FLOW)
 #endif
 #ifdef USE_UCA0_SPI	// UCA0 SPI Mode Defines
-	#define UCA0_IO_CONF(x)	P2SEL1 |= BIT0 + BIT1; P2SEL0 &= ~(BIT0 + BIT1); P1SEL1 |= BIT5; P1SEL0 &= ~(BIT5)	///< USCI A0 SPI I/O Configuration
-	#define	UCA0_IO_CLEAR()	P2SEL1 &= ~(BIT0 + BIT1); P2SEL0 &= ~(BIT0 + BIT1); P1SEL1 &= ~BIT5; P1SEL0 &= ~BIT5	///< USCI A0 SPI I/O Clear
+	#define UCA0_IO_CONF(x)	do{ P2SEL1 |= BIT0 + BIT1; P2SEL0 &= ~(BIT0 + BIT1); P1SEL1 |= BIT5; P1SEL0 &= ~(BIT5); }while(0)	///< USCI A0 SPI I/O Configuration
+	#define	UCA0_IO_CLEAR()	do{ P2SEL1 &= ~(BIT0 + BIT1); P2SEL0 &= ~(BIT0 + BIT1); P1SEL1 &= ~BIT5; P1SEL0 &= ~BIT5; }while(0)	///< USCI A0 SPI I/O Clear
 #endif
 #ifdef USE_UCA1_UART	// UCA1 UART Mode Defines
-	#define UCA1_IO_CONF(x)	P2SEL1 |= BIT5 + BIT6; P2SEL0 &= ~(BIT5 + BIT6)						///< USCI A1 UART I/O Configuration
-	#define UCA1_IO_CLEAR()	P2SEL1 &= ~(BIT5 + BIT6); P2SEL0 &= ~(BIT5 + BIT6)					///< USCI A1 UART I/O Clear
+	#define UCA1_IO_CONF(x)	do{ P2SEL1 |= BIT5 + BIT6; P2SEL0 &= ~(BIT5 + BIT6); }while(0)						///< USCI A1 UART I/O Configuration
+	#define UCA1_IO_CLEAR()	do{ P2SEL1 &= ~(BIT5 + BIT6); P2SEL0 &= ~(BIT5 + BIT6); }while(0)					///< USCI A1 UART I/O Clear
+	#define UCA1_RTS_PIN	BIT2	///< USCI A1 UART RTS output (P1.2, USE_UART_FLOW)
+	#define UCA1_CTS_PIN	BIT3	///< USCI A1 UART CTS input (P1.3, USE_UART_FLOW)
 #endif
 #ifdef USE_UCA1_SPI	// UCA1 SPI Mode Defines
-	#define UCB0_IO_CONF(x)	P1SEL1 |= BIT6 + BIT7; P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 |= BIT2; P2SEL0 &= ~BIT2	///< USCI B0 SPI I/O Configuration
-	#define UCB0_IO_CLEAR()	P1SEL1 &= ~(BIT6 + BIT7); P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 &= ~BIT2; P2SEL0 &= ~BIT2 	///< USCI B0 SPI I/O Clear
+	#define UCB0_IO_CONF(x)	do{ P1SEL1 |= BIT6 + BIT7; P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 |= BIT2; P2SEL0 &= ~BIT2; }while(0)	///< USCI B0 SPI I/O Configuration
+	#define UCB0_IO_CLEAR()	do{ P1SEL1 &= ~(BIT6 + BIT7); P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 &= ~BIT2; P2SEL0 &= ~BIT2; }while(0) 	///< USCI B0 SPI I/O Clear
 #endif
 #ifdef USE_UCB0_SPI	// UCB0 SPI Mode Defines
-	#define UCB0_IO_CONF(x)	P1SEL1 |= BIT6 + BIT7; P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 |= BIT2; P2SEL0 &= ~BIT2	///< USCI B0 SPI I/O Configuration
-	#define UCB0_IO_CLEAR()	P1SEL1 &= ~(BIT6 + BIT7); P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 &= ~BIT2; P2SEL0 &= ~BIT2 	///< USCI B0 SPI I/O Clear
+	#define UCB0_IO_CONF(x)	do{ P1SEL1 |= BIT6 + BIT7; P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 |= BIT2; P2SEL0 &= ~BIT2; }while(0)	///< USCI B0 SPI I/O Configuration
+	#define UCB0_IO_CLEAR()	do{ P1SEL1 &= ~(BIT6 + BIT7); P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 &= ~BIT2; P2SEL0 &= ~BIT2; }while(0) 	///< USCI B0 SPI I/O Clear
 #endif
 #ifdef USE_UCB0_I2C	// UCB0 I2C Mode Defines
-	#define UCB0_IO_CONF(x)	P1SEL1 |= BIT6 + BIT7; P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 |= BIT2; P2SEL0 &= ~BIT2 //; I2C_ADDR(x)	///< USCI B0 I2C I/O Configuration
-	#define UCB0_IO_CLEAR()	P1SEL1 &= ~(BIT6 + BIT7); P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 &= ~BIT2; P2SEL0 &= ~BIT2			///< USCI B0 I2C I/O Clear
-	#define I2C_ADDR(x)	UCB0I2CSA = x
+	#define UCB0_IO_CONF(x)	do{ P1SEL1 |= BIT6 + BIT7; P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 |= BIT2; P2SEL0 &= ~BIT2; }while(0) 	///< USCI B0 I2C I/O Configuration
+	#define UCB0_IO_CLEAR()	do{ P1SEL1 &= ~(BIT6 + BIT7); P1SEL0 &= ~(BIT6 + BIT7); P2SEL1 &= ~BIT2; P2SEL0 &= ~BIT2; }while(0)			///< USCI B0 I2C I/O Clear
 #endif
+// DMA Trigger Sources (DMAxTSEL)
+#define UCA0_DMA_RXTRIG		14	///< USCI A0 receive DMA trigger (UCA0RXIFG)
+#define UCA0_DMA_TXTRIG		15	///< USCI A0 transmit DMA trigger (UCA0TXIFG)
+#define UCA1_DMA_RXTRIG		16	///< USCI A1 receive DMA trigger (UCA1RXIFG)
+#define UCA1_DMA_TXTRIG		17	///< USCI A1 transmit DMA trigger (UCA1TXIFG)
+#define UCB0_DMA_RXTRIG		18	///< USCI B0 receive DMA trigger (UCB0RXIFG0)
+#define UCB0_DMA_TXTRIG		19	///< USCI B0 transmit DMA trigger (UCB0TXIFG0)
+// UART RTS/CTS Flow Control Port (USE_UART_FLOW: RTS GPIO output, CTS GPIO input with edge interrupt)
+#define USCI_FLOW_IN		P1IN	///< CTS input register
+#define USCI_FLOW_OUT		P1OUT	///< RTS output register
+#define USCI_FLOW_DIR		P1DIR	///< RTS/CTS direction register
+#define USCI_FLOW_IES		P1IES	///< CTS interrupt edge select register
+#define USCI_FLOW_IE		P1IE	///< CTS interrupt enable register
+#define USCI_FLOW_IFG		P1IFG	///< CTS interrupt flag register
+#define USCI_FLOW_SEL(pins)	do{ P1SEL1 &= ~(pins); P1SEL0 &= ~(pins); }while(0)	///< Select the GPIO function of the RTS/CTS pins
+#define USCI_CTS_VECTOR		PORT1_VECTOR	///< CTS interrupt vector (owned by comm.c when USE_UART_FLOW)
 #ifdef USE_UCB1
 #error No USCI B1 Module Available in the MSP430FR5739
 #endif //USE_UCB1
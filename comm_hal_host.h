@@ -0,0 +1,66 @@
+/******************************************************************************
+ * This file contains the pin input/output lists for the host (Linux) build
+ * where the eUSCI modules are provided by the register simulator (see
+ * usci_sim.h). The simulated modules have no pins, so the I/O configuration
+ * macros are defined (empty) for every module and mode.
+ ******************************************************************************/
+#ifndef COMM_HAL
+#define COMM_HAL
+
+#include "usci_sim.h"
+
+// Simulated EUSCI Module Pinouts
+//*********** UCA0 **************//
+// Peer line: usciSimFeed(USIM_A0, ...) / usciSimDrain(USIM_A0, ...)
+// RTS/CTS = P1.0/P1.1 (peer side: usciSimFlow(USIM_A0, BIT0, BIT1) / usciSimCts(USIM_A0, ...))
+//*********** UCA1 **************//
+// Peer line: usciSimFeed(USIM_A1, ...) / usciSimDrain(USIM_A1, ...)
+// RTS/CTS = P1.2/P1.3 (peer side: usciSimFlow(USIM_A1, BIT2, BIT3) / usciSimCts(USIM_A1, ...))
+//*********** UCB0 **************//
+// Peer line: usciSimFeed(USIM_B0, ...) / usciSimDrain(USIM_B0, ...)
+//*********** UCB1 **************//
+// Peer line: usciSimFeed(USIM_B1, ...) / usciSimDrain(USIM_B1, ...)
+//******************************//
+
+#define UCA0_IO_CONF(x)	do{ }while(0)		///< USCI A0 I/O Configuration (no pins to configure)
+#define UCA0_IO_CLEAR()	do{ }while(0)		///< USCI A0 I/O Clear
+#define UCA0_RTS_PIN		BIT0	///< USCI A0 UART RTS output (simulated P1.0, USE_UART_FLOW)
+#define UCA0_CTS_PIN		BIT1	///< USCI A0 UART CTS input (simulated P1.1, USE_UART_FLOW)
+#define UCA1_IO_CONF(x)	do{ }while(0)		///< USCI A1 I/O Configuration (no pins to configure)
+#define UCA1_IO_CLEAR()	do{ }while(0)		///< USCI A1 I/O Clear
+#define UCA1_RTS_PIN		BIT2	///< USCI A1 UART RTS output (simulated P1.2, USE_UART_FLOW)
+#define UCA1_CTS_PIN		BIT3	///< USCI A1 UART CTS input (simulated P1.3, USE_UART_FLOW)
+#define UCB0_IO_CONF(x)	do{ }while(0)		///< USCI B0 I/O Configuration (no pins to configure)
+#define UCB0_IO_CLEAR()	do{ }while(0)		///< USCI B0 I/O Clear
+#define UCB1_IO_CONF(x)	do{ }while(0)		///< USCI B1 I/O Configuration (no pins to configure)
+#define UCB1_IO_CLEAR()	do{ }while(0)		///< USCI B1 I/O Clear
+// DMA Trigger Sources (DMAxTSEL, numbered as on the FR5739 or, with USIM_F5XX_MAP, as on the F5510/F5342, see USIM_DMA_TRIG_BASE)
+#ifdef USIM_F5XX_MAP
+#define UCA0_DMA_RXTRIG		16	///< USCI A0 receive DMA trigger (UCA0RXIFG)
+#define UCA0_DMA_TXTRIG		17	///< USCI A0 transmit DMA trigger (UCA0TXIFG)
+#define UCB0_DMA_RXTRIG		18	///< USCI B0 receive DMA trigger (UCB0RXIFG)
+#define UCB0_DMA_TXTRIG		19	///< USCI B0 transmit DMA trigger (UCB0TXIFG)
+#define UCA1_DMA_RXTRIG		20	///< USCI A1 receive DMA trigger (UCA1RXIFG)
+#define UCA1_DMA_TXTRIG		21	///< USCI A1 transmit DMA trigger (UCA1TXIFG)
+#define UCB1_DMA_RXTRIG		22	///< USCI B1 receive DMA trigger (UCB1RXIFG)
+#define UCB1_DMA_TXTRIG		23	///< USCI B1 transmit DMA trigger (UCB1TXIFG)
+#else
+#define UCA0_DMA_RXTRIG		14	///< USCI A0 receive DMA trigger (UCA0RXIFG)
+#define UCA0_DMA_TXTRIG		15	///< USCI A0 transmit DMA trigger (UCA0TXIFG)
+#define UCA1_DMA_RXTRIG		16	///< USCI A1 receive DMA trigger (UCA1RXIFG)
+#define UCA1_DMA_TXTRIG		17	///< USCI A1 transmit DMA trigger (UCA1TXIFG)
+#define UCB0_DMA_RXTRIG		18	///< USCI B0 receive DMA trigger (UCB0RXIFG0)
+#define UCB0_DMA_TXTRIG		19	///< USCI B0 transmit DMA trigger (UCB0TXIFG0)
+#define UCB1_DMA_RXTRIG		20	///< USCI B1 receive DMA trigger (UCB1RXIFG0)
+#define UCB1_DMA_TXTRIG		21	///< USCI B1 transmit DMA trigger (UCB1TXIFG0)
+#endif // USIM_F5XX_MAP
+// UART RTS/CTS Flow Control Port (USE_UART_FLOW, simulated Port 1, see usciSimPortReg())
+#define USCI_FLOW_IN		P1IN	///< CTS input register
+#define USCI_FLOW_OUT		P1OUT	///< RTS output register
+#define USCI_FLOW_DIR		P1DIR	///< RTS/CTS direction register
+#define USCI_FLOW_IES		P1IES	///< CTS interrupt edge select register
+#define USCI_FLOW_IE		P1IE	///< CTS interrupt enable register
+#define USCI_FLOW_IFG		P1IFG	///< CTS interrupt flag register
+#define USCI_FLOW_SEL(pins)	do{ }while(0)	///< Select the GPIO function of the RTS/CTS pins (no pin functions to select)
+#define USCI_CTS_VECTOR		PORT1_VECTOR	///< CTS interrupt vector (owned by comm.c when USE_UART_FLOW)
+#endif // COMM_HAL
@@ -0,0 +1,2377 @@
+/******************************************************************************
+ * USCI module driver template
+ *
+ * One definition of the per-module driver (variables, conf/reset, read/write
+ * handlers and the module ISR) which comm.c includes once per enabled module.
+ * Before each inclusion comm.c defines the module to generate:
+ *
+ *	USCI_X		Register/function name part (A0, A1, B0 or B1)
+ *	USCI_x		Variable name part (a0, a1, b0 or b1)
+ *	USCI_UART	\
+ *	USCI_SPI	 > Endpoint mode of the module (exactly one)
+ *	USCI_I2C	/
+ *
+ * All names are resolved at compile time by token pasting, so every
+ * instantiation compiles to the same code as a hand-written copy for that
+ * module (e.g. UCxTXBUF is UCA0TXBUF and uartxWrite() is uartA0Write() for
+ * USCI_X A0). The parameters are undefined again at the end of this file.
+ *
+ * NOTE: This file is an internal part of comm.c, applications include comm.h
+ ******************************************************************************/
+#ifndef COMM_USCI_NAMES
+#define COMM_USCI_NAMES
+
+// Token pasting (two levels so that USCI_X/USCI_x are expanded first)
+#define USCI_CAT3_(a, b, c)	a##b##c
+#define USCI_CAT3(a, b, c)	USCI_CAT3_(a, b, c)
+#define UCX(name)		USCI_CAT3(UC, USCI_X, name)	///< Module register/macro name (UCA0##name)
+#define UCXV(name)		USCI_CAT3(uc, USCI_x, name)	///< Module variable name (uca0##name)
+#define UCXF(pre, post)		USCI_CAT3(pre, USCI_X, post)	///< Module function name (pre##A0##post)
+#define USCI_PRAGMA_(x)		_Pragma(#x)
+#define USCI_PRAGMA(x)		USCI_PRAGMA_(x)
+
+// Control word 1 is only present on the eUSCI (vs USCI) modules
+#if defined(UCA0CTLW1) || defined(UCB0CTLW1)
+#define USCI_HAS_CTLW1
+#endif // UCxxCTLW1
+
+// I2C interrupt vector values of the data flags (numbered per address slot on the eUSCI_B)
+#ifdef USCI_I2C_UCRXIFG0
+#define USCI_I2C_RXIV		USCI_I2C_UCRXIFG0
+#define USCI_I2C_TXIV		USCI_I2C_UCTXIFG0
+#define USCI_I2C_IVMAX		USCI_I2C_UCBIT9IFG
+#else
+#define USCI_I2C_RXIV		USCI_I2C_UCRXIFG
+#define USCI_I2C_TXIV		USCI_I2C_UCTXIFG
+#define USCI_I2C_IVMAX		USCI_I2C_UCTXIFG
+#endif // USCI_I2C_UCRXIFG0
+
+// Module registers
+#define UCxCTLW0		UCX(CTLW0)
+#define UCxCTLW1		UCX(CTLW1)
+#define UCxCTL1			UCX(CTL1)
+#define UCxBRW			UCX(BRW)
+#define UCxMCTLW		UCX(MCTLW)
+#define UCxABCTL		UCX(ABCTL)
+#define UCxSTAT			UCX(STAT)
+#define UCxTXBUF		UCX(TXBUF)
+#define UCxRXBUF		UCX(RXBUF)
+#define UCxIE			UCX(IE)
+#define UCxIFG			UCX(IFG)
+#define UCxI2CSA		UCX(I2CSA)
+#define UCxIV			UCX(IV)
+// Module macros (comm.h and HAL)
+#define UCx_INDEX		UCX(_INDEX)
+#define UCx_IO_CONF		UCX(_IO_CONF)
+#define UCx_IO_CLEAR		UCX(_IO_CLEAR)
+#define UCx_DMA_TXTRIG		UCX(_DMA_TXTRIG)
+#define UCx_DMA_RXTRIG		UCX(_DMA_RXTRIG)
+#define UCx_RXRING_SIZE		UCX(_RXRING_SIZE)
+#define UCx_IDLE_CCR		UCX(_IDLE_CCR)
+#define UCx_IDLE_CCTL		UCX(_IDLE_CCTL)
+#define UCx_RTS_PIN		UCX(_RTS_PIN)
+#define UCx_CTS_PIN		UCX(_CTS_PIN)
+#define UCx_VECTOR		USCI_CAT3(USCI_, USCI_X, _VECTOR)
+// Module variables
+#define ucxTxPtr		UCXV(TxPtr)
+#define ucxRxPtr		UCXV(RxPtr)
+#define ucxTxSize		UCXV(TxSize)
+#define ucxRxSize		UCXV(RxSize)
+#define ucxToRxSize		UCXV(ToRxSize)
+#define ucxTxSeg		UCXV(TxSeg)
+#define ucxTxSegLeft		UCXV(TxSegLeft)
+#define ucxRxSeg		UCXV(RxSeg)
+#define ucxRxSegLeft		UCXV(RxSegLeft)
+#define ucxRxSegSize		UCXV(RxSegSize)
+#define ucxRxRing		UCXV(RxRing)
+#define ucxRxHead		UCXV(RxHead)
+#define ucxRxTail		UCXV(RxTail)
+#define ucxRxOverflow		UCXV(RxOverflow)
+#define ucxRxDrop		UCXV(RxDrop)
+#define ucxRxDropAt		UCXV(RxDropAt)
+#define ucxRxSync		UCXV(RxSync)
+#define ucxTxNext		UCXV(TxNext)
+#define ucxTxStart		UCXV(TxStart)
+#define ucxTxPend		UCXV(TxPend)
+#define ucxTxSwitch		UCXV(TxSwitch)
+#define ucxDmaDone		UCXV(DmaDone)
+#define ucxFraming		UCXV(Framing)
+#define ucxFrmPtr		UCXV(FrmPtr)
+#define ucxFrmLen		UCXV(FrmLen)
+#define ucxFrmCode		UCXV(FrmCode)
+#define ucxFrmLeft		UCXV(FrmLeft)
+#define ucxFrmReady		UCXV(FrmReady)
+#define ucxFrmReadyLen		UCXV(FrmReadyLen)
+#define ucxFrmTxCode		UCXV(FrmTxCode)
+#define ucxFrmTxLeft		UCXV(FrmTxLeft)
+#define ucxFrameReset		UCXV(FrameReset)
+#define ucxFrameEnd		UCXV(FrameEnd)
+#define ucxFrameRx		UCXV(FrameRx)
+#define ucxCobsBlock		UCXV(CobsBlock)
+#define ucxFrameStart		UCXV(FrameStart)
+#define ucxFrameTx		UCXV(FrameTx)
+#define ucxFrmCrc		UCXV(FrmCrc)
+#define ucxCrcOn		UCXV(CrcOn)
+#define ucxTxCrc		UCXV(TxCrc)
+#define ucxRxCrc		UCXV(RxCrc)
+#define ucxIdleTicks		UCXV(IdleTicks)
+#define ucxRxIdle		UCXV(RxIdle)
+#define ucxIdleDone		UCXV(IdleDone)
+#define ucxFlow			UCXV(Flow)
+#define ucxTxHeld		UCXV(TxHeld)
+#define ucxCtsPause		UCXV(CtsPause)
+#define ucxCtsResume		UCXV(CtsResume)
+#define ucxRtsGo		UCXV(RtsGo)
+#define ucxAutoBaud		UCXV(AutoBaud)
+#define ucxBaudLock		UCXV(BaudLock)
+#define ucxBaudDetect		UCXV(BaudDetect)
+#define ucxStrBuf		UCXV(StrBuf)
+#define ucxStrFill		UCXV(StrFill)
+#define ucxStrPend		UCXV(StrPend)
+#define ucxStrStop		UCXV(StrStop)
+#define ucxStrReady		UCXV(StrReady)
+#define ucxStrDrops		UCXV(StrDrops)
+#define ucxStreamRx		UCXV(StreamRx)
+#define ucxRelease		UCXV(Release)
+#define ucxSwapDone		UCXV(SwapDone)
+// Module functions
+#define confUCx			UCXF(confUC, )
+#define resetUCx		UCXF(resetUC, )
+#define getUCxRxSize		UCXF(getUC, RxSize)
+#define getUCxStat		UCXF(getUC, Stat)
+#define getUCxTxCrc		UCXF(getUC, TxCrc)
+#define getUCxRxCrc		UCXF(getUC, RxCrc)
+#define setUCxBaud		UCXF(setUC, Baud)
+#define waitUCx			UCXF(waitUC, )
+#define getUCxRxOverflow	UCXF(getUC, RxOverflow)
+#define uartxWrite		UCXF(uart, Write)
+#define uartxRead		UCXF(uart, Read)
+#define uartxWriteV		UCXF(uart, WriteV)
+#define uartxGetFrame		UCXF(uart, GetFrame)
+#define uartxReleaseFrame	UCXF(uart, ReleaseFrame)
+#define uartxRxIdle		UCXF(uart, RxIdle)
+#define uartxWaitIdle		UCXF(uart, WaitIdle)
+#define uartxBaudLocked		UCXF(uart, BaudLocked)
+#define spixWrite		UCXF(spi, Write)
+#define spixRead		UCXF(spi, Read)
+#define spixTransfer		UCXF(spi, Transfer)
+#define spixSwap		UCXF(spi, Swap)
+#define spixWriteV		UCXF(spi, WriteV)
+#define spixReadV		UCXF(spi, ReadV)
+#define spixRegRead		UCXF(spi, RegRead)
+#define spixRegWrite		UCXF(spi, RegWrite)
+#define spixStream		UCXF(spi, Stream)
+#define spixStreamGet		UCXF(spi, StreamGet)
+#define spixStreamRelease	UCXF(spi, StreamRelease)
+#define spixStreamStop		UCXF(spi, StreamStop)
+#define getUCxStreamDrops	UCXF(getUC, StreamDrops)
+#define i2cxWrite		UCXF(i2c, Write)
+#define i2cxRead		UCXF(i2c, Read)
+#define i2cxTransfer		UCXF(i2c, Transfer)
+#define i2cxSlavePresent	UCXF(i2c, SlavePresent)
+#define i2cxRegRead		UCXF(i2c, RegRead)
+#define i2cxRegWrite		UCXF(i2c, RegWrite)
+#define ucxReg			UCXV(Reg)
+#define ucxI2cStartRx		UCXV(I2cStartRx)
+#define uscixIsr		UCXF(usci, Isr)
+// Streaming CRC of the data bytes (apps with USCI_OPT_CRC)
+#ifdef USE_USCI_CRC
+#define UCx_TXCRC(byte)		do{ if(ucxCrcOn) USCI_CRC(ucxTxCrc, byte); }while(0)	///< Add a byte sent to the TX CRC
+#define UCx_TXCRC_MAIN(byte)	do{ if(ucxCrcOn){ unsigned int crcSr; enter_critical(crcSr); USCI_CRC(ucxTxCrc, byte); exit_critical(crcSr); } }while(0)	///< UCx_TXCRC() from main context (CRC16 module shared with the other module ISRs)
+#define UCx_RXCRC(byte)		do{ if(ucxCrcOn) USCI_CRC(ucxRxCrc, byte); }while(0)	///< Add a byte received to the RX CRC
+#else
+#define UCx_TXCRC(byte)	do{ }while(0)	///< No streaming CRC
+#define UCx_TXCRC_MAIN(byte)	do{ }while(0)	///< No streaming CRC
+#define UCx_RXCRC(byte)	do{ }while(0)	///< No streaming CRC
+#endif // USE_USCI_CRC
+#endif // COMM_USCI_NAMES
+
+#if defined(USCI_UART) + defined(USCI_SPI) + defined(USCI_I2C) != 1
+#error comm_usci.h: define exactly one of USCI_UART, USCI_SPI or USCI_I2C
+#endif // USCI mode check
+#if defined(USCI_UART) && defined(USE_UART_RXRING)
+#define USCI_RXRING		///< UART receive ring active for this module
+#endif // USCI_UART && USE_UART_RXRING
+#if defined(USCI_UART) && defined(USE_USCI_FRAMING)
+#define USCI_FRAMING		///< UART packet framing available for this module
+#endif // USCI_UART && USE_USCI_FRAMING
+#if defined(USCI_UART) && defined(USE_UART_IDLE)
+#define USCI_IDLE		///< UART idle-line timeout available for this module
+#endif // USCI_UART && USE_UART_IDLE
+#if defined(USCI_UART) && defined(USE_UART_FLOW)
+#define USCI_FLOW		///< UART RTS/CTS flow control available for this module
+#endif // USCI_UART && USE_UART_FLOW
+#if defined(USCI_UART) && defined(USE_UART_AUTOBAUD)
+#define USCI_AUTOBAUD		///< UART automatic baud rate detection available for this module
+#endif // USCI_UART && USE_UART_AUTOBAUD
+#if defined(USCI_SPI) && defined(USE_SPI_STREAM)
+#define USCI_STREAM		///< SPI streaming read available for this module
+#endif // USCI_SPI && USE_SPI_STREAM
+
+/****************************************************************
+ * USCI Module Variable Declarations
+ ***************************************************************/
+unsigned char *ucxTxPtr;			///< USCI TX Data Pointer
+unsigned char *ucxRxPtr;			///< USCI RX Data Pointer
+unsigned int ucxTxSize = 0;			///< USCI TX Size
+unsigned int ucxRxSize = 0;			///< USCI RX Size
+#ifndef USCI_UART
+unsigned int ucxToRxSize = 0;			///< USCI to-RX Size (used for SPI/I2C RX)
+#endif // USCI_UART
+#if defined(USE_USCI_REGS) && defined(USCI_I2C)
+unsigned char ucxReg;				///< USCI register address of the running register access (sent by the ISR)
+#endif // USE_USCI_REGS && USCI_I2C
+#ifdef USE_USCI_IOVEC
+const usciSegment *ucxTxSeg;			///< USCI next TX segment (gather write)
+unsigned char ucxTxSegLeft = 0;			///< USCI TX segments left after the current one
+#ifndef USCI_UART
+const usciSegment *ucxRxSeg;			///< USCI next RX segment (scatter read)
+unsigned char ucxRxSegLeft = 0;			///< USCI RX segments left after the current one
+unsigned int ucxRxSegSize = 0;			///< USCI bytes left in the current RX segment
+#endif // USCI_UART
+#endif // USE_USCI_IOVEC
+#ifdef USCI_RXRING
+unsigned char ucxRxRing[UCx_RXRING_SIZE];	///< USCI UART receive ring
+volatile unsigned int ucxRxHead = 0;		///< USCI receive ring head (free running, written by the ISR only)
+volatile unsigned int ucxRxTail = 0;		///< USCI receive ring tail (free running, written by uartxRead() only)
+volatile unsigned int ucxRxOverflow = 0;	///< USCI bytes dropped on a full receive ring
+volatile unsigned int ucxRxDropAt = 0;		///< USCI receive ring head at the last app switch (unread bytes up to it are dropped)
+volatile unsigned char ucxRxDrop = 0;		///< USCI receive ring drop requested by confUCx() (applied by the reader, see ucxRxSync())
+#endif // USCI_RXRING
+#if defined(USE_USCI_TXQUEUE) && !defined(USCI_I2C)
+usciTxDesc ucxTxPend;				///< USCI queued write of another app waiting for the last byte to be sent
+volatile unsigned char ucxTxSwitch = 0;		///< USCI app switch pending until the last byte is sent (see ucxTxNext())
+#endif // USE_USCI_TXQUEUE && !USCI_I2C
+#ifdef USCI_FRAMING
+unsigned int ucxFraming = 0;			///< USCI framing of the configured app (USCI_OPT_COBS, USCI_OPT_SLIP or 0)
+unsigned char *ucxFrmPtr;			///< USCI frame being decoded (one half of the app receive buffer)
+unsigned int ucxFrmLen = 0;			///< USCI decoded length of the frame (USCI_FRAME_MAX + 1: dropping until the delimiter)
+unsigned char ucxFrmCode = 0;			///< USCI COBS code of the block being decoded (0 at frame start) / SLIP escape received
+unsigned char ucxFrmLeft = 0;			///< USCI COBS bytes left in the block being decoded
+unsigned char * volatile ucxFrmReady = 0;	///< USCI frame handed to the app (0 when none, written by the ISR only when 0)
+unsigned int ucxFrmReadyLen = 0;		///< USCI length of the frame handed to the app
+unsigned char ucxFrmTxCode = 0;			///< USCI COBS code of the block being sent / SLIP escaped byte pending
+unsigned char ucxFrmTxLeft = 0;			///< USCI COBS bytes left in the block being sent / SLIP closing END pending
+#endif // USCI_FRAMING
+#ifdef USE_USCI_CRC
+unsigned char ucxCrcOn = 0;			///< USCI streaming CRC enabled for the configured app (USCI_OPT_CRC)
+unsigned int ucxTxCrc = USCI_CRC_SEED;		///< USCI CRC of the data sent since the transfer start
+unsigned int ucxRxCrc = USCI_CRC_SEED;		///< USCI CRC of the data received since the transfer start (UART: restart or frame start)
+#ifdef USCI_FRAMING
+unsigned int ucxFrmCrc = USCI_CRC_SEED;		///< USCI CRC of the frame handed to the app
+#endif // USCI_FRAMING
+#endif // USE_USCI_CRC
+#ifdef USCI_IDLE
+unsigned int ucxIdleTicks = 0;			///< USCI idle-line timeout of the configured app in USCI_IDLE_TIMER ticks (0 for none)
+volatile unsigned char ucxRxIdle = 0;		///< USCI line went idle after the last byte received (end of message not yet collected)
+#endif // USCI_IDLE
+#ifdef USCI_FLOW
+unsigned char ucxFlow = 0;			///< USCI RTS/CTS flow control enabled for the configured app (USCI_OPT_RTSCTS)
+unsigned char ucxTxHeld = 0;			///< USCI first byte of the write held back by CTS (sent by ucxCtsResume())
+#endif // USCI_FLOW
+#ifdef USCI_AUTOBAUD
+unsigned char ucxAutoBaud = 0;			///< USCI automatic baud rate detection enabled for the configured app (USCI_OPT_AUTOBAUD)
+volatile unsigned char ucxBaudLock = 0;		///< USCI baud rate measured since the last uartxBaudLocked() call
+#endif // USCI_AUTOBAUD
+#ifdef USCI_STREAM
+unsigned char *ucxStrBuf[2];			///< USCI stream ping-pong block buffers
+unsigned char ucxStrFill = 0;			///< USCI stream buffer being filled (0 or 1)
+unsigned char ucxStrPend = 0;			///< USCI stream bytes written to TXBUF and not yet received (up to 2)
+volatile unsigned char ucxStrStop = 0;		///< USCI stream stop requested (no more bytes clocked)
+unsigned char * volatile ucxStrReady = 0;	///< USCI stream block handed to the app (0 when none, written by the ISR only when 0)
+unsigned int ucxStrDrops = 0;			///< USCI stream blocks dropped because the previous one was not released
+#endif // USCI_STREAM
+#if defined(USE_USCI_LPM) && defined(USCI_SPI)
+volatile unsigned char ucxSwapDone = 0;		///< USCI spixSwap() byte received (set by the RX ISR)
+#endif // USE_USCI_LPM && USCI_SPI
+
+#ifdef USCI_FRAMING
+static void ucxFrameReset(void);
+#endif // USCI_FRAMING
+#ifdef USCI_STREAM
+static void ucxStreamRx(void);
+#endif // USCI_STREAM
+#if defined(USE_USCI_TXQUEUE) && !defined(USCI_I2C)
+static void ucxTxNext(void);
+static void ucxTxStart(void);
+#define UCx_TX_NEXT()	ucxTxNext()		///< Start the next queued write (end of transfer)
+#else
+#define UCx_TX_NEXT()	do{ }while(0)	///< No transmit queue
+#endif // USE_USCI_TXQUEUE
+#if defined(USE_USCI_TXQUEUE) && defined(USCI_UART)
+#define UCx_TXCPT_CLEAR()	(UCxIFG &= ~UCTXCPTIFG)	///< Restart the transmit complete detection (TXBUF loaded, see ucxTxNext())
+#define UCx_TX_SENDING()	(!(UCxIFG & UCTXCPTIFG))	///< Last byte of the write not yet sent
+#define UCx_TX_SWITCH_ARM()	(UCxIE |= UCTXCPTIE)	///< Start the queued write of another app on transmit complete
+#define UCx_TX_SWITCH_SYNC()	do{ }while(0)	///< (UCTXCPTIFG only set by the last byte)
+#else
+#define UCx_TXCPT_CLEAR()	do{ }while(0)	///< No transmit complete detection
+#define UCx_TX_SENDING()	(UCxSTAT & UCBUSY)	///< Last byte of the write not yet sent (SPI: transmit and receive shift together)
+#define UCx_TX_SWITCH_ARM()	do{ }while(0)	///< Started by the receive interrupt of the last byte
+#define UCx_TX_SWITCH_SYNC()	(UCxIFG &= ~UCRXIFG)	///< Drop the receive flag of the byte before the last one (the next one is the last byte)
+#endif // USE_USCI_TXQUEUE && USCI_UART
+#ifdef USCI_IDLE
+#define UCx_IDLE_RESTART()	do{ if(ucxIdleTicks){ UCx_IDLE_CCR = USCI_IDLE_TIMER + ucxIdleTicks; UCx_IDLE_CCTL = CCIE; ucxRxIdle = 0; } }while(0)	///< (Re)start the idle timeout from the byte received
+#else
+#define UCx_IDLE_RESTART()	do{ }while(0)	///< No idle-line timeout
+#endif // USCI_IDLE
+#if defined(USE_USCI_CRC) && defined(USCI_UART)
+#define UCx_CRC_START()	(ucxTxCrc = USCI_CRC_SEED)	///< Restart the TX CRC (UART receive is a stream, see getUCxRxCrc())
+#elif defined(USE_USCI_CRC)
+#define UCx_CRC_START()	(ucxTxCrc = ucxRxCrc = USCI_CRC_SEED)	///< Restart the CRCs of the transfer
+#else
+#define UCx_CRC_START()	do{ }while(0)	///< No streaming CRC
+#endif // USE_USCI_CRC
+#ifdef USCI_FLOW
+static unsigned char ucxCtsPause(unsigned char held);
+static void ucxRtsGo(void);
+#ifdef USCI_RXRING
+#define UCx_RX_UNREAD		(ucxRxHead - ucxRxTail)	///< Received bytes not yet read
+#else
+#define UCx_RX_UNREAD		ucxRxSize		///< Received bytes not yet read
+#endif // USCI_RXRING
+#ifdef USE_USCI_IOVEC
+#define UCx_TX_MORE		(ucxTxSize || ucxTxSegLeft)	///< Bytes of the write left to send
+#else
+#define UCx_TX_MORE		ucxTxSize		///< Bytes of the write left to send
+#endif // USE_USCI_IOVEC
+#define UCx_TX_PENDING()	(UCxIFG & UCxIE & UCTXIFG)	///< TX interrupt to serve (masked while paused by CTS)
+#define UCx_CTS_HOLD(first)	(ucxFlow && ucxCtsPause(first))	///< Pause the write while the peer deasserts CTS
+#define UCx_RX_THROTTLE()	do{ if(ucxFlow && UCx_RX_UNREAD >= UART_RTS_STOP) USCI_FLOW_OUT |= UCx_RTS_PIN; }while(0)	///< Deassert RTS at the high watermark
+#define UCx_RX_RELEASE()	do{ if(ucxFlow) ucxRtsGo(); }while(0)	///< Assert RTS again at the low watermark
+#else
+#define UCx_TX_PENDING()	(UCxIFG & UCTXIFG)	///< TX interrupt to serve
+#define UCx_CTS_HOLD(first)	0			///< No flow control
+#define UCx_RX_THROTTLE()	do{ }while(0)	///< No flow control
+#define UCx_RX_RELEASE()	do{ }while(0)	///< No flow control
+#endif // USCI_FLOW
+#ifdef USCI_AUTOBAUD
+#define UCx_CTLW0_IMAGE(conf)	(((conf)->usciCtlW0 & ~UCSWRST) | ((conf)->opts & USCI_OPT_AUTOBAUD ? UCBRKIE : 0))	///< Control word 0 of an app (break interrupt of auto-baud apps)
+#else
+#define UCx_CTLW0_IMAGE(conf)	((conf)->usciCtlW0 & ~UCSWRST)	///< Control word 0 of an app
+#endif // USCI_AUTOBAUD
+
+/**************************************************************
+ * General Purpose USCI Functions
+ *************************************************************/
+/**************************************************************************//**
+ * \brief	Configures the USCI module for operation
+ *
+ * Write control registers and clear system variables for the
+ * USCI module in its (compile time) endpoint mode.
+ *
+ * NOTE: This config function is already called before any read/write function call
+ * and therefore should (in almost all cases) never be called by the user.
+ *
+ * Switching from another app only writes the registers whose values differ
+ * between the two configs, holding the module in software reset only if any
+ * does (e.g. two SPI devices sharing the mode and clock skip the reset). The
+ * pins, set up by mode only, are cleared and set up again only after a
+ * release (unregisterComm(), setUCxBaud()).
+ *
+ * \param	commID	The communication ID for the registered app
+ ******************************************************************************/
+void confUCx(unsigned int commID)
+{
+	USCI_CONF_CONST usciConfig *conf;
+	USCI_CONF_CONST usciConfig *prev = 0;
+	unsigned int prevID = devConf[UCx_INDEX];
+	unsigned int ctlw0;
+	unsigned int brw;
+	unsigned int status;
+
+	if(prevID == commID) return;				// Check if device is already configured
+	if(!USCI_ID_OK(commID)) return;				// Check the comm ID
+	conf = USCI_DEV(commID);
+	if(prevID) prev = USCI_DEV(prevID);			// Module set up for another app: write the differences
+	ctlw0 = UCx_CTLW0_IMAGE(conf);
+	brw = USCI_BRW(commID);
+	USCI_STAT(UCx_INDEX, commID, reconf, 1);
+	enter_critical(status);					// Perform config in critical section
+#ifdef USCI_AUTOBAUD
+	ucxAutoBaud = (conf->opts & USCI_OPT_AUTOBAUD) != 0;
+	ucxBaudLock = 0;
+#endif // USCI_AUTOBAUD
+
+	// Configure key control words (plain writes of the config register images)
+	if(!prev || ctlw0 != UCx_CTLW0_IMAGE(prev) || brw != USCI_BRW(prevID)
+#ifdef USCI_HAS_CTLW1
+		|| conf->usciCtlW1 != prev->usciCtlW1
+#endif // USCI_HAS_CTLW1
+#ifdef USCI_UART
+		|| USCI_MCTLW(commID) != USCI_MCTLW(prevID)
+#endif // USCI_UART
+		){
+		UCxCTLW0 = ctlw0 | UCSWRST;			// Assert USCI software reset with the new control word
+		if(!prev){ UCx_IO_CLEAR(); }			// Clear I/O for configuration
+#ifdef USCI_HAS_CTLW1
+		if(!prev || conf->usciCtlW1 != prev->usciCtlW1) UCxCTLW1 = conf->usciCtlW1;
+#endif // USCI_HAS_CTLW1
+		if(!prev || brw != USCI_BRW(prevID)) UCxBRW = brw;
+#ifdef USCI_UART
+		if(!prev || USCI_MCTLW(commID) != USCI_MCTLW(prevID)) UCxMCTLW = USCI_MCTLW(commID);	// Baud rate modulation (UART only)
+#endif // USCI_UART
+#ifdef USCI_AUTOBAUD
+		UCxABCTL = ucxAutoBaud ? UCABDEN : 0;		// Measure the sync field following a break (break interrupts the sync byte)
+#endif // USCI_AUTOBAUD
+		if(!prev){ UCx_IO_CONF(conf->rAddr & ADDR_MASK); }	// Port set up
+		UCxCTLW0 = ctlw0;				// Resume operation (clear software reset)
+	}
+	ucxRxPtr = conf->rxPtr;
+
+	// Clear buffer sizes
+	ucxRxSize = 0;
+	ucxTxSize = 0;
+#ifdef USE_USCI_IOVEC
+	ucxTxSegLeft = 0;
+#ifndef USCI_UART
+	ucxRxSegLeft = 0;
+#endif // USCI_UART
+#endif // USE_USCI_IOVEC
+#ifdef USCI_RXRING
+	ucxRxDropAt = ucxRxHead;				// Drop unread ring contents (applied by the reader, confUCx() may run in the ISR)
+	ucxRxDrop = 1;
+#endif // USCI_RXRING
+#ifdef USCI_FRAMING
+	ucxFraming = conf->opts & USCI_OPT_FRAMING;
+	ucxFrameReset();
+#endif // USCI_FRAMING
+#ifdef USE_USCI_CRC
+	ucxCrcOn = (conf->opts & USCI_OPT_CRC) != 0;
+	ucxTxCrc = USCI_CRC_SEED;
+	ucxRxCrc = USCI_CRC_SEED;
+#endif // USE_USCI_CRC
+#ifdef USCI_IDLE
+	UCx_IDLE_CCTL = 0;					// Cancel the idle timeout of the previous app
+	ucxIdleTicks = devIdle[USCI_SLOT(commID)];		// Precomputed for the current rate of the app
+	ucxRxIdle = 0;
+	if(ucxIdleTicks) USCI_IDLE_TIMER_INIT();
+#endif // USCI_IDLE
+#ifdef USCI_FLOW
+	USCI_FLOW_IE &= ~UCx_CTS_PIN;				// Cancel a CTS wait of the previous app
+	ucxTxHeld = 0;
+	ucxFlow = (conf->opts & (USCI_OPT_RTSCTS + USCI_OPT_FRAMING)) == USCI_OPT_RTSCTS;
+	if(ucxFlow){						// RTS output (asserted low), CTS input
+		USCI_FLOW_SEL(UCx_RTS_PIN + UCx_CTS_PIN);
+		USCI_FLOW_OUT &= ~UCx_RTS_PIN;
+		USCI_FLOW_DIR = (USCI_FLOW_DIR | UCx_RTS_PIN) & ~UCx_CTS_PIN;
+		USCI_FLOW_IES |= UCx_CTS_PIN;			// CTS ready edge: high to low
+	}
+#endif // USCI_FLOW
+#ifndef USCI_UART
+	ucxToRxSize = 0;
+#endif // USCI_UART
+
+#ifdef USCI_I2C
+	if(!prev || ((conf->rAddr ^ prev->rAddr) & ADDR_MASK)) UCxI2CSA = conf->rAddr & ADDR_MASK;	// Set up the slave address
+#endif // USCI_I2C
+
+#ifdef USCI_I2C
+	UCxIE = UCRXIE + UCTXIE + UCNACKIE + UCSTPIE;		// Enable Interrupts (and the slave NACK/stop condition ones, a reset cleared the others)
+#else
+	UCxIE = UCRXIE + UCTXIE;				// Enable Interrupts (a reset cleared the others)
+#endif // USCI_I2C
+
+	devConf[UCx_INDEX] = commID;				// Store config
+	exit_critical(status);					// End critical section
+}
+/**************************************************************************//**
+ * \brief	Resets the USCI module without writing over control regs
+ *
+ * This function is included to soft-reset the USCI module
+ * management variables without clearing the current config.
+ *
+ * \param	commID	The comm ID of the registered app
+ * \sideeffect	Sets the RX pointer to that registered w/ commID
+ ******************************************************************************/
+void resetUCx(unsigned int commID){
+	if(!USCI_ID_OK(commID)) return;				// Check the comm ID
+	ucxRxPtr = USCI_DEV(commID)->rxPtr;
+	ucxRxSize = 0;
+	ucxTxSize = 0;
+#ifdef USE_USCI_IOVEC
+	ucxTxSegLeft = 0;
+#ifndef USCI_UART
+	ucxRxSegLeft = 0;
+#endif // USCI_UART
+#endif // USE_USCI_IOVEC
+#ifdef USCI_RXRING
+	ucxRxTail = ucxRxHead;					// Drop unread ring contents (consumer side only)
+	ucxRxDrop = 0;
+#endif // USCI_RXRING
+#ifdef USCI_FRAMING
+	ucxFrameReset();
+#endif // USCI_FRAMING
+#ifdef USCI_FLOW
+	if(ucxFlow){						// Drop a CTS wait, RTS asserted (buffer empty)
+		USCI_FLOW_IE &= ~UCx_CTS_PIN;
+		ucxTxHeld = 0;
+		UCxIE |= UCTXIE;
+		USCI_FLOW_OUT &= ~UCx_RTS_PIN;
+	}
+#endif // USCI_FLOW
+#ifndef USCI_UART
+	ucxToRxSize = 0;
+#endif // USCI_UART
+#ifdef USE_USCI_DMA
+	if(dmaOwner == UCx_INDEX){		// Abort a running DMA transfer
+		dmaStop();
+		UCxIE |= UCRXIE + UCTXIE;
+	}
+#endif // USE_USCI_DMA
+#ifdef USE_USCI_TXQUEUE
+	txqCount[UCx_INDEX] = 0;		// Drop queued writes
+#ifndef USCI_I2C
+	ucxTxSwitch = 0;			// (and a write waiting for the app switch)
+#endif // USCI_I2C
+#ifdef USCI_UART
+	UCxIE &= ~UCTXCPTIE;
+#endif // USCI_UART
+#endif // USE_USCI_TXQUEUE
+#ifdef USCI_STREAM
+	if(usciStat[UCx_INDEX] == STREAM) UCxIE |= UCTXIE;	// Abort a running stream (bytes in flight dropped by the ISR)
+	ucxStrReady = 0;
+#endif // USCI_STREAM
+	usciStat[UCx_INDEX] = OPEN;
+	return;
+}
+/**************************************************************************//**
+ * \brief	Stops the USCI module for an app being unregistered
+ *
+ * Called by unregisterComm() (critical section, module OPEN) when the app is
+ * the configured one. The module stays in software reset, with its
+ * interrupts and pins released, until confUCx() configures the next app.
+ ******************************************************************************/
+static void ucxRelease(void)
+{
+	UCxCTL1 |= UCSWRST;					// Assert USCI software reset (clears UCxIE)
+	UCx_IO_CLEAR();
+#ifdef USCI_IDLE
+	UCx_IDLE_CCTL = 0;					// Cancel the idle timeout
+#endif // USCI_IDLE
+#ifdef USCI_FLOW
+	USCI_FLOW_IE &= ~UCx_CTS_PIN;				// Cancel a CTS wait
+	ucxTxHeld = 0;
+#endif // USCI_FLOW
+	devConf[UCx_INDEX] = 0;
+}
+#ifdef USCI_RXRING
+/**************************************************************************//**
+ * \brief	Applies a receive ring drop requested by confUCx()
+ *
+ * Reader side only: the tail moves forward to the ring head recorded at the
+ * app switch, so confUCx() (possibly run by the ISR for a queued write) never
+ * writes the tail itself.
+ *
+ * \return	The ring tail
+ ******************************************************************************/
+static unsigned int ucxRxSync(void)
+{
+	unsigned int tail = ucxRxTail;
+
+	if(ucxRxDrop){
+		ucxRxDrop = 0;				// (Cleared first: a drop requested meanwhile is applied next time)
+		if((int)(ucxRxDropAt - tail) > 0) tail = ucxRxDropAt;
+		ucxRxTail = tail;
+	}
+	return tail;
+}
+#endif // USCI_RXRING
+/**************************************************************************//**
+ * \brief	Get method for the USCI RX buffer size
+ *
+ * Returns the number of bytes which have been written
+ * to the RX pointer (since the last read performed).
+ *
+ * \return	The number of valid bytes following the rxPtr.
+ ******************************************************************************/
+unsigned int getUCxRxSize(void){
+#ifdef USCI_RXRING
+	return ucxRxHead - ucxRxSync();
+#else
+	return ucxRxSize;
+#endif // USCI_RXRING
+}
+/**************************************************************************//**
+ * \brief	Get method for the USCI status
+ *
+ * Returns the status of the USCI module, either OPEN, TX, or RX
+ *
+ * \retval	0	Indicates the OPEN status
+ * \retval 	1	Indicates the TX Status
+ * \retval 	2	Indicates the RX Status
+ ******************************************************************************/
+unsigned char getUCxStat(void){
+	return usciStat[UCx_INDEX];
+}
+#ifdef USE_USCI_CRC
+/**************************************************************************//**
+ * \brief	Get method for the CRC of the data sent by the USCI module
+ *
+ * \return	The CRC-16-CCITT of the data bytes of the last transfer (running
+ * 		while the transfer is in progress, register addresses, dummy and
+ * 		framing bytes excluded), USCI_CRC_SEED for apps without
+ * 		USCI_OPT_CRC
+ ******************************************************************************/
+unsigned int getUCxTxCrc(void){
+	return ucxTxCrc;
+}
+/**************************************************************************//**
+ * \brief	Get method for the CRC of the data received by the USCI module
+ *
+ * SPI/I2C: CRC of the data bytes of the last read or transfer. UART: CRC of
+ * the bytes received since the last restart (bytes received, not bytes
+ * read), or for a framed app CRC of the frame from uartxGetFrame(). A frame
+ * or read including its own (big endian) CCITT CRC checks to 0.
+ *
+ * \param	restart	Non-zero to restart the UART receive CRC after the read
+ * \return	The CRC-16-CCITT of the received data
+ ******************************************************************************/
+unsigned int getUCxRxCrc(unsigned char restart){
+	unsigned int status;
+	unsigned int crc;
+
+#ifdef USCI_FRAMING
+	if(ucxFraming) return ucxFrmCrc;
+#endif // USCI_FRAMING
+	enter_critical(status);
+	crc = ucxRxCrc;
+	if(restart) ucxRxCrc = USCI_CRC_SEED;
+	exit_critical(status);
+	return crc;
+}
+#endif // USE_USCI_CRC
+
+/*************************************************************************//**
+ * \brief	Set method for the USCI Baud Rate Divisor
+ *
+ * Sets the baud rate divisor of the USCI module, this divisor is generally
+ * performed relative to the SMCLK rate of the system. The UART modulation
+ * (mctlw) of the config is kept, update it as well for a modulated baud rate.
+ *
+ * \param 	baudDiv	The new divisor to apply
+ * \param	commID	The communications ID number of the application
+ *****************************************************************************/
+void setUCxBaud(unsigned int baudDiv, unsigned int commID){
+	if(!USCI_ID_OK(commID)) return;	// Check the comm ID
+	USCI_BRW(commID) = baudDiv;		// Replace the baud divisor in memory
+#ifdef USE_UART_IDLE
+	devIdle[USCI_SLOT(commID)] = idleTicks(commID);
+#endif // USE_UART_IDLE
+	devConf[UCx_INDEX] = 0;		// Reset the device config storage (config will be performed on next read/write)
+	return;
+}
+
+#ifdef USE_USCI_LPM
+/**************************************************************************//**
+ * \brief	Low power wait for the end of the USCI transfer
+ *
+ * Blocks until the module status returns to OPEN (queued writes included),
+ * sleeping in USCI_LPM_BITS meanwhile. The ISR (or DMA ISR) ending the
+ * transfer clears the LPM bits on exit, so the CPU runs only for the ISRs.
+ * Interrupts are enabled while sleeping and restored on return.
+ ******************************************************************************/
+void waitUCx(void)
+{
+	unsigned int status;
+
+	enter_critical(status);
+	usciWait[UCx_INDEX] = 1;
+	while(usciStat[UCx_INDEX] != OPEN){
+		__bis_SR_register(USCI_LPM_BITS + GIE);	// Sleep (GIE set with the LPM bits, so the wake-up cannot be missed)
+		_disable_interrupts();
+	}
+	usciWait[UCx_INDEX] = 0;
+	exit_critical(status);
+}
+#endif // USE_USCI_LPM
+
+/***************************************************************
+ * UART HANDLERS
+ **************************************************************/
+#ifdef USCI_UART
+#ifdef USCI_FRAMING
+/**************************************************************************//**
+ * \brief	Resets the frame decoder and encoder of the USCI module
+ *
+ * Decoding restarts in the first half of the app receive buffer (ucxRxPtr),
+ * a frame not yet released is dropped.
+ ******************************************************************************/
+static void ucxFrameReset(void)
+{
+	ucxFrmPtr = ucxRxPtr;
+	ucxFrmLen = 0;
+	ucxFrmCode = 0;
+	ucxFrmLeft = 0;
+	ucxFrmReady = 0;
+	ucxFrmTxCode = 0;
+	ucxFrmTxLeft = 0;
+}
+/**************************************************************************//**
+ * \brief	Ends the frame being decoded (delimiter received)
+ *
+ * A complete frame is handed to the app (ucxFrmReady) if the previous one
+ * has been released, decoding then moves on to the other half of the app
+ * receive buffer. Empty frames (back-to-back delimiters) are skipped.
+ ******************************************************************************/
+static void ucxFrameEnd(void)
+{
+	unsigned int len = ucxFrmLen;
+
+	if(len <= USCI_FRAME_MAX){			// (Frames too long were reported when dropped)
+		if(ucxFrmLeft || (len && ucxFrmReady)){	// Truncated COBS block or app still holding the previous frame
+			USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxErrors, 1);
+			USCI_ERROR(UCx_INDEX, USCI_ERR_FRAME);
+		}
+		else if(len){
+			ucxFrmReadyLen = len;
+#ifdef USE_USCI_CRC
+			ucxFrmCrc = ucxRxCrc;
+#endif // USE_USCI_CRC
+			ucxFrmReady = ucxFrmPtr;	// Publish the frame (length first)
+			ucxFrmPtr = (ucxFrmPtr == ucxRxPtr) ? ucxRxPtr + USCI_FRAME_MAX : ucxRxPtr;
+			USCI_EVENT(UCx_INDEX, onRxDone);
+		}
+	}
+	ucxFrmLen = 0;
+	ucxFrmCode = 0;
+	ucxFrmLeft = 0;
+#ifdef USE_USCI_CRC
+	ucxRxCrc = USCI_CRC_SEED;			// Next frame
+#endif // USE_USCI_CRC
+}
+/**************************************************************************//**
+ * \brief	Decodes a received byte of a framed app
+ *
+ * Called by the RX ISR for each byte, the payload is decoded in place into
+ * the app receive buffer so the frame is handed over without any copy. A
+ * frame longer than USCI_FRAME_MAX is dropped up to its delimiter.
+ *
+ * \param	byte	The byte read from RXBUF
+ ******************************************************************************/
+static void ucxFrameRx(unsigned char byte)
+{
+	unsigned char prev;
+
+	if(ucxFraming == USCI_OPT_COBS){
+		if(!byte){					// Delimiter
+			ucxFrameEnd();
+			return;
+		}
+		if(ucxFrmLeft) ucxFrmLeft--;			// Data byte of the block
+		else{						// Code byte of the next block
+			prev = ucxFrmCode;
+			ucxFrmCode = byte;
+			ucxFrmLeft = byte - 1;
+			if(!prev || prev == 0xFF) return;	// First block, or the previous one was full (no zero)
+			byte = 0;				// The previous block ended with a zero
+		}
+	}
+	else{
+		if(byte == SLIP_END){				// Delimiter
+			ucxFrameEnd();
+			return;
+		}
+		if(byte == SLIP_ESC){
+			ucxFrmCode = 1;
+			return;
+		}
+		if(ucxFrmCode){					// Escaped byte (others passed on as received, RFC 1055)
+			ucxFrmCode = 0;
+			if(byte == SLIP_ESC_END) byte = SLIP_END;
+			else if(byte == SLIP_ESC_ESC) byte = SLIP_ESC;
+		}
+	}
+	if(ucxFrmLen < USCI_FRAME_MAX){
+		ucxFrmPtr[ucxFrmLen++] = byte;
+		UCx_RXCRC(byte);
+	}
+	else if(ucxFrmLen == USCI_FRAME_MAX){		// Frame too long: drop it up to the delimiter
+		ucxFrmLen++;
+		USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxErrors, 1);
+		USCI_ERROR(UCx_INDEX, USCI_ERR_FRAME);
+	}
+}
+/**************************************************************************//**
+ * \brief	Starts a COBS block of the frame being sent
+ *
+ * Scans ahead for the zero ending the block (at most 254 bytes).
+ *
+ * \return	The block code byte
+ ******************************************************************************/
+static unsigned char ucxCobsBlock(void)
+{
+	unsigned char n = 0;
+
+	while(n < 254 && n < ucxTxSize && ucxTxPtr[n]) n++;
+	ucxFrmTxLeft = n;
+	ucxFrmTxCode = n + 1;
+	return n + 1;
+}
+/**************************************************************************//**
+ * \brief	Starts the encoding of a frame to be sent
+ *
+ * \param	*data	Payload of the frame
+ * \param	len	Length (in bytes) of the payload
+ * \return	The first byte on the line (COBS block code or SLIP opening END,
+ * 		flushing any line noise at the receiver)
+ ******************************************************************************/
+static unsigned char ucxFrameStart(unsigned char *data, unsigned int len)
+{
+	ucxTxPtr = data;
+	ucxTxSize = len;
+	if(ucxFraming == USCI_OPT_COBS) return ucxCobsBlock();
+	ucxFrmTxCode = 0;
+	ucxFrmTxLeft = 1;				// Closing END pending
+	return SLIP_END;
+}
+/**************************************************************************//**
+ * \brief	Writes the next encoded byte of the frame being sent
+ *
+ * Called by the TX ISR, the payload is encoded on the fly (no encoded copy).
+ *
+ * \retval	0	Frame complete (delimiter sent)
+ * \retval	1	TXBUF loaded
+ ******************************************************************************/
+static unsigned char ucxFrameTx(void)
+{
+	unsigned char byte;
+
+	if(ucxFraming == USCI_OPT_COBS){
+		if(ucxFrmTxLeft){				// Data byte of the block
+			ucxFrmTxLeft--;
+			ucxTxSize--;
+			UCx_TXCRC(*ucxTxPtr);
+			UCxTXBUF = *(ucxTxPtr++);
+		}
+		else if(ucxTxSize){				// Next block (skipping the zero ending the block unless full)
+			if(ucxFrmTxCode != 0xFF){
+				UCx_TXCRC(0);
+				ucxTxPtr++;
+				ucxTxSize--;
+			}
+			UCxTXBUF = ucxCobsBlock();
+		}
+		else if(ucxFrmTxCode){				// Delimiter
+			ucxFrmTxCode = 0;
+			UCxTXBUF = 0;
+		}
+		else return 0;
+		return 1;
+	}
+	if(ucxFrmTxCode){					// Second byte of an escape
+		UCxTXBUF = ucxFrmTxCode;
+		ucxFrmTxCode = 0;
+	}
+	else if(ucxTxSize){
+		byte = *(ucxTxPtr++);
+		ucxTxSize--;
+		UCx_TXCRC(byte);
+		if(byte == SLIP_END){
+			ucxFrmTxCode = SLIP_ESC_END;
+			byte = SLIP_ESC;
+		}
+		else if(byte == SLIP_ESC){
+			ucxFrmTxCode = SLIP_ESC_ESC;
+			byte = SLIP_ESC;
+		}
+		UCxTXBUF = byte;
+	}
+	else if(ucxFrmTxLeft){					// Closing END
+		ucxFrmTxLeft = 0;
+		UCxTXBUF = SLIP_END;
+	}
+	else return 0;
+	return 1;
+}
+#endif // USCI_FRAMING
+/**************************************************************************//**
+ * \brief	Transmit method for USCI UART operation
+ *
+ * This method initializes the transmission of len bytes from
+ * the base of the *data pointer. The actual transmission itself
+ * is finished a variable length of time from the write (based
+ * upon len's value) in the TX ISR. Thus calling uartxWrite() twice in quick
+ * succession will likely result in partial transmission of the first data.
+ *
+ * \param	*data	Pointer to data to be written
+ * \param	len	Length (in bytes) of data to be written
+ * \param	commID	Communication ID number of application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Zero length write
+ * \retval	-1	USCI module busy
+ * \retval	1	Transmit successfully started
+ * \retval	2	Write queued behind the running transfer (USE_USCI_TXQUEUE)
+ ******************************************************************************/
+int uartxWrite(unsigned char *data, unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(!len) return -2;				// Check the length (zero length writes are not queued either)
+#ifdef USE_USCI_TXQUEUE
+	int queued = txqPush(UCx_INDEX, data, len, commID);
+
+	if(queued) return queued;			// Queued behind the running transfer (or queue full)
+#else
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+#endif // USE_USCI_TXQUEUE
+
+	confUCx(commID);
+
+	// Copy over pointer and length
+	ucxTxPtr = data;
+	ucxTxSize = len-1;
+#ifdef USE_USCI_DMA
+	// Hand the remaining bytes to the DMA (TX interrupt masked until done)
+	if((USCI_DEV(commID)->opts & (USCI_OPT_DMA + USCI_OPT_BYTEWISE)) == USCI_OPT_DMA && ucxTxSize &&
+		dmaStart(UCx_INDEX, UCx_DMA_TXTRIG, &UCxTXBUF, data+1, ucxTxSize, 0, 0, 0, 0)){
+		UCxIE &= ~UCTXIE;
+	}
+#endif // USE_USCI_DMA
+	USCI_STAT_XFER(UCx_INDEX, commID, len, 0);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Write TXBUF (start of transmit) and set status
+	usciStat[UCx_INDEX] = TX;
+#ifdef USCI_FRAMING
+	if(ucxFraming){
+		UCxTXBUF = ucxFrameStart(data, len);	// Framed app: the ISR encodes the payload on the fly
+		UCx_TXCPT_CLEAR();
+		return 1;
+	}
+#endif // USCI_FRAMING
+	if(UCx_CTS_HOLD(1)) return 1;			// Peer not ready: the CTS interrupt sends the first byte
+	UCx_TXCRC_MAIN(*ucxTxPtr);
+	UCxTXBUF = *ucxTxPtr;
+	UCx_TXCPT_CLEAR();
+
+	return 1;
+}
+/**************************************************************************//**
+ * \brief	Receive method for USCI UART operation
+ *
+ * This method spoofs an asynchronous read by providing the min of the
+ * bytes available and the requested length. It decrements the buffer size
+ * appropriately and returns bytes "read". With USE_UART_RXRING the bytes are
+ * instead copied out of the receive ring to the rxPtr of the application
+ * (lock free, the ISR only writes the ring head and this method the tail).
+ *
+ * \param	len	The number of bytes to be read from the buffer
+ * \param	commID	The comm ID of the application
+ * \return	The number of bytes available to read in the buffer. If the buffer
+ * 		is empty this value will be 0.
+ * \sideeffect	The RX size is decremented by the min of itself and
+ * 		the requested amount of bytes (len).
+ * \sa		This function does not make a call to confUCx() or check the
+ * 		state of the USCI module as it does not interact with the
+ * 		hardware module.
+ ******************************************************************************/
+int uartxRead(unsigned int len, unsigned int commID)
+{
+#ifdef USCI_RXRING
+	unsigned char *dst;
+	unsigned int tail;
+	unsigned int avail;
+	unsigned int i;
+
+#endif // USCI_RXRING
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+#ifdef USCI_RXRING
+	tail = ucxRxSync();
+	avail = ucxRxHead - tail;			// Single (atomic) read of the ISR owned head
+	dst = USCI_DEV(commID)->rxPtr;
+	if(len > avail) len = avail;
+	for(i = 0; i < len; i++){
+		dst[i] = ucxRxRing[(tail + i) & (UCx_RXRING_SIZE - 1)];
+	}
+	ucxRxTail = tail + len;				// Release the slots to the ISR once copied
+	UCx_RX_RELEASE();
+	return len;
+#else
+	// Read length determination = max(requested, available)
+	if(len > ucxRxSize) {
+		len = ucxRxSize;
+	}
+	ucxRxSize -= len;
+	UCx_RX_RELEASE();
+	return len;
+#endif // USCI_RXRING
+}
+#ifdef USCI_RXRING
+/**************************************************************************//**
+ * \brief	Get method for the USCI receive ring overflow count
+ *
+ * \return	The number of received bytes dropped because the ring was full
+ ******************************************************************************/
+unsigned int getUCxRxOverflow(void){
+	return ucxRxOverflow;
+}
+#endif // USCI_RXRING
+#ifdef USCI_FRAMING
+/**************************************************************************//**
+ * \brief	Get method for the last frame received by a framed UART app
+ *
+ * The frame is decoded in place in the rxPtr buffer of the app (one half of
+ * it, the ISR decoding the next frame into the other half) and stays valid
+ * until uartxReleaseFrame(). A frame completing while the app still holds
+ * the previous one is dropped (USCI_ERR_FRAME).
+ *
+ * \param	**frame	Set to the first byte of the frame (unchanged if none)
+ * \return	The length of the frame, 0 if no frame has been received
+ ******************************************************************************/
+unsigned int uartxGetFrame(unsigned char **frame)
+{
+	unsigned char *ready = ucxFrmReady;
+
+	if(!ready) return 0;
+	*frame = ready;
+	return ucxFrmReadyLen;
+}
+/**************************************************************************//**
+ * \brief	Hands the frame from uartxGetFrame() back to the ISR
+ ******************************************************************************/
+void uartxReleaseFrame(void)
+{
+	ucxFrmReady = 0;
+}
+#endif // USCI_FRAMING
+#ifdef USCI_IDLE
+/**************************************************************************//**
+ * \brief	Ends the received message once the line went idle
+ *
+ * Called by usciIdleIsr() when the idle timeout of the configured app has
+ * elapsed since the last byte received. The compare channel is left disabled
+ * until the next byte restarts it.
+ ******************************************************************************/
+static void ucxIdleDone(void)
+{
+	UCx_IDLE_CCTL = 0;
+	ucxRxIdle = 1;
+	USCI_EVENT(UCx_INDEX, onRxIdle);
+	USCI_WAKE(UCx_INDEX);
+}
+/**************************************************************************//**
+ * \brief	Get method for the end of a received UART message
+ *
+ * Reports (once) that the line has been idle for the idleBits of the app
+ * since the last byte received, i.e. that the sender has finished the
+ * message now held by the receive buffer (or ring).
+ *
+ * \retval	1	The line went idle after the last byte (flag cleared)
+ * \retval	0	No message ended since the last call
+ ******************************************************************************/
+unsigned char uartxRxIdle(void)
+{
+	unsigned int status;
+	unsigned char idle;
+
+	enter_critical(status);
+	idle = ucxRxIdle;
+	ucxRxIdle = 0;
+	exit_critical(status);
+	return idle;
+}
+#ifdef USE_USCI_LPM
+/**************************************************************************//**
+ * \brief	Low power wait for the end of a received UART message
+ *
+ * Sleeps in USCI_LPM_BITS until the line goes idle after a byte received
+ * (see uartxRxIdle(), the flag is cleared on return). The app must have
+ * non-zero idleBits, and be the configured app of the module.
+ ******************************************************************************/
+void uartxWaitIdle(void)
+{
+	unsigned int status;
+
+	enter_critical(status);
+	usciWait[UCx_INDEX] = 1;
+	while(!ucxRxIdle){
+		__bis_SR_register(USCI_LPM_BITS + GIE);	// Sleep (GIE set with the LPM bits, so the wake-up cannot be missed)
+		_disable_interrupts();
+	}
+	ucxRxIdle = 0;
+	usciWait[UCx_INDEX] = 0;
+	exit_critical(status);
+}
+#endif // USE_USCI_LPM
+#endif // USCI_IDLE
+#ifdef USCI_FLOW
+/**************************************************************************//**
+ * \brief	Pauses the write while the peer deasserts CTS
+ *
+ * Masks the TX interrupt and arms the CTS edge interrupt, the pending
+ * TXIFG then sends the next byte once usciCtsIsr() calls ucxCtsResume().
+ * CTS is sampled again once armed so an edge in between is not missed.
+ *
+ * \param	held	1 when the first byte of the write is held back (not
+ * 			yet in TXBUF), 0 from the ISR
+ * \retval	1	Write paused
+ * \retval	0	Peer ready, send on
+ ******************************************************************************/
+static unsigned char ucxCtsPause(unsigned char held)
+{
+	unsigned int status;
+
+	if(!(USCI_FLOW_IN & UCx_CTS_PIN)) return 0;	// CTS asserted (low)
+	enter_critical(status);
+	UCxIE &= ~UCTXIE;
+	USCI_FLOW_IFG &= ~UCx_CTS_PIN;
+	USCI_FLOW_IE |= UCx_CTS_PIN;
+	if(USCI_FLOW_IN & UCx_CTS_PIN){			// Still deasserted: wait for the edge
+		ucxTxHeld = held;
+		exit_critical(status);
+		return 1;
+	}
+	USCI_FLOW_IE &= ~UCx_CTS_PIN;			// Asserted meanwhile
+	UCxIE |= UCTXIE;
+	exit_critical(status);
+	return 0;
+}
+/**************************************************************************//**
+ * \brief	Resumes the write paused by ucxCtsPause()
+ *
+ * Called by usciCtsIsr() on the CTS ready edge. Sends the held first byte
+ * of the write (if any) and unmasks the TX interrupt.
+ ******************************************************************************/
+static void ucxCtsResume(void)
+{
+	USCI_FLOW_IE &= ~UCx_CTS_PIN;
+	USCI_FLOW_IFG &= ~UCx_CTS_PIN;
+	if(ucxTxHeld){
+		ucxTxHeld = 0;
+		UCx_TXCRC(*ucxTxPtr);
+		UCxTXBUF = *ucxTxPtr;
+	}
+	UCx_TXCPT_CLEAR();				// (Line idle while paused)
+	UCxIE |= UCTXIE;
+}
+/**************************************************************************//**
+ * \brief	Asserts RTS again once the unread bytes drop to UART_RTS_GO
+ *
+ * Called by uartxRead() (the ISR deasserts RTS at UART_RTS_STOP).
+ ******************************************************************************/
+static void ucxRtsGo(void)
+{
+	unsigned int status;
+
+	enter_critical(status);
+	if(UCx_RX_UNREAD <= UART_RTS_GO) USCI_FLOW_OUT &= ~UCx_RTS_PIN;
+	exit_critical(status);
+}
+#endif // USCI_FLOW
+#ifdef USCI_AUTOBAUD
+/**************************************************************************//**
+ * \brief	Collects the baud rate measured on the sync field
+ *
+ * Called by the ISR once it dropped the sync byte (0x55) following a break.
+ * The module has already loaded UCxBRW/UCxMCTLW with the measured rate,
+ * which is stored in the config of the app (as setUCxBaud() does, minus the
+ * reconfiguration) so that confUCx() keeps it. A break or sync timeout
+ * reports USCI_ERR_BAUD and leaves the rate unchanged.
+ ******************************************************************************/
+static void ucxBaudDetect(void)
+{
+	if(UCxABCTL & (UCBTOE + UCSTOE)){
+		UCxABCTL &= ~(UCBTOE + UCSTOE);
+		USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxErrors, 1);
+		USCI_ERROR(UCx_INDEX, USCI_ERR_BAUD);
+		return;
+	}
+	if(!devConf[UCx_INDEX]) return;
+	USCI_BRW(devConf[UCx_INDEX]) = UCxBRW;
+	USCI_MCTLW(devConf[UCx_INDEX]) = UCxMCTLW;
+#ifdef USCI_IDLE
+	ucxIdleTicks = idleTicks(devConf[UCx_INDEX]);		// Idle timeout in bit times of the new rate
+	devIdle[USCI_SLOT(devConf[UCx_INDEX])] = ucxIdleTicks;
+#endif // USCI_IDLE
+	ucxBaudLock = 1;
+}
+/**************************************************************************//**
+ * \brief	Get method for the automatic baud rate detection
+ *
+ * Reports (once) that the module measured the rate of the peer on a break
+ * and sync field, the baudDiv and mctlw of the app now hold that rate.
+ *
+ * \retval	1	Baud rate measured since the last call (flag cleared)
+ * \retval	0	No new measurement
+ ******************************************************************************/
+unsigned char uartxBaudLocked(void)
+{
+	unsigned int status;
+	unsigned char lock;
+
+	enter_critical(status);
+	lock = ucxBaudLock;
+	ucxBaudLock = 0;
+	exit_critical(status);
+	return lock;
+}
+#endif // USCI_AUTOBAUD
+#ifdef USE_USCI_IOVEC
+/**************************************************************************//**
+ * \brief	Gather transmit method for USCI UART operation
+ *
+ * This method transmits count segments back-to-back as one transfer, the
+ * TX ISR moving on from one segment to the next, so data held in separate
+ * buffers (e.g. header and payload) need not be copied together first. The
+ * segment array and data must remain valid until the transfer completes.
+ *
+ * \param	*seg	Array of segments to be written (lengths must be non-zero)
+ * \param	count	Number of segments in the array
+ * \param 	commID	Communication ID number of application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Empty segment list or segment
+ * \retval	-1	USCI module busy
+ * \retval	1	Transmit successfully started
+ *******************************************************************************/
+int uartxWriteV(const usciSegment *seg, unsigned char count, unsigned int commID)
+{
+	unsigned int len;
+
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	len = segTotal(seg, count);
+	if(!len) return -2;				// Check the segment list
+#ifdef USCI_FRAMING
+	if(USCI_DEV(commID)->opts & USCI_OPT_FRAMING) return -2;	// Gather writes are not framed
+#endif // USCI_FRAMING
+
+	confUCx(commID);
+
+	// Copy over the first segment (the ISR walks the remaining ones)
+	ucxTxSeg = seg + 1;
+	ucxTxSegLeft = count - 1;
+	ucxTxPtr = seg->data;
+	ucxTxSize = seg->len - 1;
+	USCI_STAT_XFER(UCx_INDEX, commID, len, 0);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of TX
+	usciStat[UCx_INDEX] = TX;
+	if(UCx_CTS_HOLD(1)) return 1;			// Peer not ready: the CTS interrupt sends the first byte
+	UCx_TXCRC_MAIN(*ucxTxPtr);
+	UCxTXBUF = *ucxTxPtr;
+	UCx_TXCPT_CLEAR();
+
+	return 1;
+}
+#endif // USE_USCI_IOVEC
+#endif // USCI_UART
+
+/***********************************************************
+ * SPI HANDLERS
+ ***********************************************************/
+#ifdef USCI_SPI
+/**************************************************************************//**
+ * \brief	Transmit method for USCI SPI operation
+ *
+ * This method initializes a transmission of len bytes from the base of the
+ * *data pointer. The transmission uses the TX ISR to complete, so 2
+ * sequential calls may result in partial transmission.
+ *
+ * \param	*data	Pointer to data to be written
+ * \param	len	Length (in bytes) of data to be written
+ * \param 	commID	Communication ID number of application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Zero length write
+ * \retval	-1	USCI module busy
+ * \retval	1	Transmit successfully started
+ * \retval	2	Write queued behind the running transfer (USE_USCI_TXQUEUE)
+ *******************************************************************************/
+int spixWrite(unsigned char *data, unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(!len) return -2;				// Check the length (zero length writes are not queued either)
+#ifdef USE_USCI_TXQUEUE
+	int queued = txqPush(UCx_INDEX, data, len, commID);
+
+	if(queued) return queued;			// Queued behind the running transfer (or queue full)
+#else
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+#endif // USE_USCI_TXQUEUE
+
+	confUCx(commID);
+
+	// Copy over pointer and length
+	ucxTxPtr = data;
+	ucxTxSize = len-1;
+#ifdef USE_USCI_DMA
+	// Hand the remaining bytes to the DMA (interrupts masked until done)
+	if((USCI_DEV(commID)->opts & (USCI_OPT_DMA + USCI_OPT_BYTEWISE)) == USCI_OPT_DMA && ucxTxSize &&
+		dmaStart(UCx_INDEX, UCx_DMA_TXTRIG, &UCxTXBUF, data+1, ucxTxSize, 0, 0, 0, 0)){
+		UCxIE &= ~(UCRXIE + UCTXIE);
+	}
+#endif // USE_USCI_DMA
+	USCI_STAT_XFER(UCx_INDEX, commID, len, 0);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of TX
+	usciStat[UCx_INDEX] = TX;
+	UCx_TXCRC_MAIN(*ucxTxPtr);
+	UCxTXBUF = *ucxTxPtr;
+
+	return 1;
+}
+/**************************************************************************//**
+ * \brief	Receive method for USCI SPI operation
+ *
+ * This method performs a synchronous read by storing the bytes to be read in
+ * the to-RX size and then performing len dummy write to the bus to fetch the data
+ * from a slave device. The RX size is cleared on this function call.
+ *
+ * \param	len	The number of bytes to be read from the bus
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-1	USCI module Busy
+ * \retval	1	Receive successfully started
+ *
+ * \sideeffect	Reset the RX size and data pointer
+ ******************************************************************************/
+int spixRead(unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+
+	confUCx(commID);
+
+	// Clear RX Size/Buff and copy length
+	ucxRxSize = 0;					// Reset the rx size
+	ucxRxPtr = USCI_DEV(commID)->rxPtr;			// Reset the rx pointer
+	ucxToRxSize = len;
+#ifdef USE_USCI_DMA
+	// DMA clocks out the remaining dummy bytes and stores the received ones
+	if((USCI_DEV(commID)->opts & (USCI_OPT_DMA + USCI_OPT_BYTEWISE)) == USCI_OPT_DMA && len > 1 &&
+		dmaStart(UCx_INDEX, UCx_DMA_TXTRIG, &UCxTXBUF, 0, len-1, UCx_DMA_RXTRIG, &UCxRXBUF, ucxRxPtr, len)){
+		UCxIE &= ~(UCRXIE + UCTXIE);
+	}
+#endif // USE_USCI_DMA
+	USCI_STAT_XFER(UCx_INDEX, commID, 0, len);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of RX
+	usciStat[UCx_INDEX] = RX;
+	UCxTXBUF = 0xFF;				// Start TX
+	return 1;
+}
+/**************************************************************************//**
+ * \brief	Full-duplex transfer method for USCI SPI operation
+ *
+ * This method exchanges len bytes with a slave device, transmitting from *tx
+ * while storing the bytes clocked back in to *rx. Like spixRead() it returns
+ * once the first byte is started, the RX ISR writing each following byte
+ * once the previous one has been received (or the DMA moving both directions
+ * with USCI_OPT_DMA). The RX size counts the bytes received.
+ *
+ * \param	*tx	Pointer to data to be written
+ * \param	*rx	Pointer to the receive buffer (len bytes)
+ * \param	len	Number of bytes to exchange
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Zero length transfer
+ * \retval	-1	USCI module Busy
+ * \retval	1	Transfer successfully started
+ ******************************************************************************/
+int spixTransfer(unsigned char *tx, unsigned char *rx, unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	if(!len) return -2;
+
+	confUCx(commID);
+
+	// Copy over pointers and lengths
+	ucxTxPtr = tx;
+	ucxTxSize = len-1;
+	ucxRxPtr = rx;
+	ucxRxSize = 0;
+	ucxToRxSize = len;
+#ifdef USE_USCI_DMA
+	// DMA feeds TXBUF and empties RXBUF (interrupts masked until done)
+	if((USCI_DEV(commID)->opts & (USCI_OPT_DMA + USCI_OPT_BYTEWISE)) == USCI_OPT_DMA && len > 1 &&
+		dmaStart(UCx_INDEX, UCx_DMA_TXTRIG, &UCxTXBUF, tx+1, len-1, UCx_DMA_RXTRIG, &UCxRXBUF, rx, len)){
+		UCxIE &= ~(UCRXIE + UCTXIE);
+	}
+#endif // USE_USCI_DMA
+	USCI_STAT_XFER(UCx_INDEX, commID, len, len);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of transfer
+	usciStat[UCx_INDEX] = XFER;
+	UCx_TXCRC_MAIN(*ucxTxPtr);
+	UCxTXBUF = *ucxTxPtr;
+	return 1;
+}
+/**************************************************************************//**
+ * \brief	Byte Swap method for USCI SPI operation
+ *
+ * This blocking method allows the user to transmit a byte and receive the
+ * response simultaneously clocked back in. TX and RX buffer sizes/content
+ * are unaffected.
+ *
+ * \param	byte	The byte to be sent via SPI
+ * \param 	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-1	USCI module busy
+ * \return	Otherwise the byte shifted in from the SPI (0 to 255)
+ *************************************************************************/
+int spixSwap(unsigned char byte, unsigned int commID)
+{
+#ifdef USE_USCI_LPM
+	unsigned int status;
+
+#endif // USE_USCI_LPM
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+
+	confUCx(commID);
+
+	USCI_STAT_XFER(UCx_INDEX, commID, 1, 1);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	usciStat[UCx_INDEX] = SWAP;			// Set status to swap (block other operation)
+#ifdef USE_USCI_LPM
+	ucxSwapDone = 0;
+#endif // USE_USCI_LPM
+	UCxTXBUF = byte;
+#ifdef USE_USCI_LPM
+	enter_critical(status);
+	usciWait[UCx_INDEX] = 1;
+	while(!ucxSwapDone){				// Sleep until the RX ISR of the byte (checked with interrupts off)
+		__bis_SR_register(USCI_LPM_BITS + GIE);
+		_disable_interrupts();
+	}
+	usciWait[UCx_INDEX] = 0;
+	exit_critical(status);
+#else
+	while(UCxSTAT & UCBUSY);			// Wait for TX complete
+#endif // USE_USCI_LPM
+	USCI_PROF_DONE(UCx_INDEX);
+	usciStat[UCx_INDEX] = OPEN;			// Set status to open (swap complete)
+	return UCxRXBUF;				// Return RX contents
+}
+#ifdef USE_USCI_REGS
+/**************************************************************************//**
+ * \brief	Register read method for USCI SPI operation
+ *
+ * This method sends the register address byte reg, then reads len bytes
+ * to *buf in the same transfer (the byte clocked in with the address is
+ * dropped by the RX ISR, which carries on with the dummy writes of a read).
+ * The chip select stays the responsibility of the app, the status returns
+ * to OPEN once the last byte has been received.
+ *
+ * \param	reg	Register address byte (including any read flag of the device)
+ * \param	*buf	Destination of the register contents (len bytes)
+ * \param	len	Number of bytes to read
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Zero length read
+ * \retval	-1	USCI module Busy
+ * \retval	1	Register read successfully started
+ *
+ * \sideeffect	Reset the RX size, the RX pointer is left after the data
+ ******************************************************************************/
+int spixRegRead(unsigned char reg, unsigned char *buf, unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	if(!len) return -2;
+
+	confUCx(commID);
+
+	ucxRxSize = 0;
+	ucxRxPtr = buf;
+	ucxToRxSize = len;
+	USCI_STAT_XFER(UCx_INDEX, commID, 1, len);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of the address phase
+	usciStat[UCx_INDEX] = REG;
+	UCxTXBUF = reg;
+	return 1;
+}
+/**************************************************************************//**
+ * \brief	Register write method for USCI SPI operation
+ *
+ * This method sends the register address byte reg followed by len bytes
+ * from *data in the same transfer, the TX ISR moving on to the data once
+ * the address byte is under way.
+ *
+ * \param	reg	Register address byte
+ * \param	*data	Pointer to data to be written
+ * \param	len	Length (in bytes) of data to be written
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Zero length write
+ * \retval	-1	USCI module Busy
+ * \retval	1	Register write successfully started
+ ******************************************************************************/
+int spixRegWrite(unsigned char reg, unsigned char *data, unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	if(!len) return -2;
+
+	confUCx(commID);
+
+	ucxTxPtr = data;
+	ucxTxSize = len-1;
+	ucxToRxSize = 0;
+	USCI_STAT_XFER(UCx_INDEX, commID, len+1, 0);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of the address phase
+	usciStat[UCx_INDEX] = REG;
+	UCxTXBUF = reg;
+	return 1;
+}
+#endif // USE_USCI_REGS
+#ifdef USE_USCI_IOVEC
+/**************************************************************************//**
+ * \brief	Gather transmit method for USCI SPI operation
+ *
+ * This method transmits count segments back-to-back as one transfer, the
+ * TX ISR moving on from one segment to the next, so data held in separate
+ * buffers (e.g. header and payload) need not be copied together first. The
+ * segment array and data must remain valid until the transfer completes.
+ *
+ * \param	*seg	Array of segments to be written (lengths must be non-zero)
+ * \param	count	Number of segments in the array
+ * \param 	commID	Communication ID number of application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Empty segment list or segment
+ * \retval	-1	USCI module busy
+ * \retval	1	Transmit successfully started
+ *******************************************************************************/
+int spixWriteV(const usciSegment *seg, unsigned char count, unsigned int commID)
+{
+	unsigned int len;
+
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	len = segTotal(seg, count);
+	if(!len) return -2;				// Check the segment list
+
+	confUCx(commID);
+
+	// Copy over the first segment (the ISR walks the remaining ones)
+	ucxTxSeg = seg + 1;
+	ucxTxSegLeft = count - 1;
+	ucxTxPtr = seg->data;
+	ucxTxSize = seg->len - 1;
+	USCI_STAT_XFER(UCx_INDEX, commID, len, 0);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of TX
+	usciStat[UCx_INDEX] = TX;
+	UCx_TXCRC_MAIN(*ucxTxPtr);
+	UCxTXBUF = *ucxTxPtr;
+
+	return 1;
+}
+/**************************************************************************//**
+ * \brief	Scatter receive method for USCI SPI operation
+ *
+ * This method reads the sum of the segment lengths from the bus, the RX
+ * ISR storing the bytes to one segment after the other. The RX size counts
+ * the bytes received over all segments.
+ *
+ * \param	*seg	Array of segments to be read into (lengths must be non-zero)
+ * \param	count	Number of segments in the array
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Empty segment list or segment
+ * \retval	-1	USCI module Busy
+ * \retval	1	Receive successfully started
+ ******************************************************************************/
+int spixReadV(const usciSegment *seg, unsigned char count, unsigned int commID)
+{
+	unsigned int len;
+
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	len = segTotal(seg, count);
+	if(!len) return -2;				// Check the segment list
+
+	confUCx(commID);
+
+	// Point RX at the first segment (the ISR walks the remaining ones)
+	ucxRxSize = 0;
+	ucxRxPtr = seg->data;
+	ucxRxSegSize = seg->len;
+	ucxRxSeg = seg + 1;
+	ucxRxSegLeft = count - 1;
+	ucxToRxSize = len;
+	USCI_STAT_XFER(UCx_INDEX, commID, 0, len);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of RX
+	usciStat[UCx_INDEX] = RX;
+	UCxTXBUF = 0xFF;				// Start TX
+	return 1;
+}
+#endif // USE_USCI_IOVEC
+#ifdef USCI_STREAM
+/**************************************************************************//**
+ * \brief	Streaming read method for USCI SPI operation
+ *
+ * Reads blocks of len bytes without end, the RX ISR filling bufA, handing it
+ * to the app (see spixStreamGet()) and carrying on into bufB without a gap,
+ * then back into bufA once released, until spixStreamStop(). Two dummy bytes
+ * are kept queued (shift register + TXBUF) so the bus clocks back to back
+ * bytes as long as the ISR serves each byte within one byte time. A block
+ * completed while the previous one is still held by the app is dropped
+ * (refilled) and reported as USCI_ERR_STREAM. USCI_OPT_DMA is not used.
+ *
+ * \param	*bufA	First block buffer (len bytes)
+ * \param	*bufB	Second block buffer (len bytes)
+ * \param	len	Block length in bytes
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Zero length block or missing buffer
+ * \retval	-1	USCI module Busy
+ * \retval	1	Stream successfully started
+ ******************************************************************************/
+int spixStream(unsigned char *bufA, unsigned char *bufB, unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	if(!len || !bufA || !bufB) return -2;
+
+	confUCx(commID);
+
+	ucxStrBuf[0] = bufA;
+	ucxStrBuf[1] = bufB;
+	ucxStrFill = 0;
+	ucxStrStop = 0;
+	ucxStrReady = 0;
+	ucxRxPtr = bufA;
+	ucxRxSize = 0;
+	ucxToRxSize = len;
+	USCI_PROF_START(UCx_INDEX);
+	// Start of RX (the TX ISR loads the second byte and masks itself, then the RX ISR feeds TXBUF)
+	ucxStrPend = 2;					// Both bytes counted before the ISRs can run
+	usciStat[UCx_INDEX] = STREAM;
+	UCxTXBUF = 0xFF;
+	return 1;
+}
+/**************************************************************************//**
+ * \brief	Get method for the block completed by the SPI stream
+ *
+ * The block stays valid (the ISR does not write to it) until
+ * spixStreamRelease() is called.
+ *
+ * \param	**block	Set to the completed block (left unchanged if none)
+ * \return	The length of the block (0 if no block is ready)
+ ******************************************************************************/
+unsigned int spixStreamGet(unsigned char **block)
+{
+	unsigned char *ready = ucxStrReady;
+
+	if(!ready) return 0;
+	*block = ready;
+	return ucxToRxSize;
+}
+/**************************************************************************//**
+ * \brief	Hands the block returned by spixStreamGet() back to the stream
+ ******************************************************************************/
+void spixStreamRelease(void)
+{
+	ucxStrReady = 0;
+}
+/**************************************************************************//**
+ * \brief	Stops the SPI stream
+ *
+ * No further bytes are clocked, the status returns to OPEN once the bytes in
+ * flight are received (into the block being filled, see getUCxRxSize()).
+ ******************************************************************************/
+void spixStreamStop(void)
+{
+	if(usciStat[UCx_INDEX] == STREAM) ucxStrStop = 1;
+}
+/**************************************************************************//**
+ * \brief	Get method for the SPI stream dropped block count
+ *
+ * \return	The number of blocks dropped because the app had not released
+ * 		the previous one
+ ******************************************************************************/
+unsigned int getUCxStreamDrops(void){
+	return ucxStrDrops;
+}
+/**************************************************************************//**
+ * \brief	Stores a byte received by the SPI stream
+ *
+ * Called by the ISR. The next dummy byte is queued first so the bus stays
+ * busy while the received one is stored. An overrun loses at most one byte
+ * (only two are ever queued), the stream goes on with the next one.
+ ******************************************************************************/
+static void ucxStreamRx(void)
+{
+	unsigned int err;
+
+	if(!ucxStrStop){				// Keep the next byte queued
+		UCxTXBUF = 0xFF;
+		ucxStrPend++;
+	}
+	err = UCxSTAT;
+	*(ucxRxPtr++) = UCxRXBUF;
+	ucxStrPend--;
+	if(err & UCOE){					// ISR fell behind: the previous byte was lost
+		ucxStrPend--;
+		if(!ucxStrStop && (UCxIFG & UCTXIFG)){	// Queue a second byte again (the bus went idle)
+			UCxTXBUF = 0xFF;
+			ucxStrPend++;
+		}
+		USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxErrors, 1);
+		USCI_ERROR(UCx_INDEX, err);
+	}
+	if(++ucxRxSize >= ucxToRxSize){			// Block full
+		if(ucxStrReady){			// Previous block still held: refill this one
+			ucxStrDrops++;
+			USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxErrors, 1);
+			USCI_ERROR(UCx_INDEX, USCI_ERR_STREAM);
+		}
+		else{
+			ucxStrReady = ucxStrBuf[ucxStrFill];
+			ucxStrFill ^= 1;
+			USCI_STAT_XFER(UCx_INDEX, devConf[UCx_INDEX], 0, ucxToRxSize);
+			USCI_PROF_DONE(UCx_INDEX);
+			USCI_PROF_START(UCx_INDEX);
+			USCI_EVENT(UCx_INDEX, onRxDone);
+			USCI_WAKE(UCx_INDEX);
+		}
+		ucxRxPtr = ucxStrBuf[ucxStrFill];
+		ucxRxSize = 0;
+	}
+	if(ucxStrStop && !ucxStrPend){			// Last byte in flight received
+		usciStat[UCx_INDEX] = OPEN;
+		UCxIE |= UCTXIE;
+		UCx_TX_NEXT();
+		USCI_WAKE(UCx_INDEX);
+	}
+}
+#endif // USCI_STREAM
+#endif // USCI_SPI
+
+/***********************************************************
+ * I2C HANDLERS
+ ***********************************************************/
+#ifdef USCI_I2C
+/**************************************************************************//**
+ * \brief	Starts (or restarts) an I2C master receive
+ *
+ * Switches the module to receiver mode and generates a (repeated) start
+ * condition. A single byte receive must set UCTXSTP while that byte is being
+ * received, so for ucxToRxSize == 1 the start condition is polled until the
+ * slave address has been sent (the only case the I2C engine waits on the bus).
+ ******************************************************************************/
+static void ucxI2cStartRx(void)
+{
+	UCxCTL1 = (UCxCTL1 & ~UCTR) | UCTXSTT;		// Receiver w/ (repeated) start condition
+	if(ucxToRxSize == 1){
+		while(UCxCTL1 & UCTXSTT);		// Wait for the address to be sent
+		UCxCTL1 |= UCTXSTP;			// NACK and stop after the only byte
+	}
+}
+/**************************************************************************//**
+ * \brief	Write-then-read method for USCI I2C operation
+ *
+ * This method writes txLen bytes from *tx to the slave addressed by the
+ * rAddr of the registered app, then generates a repeated start and reads
+ * rxLen bytes to the RX pointer of the app before the stop condition (the
+ * usual register read of a sensor). The ISR runs the whole transaction, the
+ * status returns to OPEN once the stop condition has been sent. A slave NACK
+ * ends the transaction early (with a stop condition) and is reported as
+ * USCI_ERR_NACK to the onError hook.
+ *
+ * \param	*tx	Pointer to data to be written
+ * \param	txLen	Length (in bytes) of data to be written
+ * \param	rxLen	Number of bytes to read after the repeated start (0 to
+ * 			only write)
+ * \param 	commID	Communication ID number of application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-1	USCI module busy
+ * \retval	1	Transaction successfully started
+ *
+ * \sideeffect	Reset the RX size and data pointer
+ ******************************************************************************/
+int i2cxTransfer(unsigned char *tx, unsigned int txLen, unsigned int rxLen, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID); 	// Check that the USCI is available
+
+	confUCx(commID);
+
+	ucxTxPtr = tx;
+	ucxTxSize = txLen;
+	ucxRxSize = 0;
+	ucxRxPtr = USCI_DEV(commID)->rxPtr;
+	ucxToRxSize = rxLen;
+	USCI_STAT_XFER(UCx_INDEX, commID, txLen, rxLen);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of TX (the ISR loads each byte, then restarts or stops)
+	usciStat[UCx_INDEX] = TX;
+	UCxCTL1 |= UCTR + UCTXSTT;	// Generate start condition
+
+	return 1;
+}
+/**************************************************************************//**
+ * \brief	Transmit method for USCI I2C operation
+ *
+ * This method initializes a transmission of len bytes from the base of the
+ * *data pointer. The ISR sends the address, the data and the stop condition,
+ * the status returns to OPEN once the stop condition has been sent.
+ *
+ * \param	*data	Pointer to data to be written
+ * \param	len	Length (in bytes) of data to be written
+ * \param 	commID	Communication ID number of application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-1	USCI module busy
+ * \retval	1	Transmit successfully started
+ *******************************************************************************/
+int i2cxWrite(unsigned char *data, unsigned int len, unsigned int commID)
+{
+	return i2cxTransfer(data, len, 0, commID);
+}
+/**************************************************************************//**
+ * \brief	Receive method for USCI I2C operation
+ *
+ * This method reads len bytes from the slave addressed by the rAddr of the
+ * registered app to its RX pointer. The ISR stores each byte and requests
+ * the stop condition (NACKing the last byte) while the last byte is being
+ * received, the status returns to OPEN once the stop condition has been sent.
+ *
+ * \param	len	The number of bytes to be read from the bus
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Zero length read
+ * \retval	-1	USCI module Busy
+ * \retval	1	Receive successfully started
+ *
+ * \sideeffect	Reset the RX size and data pointer
+ ******************************************************************************/
+int i2cxRead(unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	if(!len) return -2;
+
+	confUCx(commID);
+
+	ucxTxSize = 0;
+	ucxRxSize = 0;
+	ucxRxPtr = USCI_DEV(commID)->rxPtr;
+	ucxToRxSize = len;
+	USCI_STAT_XFER(UCx_INDEX, commID, 0, len);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of RX
+	usciStat[UCx_INDEX] = RX;
+	ucxI2cStartRx();		// Generate start condition
+
+	return 1;
+}
+#ifdef USE_USCI_REGS
+/**************************************************************************//**
+ * \brief	Register read method for USCI I2C operation
+ *
+ * This method writes the register address byte reg to the slave addressed
+ * by the rAddr of the registered app, then reads len bytes to *buf after a
+ * repeated start, the ISR running the whole transaction (see i2cxTransfer()).
+ *
+ * \param	reg	Register address byte
+ * \param	*buf	Destination of the register contents (len bytes)
+ * \param	len	Number of bytes to read
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Zero length read
+ * \retval	-1	USCI module Busy
+ * \retval	1	Register read successfully started
+ *
+ * \sideeffect	Reset the RX size, the RX pointer is left after the data
+ ******************************************************************************/
+int i2cxRegRead(unsigned char reg, unsigned char *buf, unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	if(!len) return -2;
+
+	confUCx(commID);
+
+	ucxReg = reg;
+	ucxTxSize = 0;
+	ucxRxSize = 0;
+	ucxRxPtr = buf;
+	ucxToRxSize = len;
+	USCI_STAT_XFER(UCx_INDEX, commID, 1, len);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of the address phase (the ISR sends reg)
+	usciStat[UCx_INDEX] = REG;
+	UCxCTL1 |= UCTR + UCTXSTT;	// Generate start condition
+
+	return 1;
+}
+/**************************************************************************//**
+ * \brief	Register write method for USCI I2C operation
+ *
+ * This method writes the register address byte reg followed by len bytes
+ * from *data to the slave addressed by the rAddr of the registered app, in
+ * one transaction run by the ISR.
+ *
+ * \param	reg	Register address byte
+ * \param	*data	Pointer to data to be written
+ * \param	len	Length (in bytes) of data to be written
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-2	Zero length write
+ * \retval	-1	USCI module Busy
+ * \retval	1	Register write successfully started
+ ******************************************************************************/
+int i2cxRegWrite(unsigned char reg, unsigned char *data, unsigned int len, unsigned int commID)
+{
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that the USCI is available
+	if(!len) return -2;
+
+	confUCx(commID);
+
+	ucxReg = reg;
+	ucxTxPtr = data;
+	ucxTxSize = len;
+	ucxToRxSize = 0;
+	USCI_STAT_XFER(UCx_INDEX, commID, len+1, 0);
+	USCI_PROF_START(UCx_INDEX);
+	UCx_CRC_START();
+	// Start of the address phase (the ISR sends reg)
+	usciStat[UCx_INDEX] = REG;
+	UCxCTL1 |= UCTR + UCTXSTT;	// Generate start condition
+
+	return 1;
+}
+#endif // USE_USCI_REGS
+/**************************************************************************//**
+ * \brief	Ping (slave present) Method for USCI I2C Operation
+ *
+ * This method tests for the presence of a slave at the address affiliated with
+ * the registered commID. This is accomplished by sending a start, then stop
+ * condition sequenitally on the bus, then reading the IFG register for
+ * a NACK condition.
+ *
+ * \param	commID	Communication ID number of the application
+ *
+ * \retval	-3	Unknown or unregistered comm ID
+ * \retval	-1	USCI module Busy
+ * \retval	0	Slave not present
+ * \retval	1	Slave present
+ *
+ * \sideeffect	The USCI module will need to be reconfigured for the next
+ * 		operation (even if it uses the same slave address or commID)
+ ******************************************************************************/
+int i2cxSlavePresent(unsigned int commID)
+{
+	int retval;
+
+	if(!USCI_ID_OK(commID)) return USCI_ID_ERROR;		// Check the comm ID
+	if(usciStat[UCx_INDEX] != OPEN) return USCI_BUSY(UCx_INDEX, commID);	// Check that USCI is available
+
+	confUCx(commID);				// Set slave address
+	__disable_interrupt();
+	UCxIE &= ~(UCTXIE + UCRXIE + UCNACKIE + UCSTPIE);	// Clear NACK, stop, RX, and TX interrupt conditions
+	UCxCTL1 |= UCTR + UCTXSTT + UCTXSTP;		// TX w/ start and stop condition
+	while(UCxCTL1 & UCTXSTP);			// Wait for stop condition
+
+	retval = !(UCxIFG & UCNACKIFG);
+	UCxIFG &= ~(UCNACKIFG + UCSTPIFG);
+	devConf[UCx_INDEX] = 0;				// Clear dev conf slot for the module
+	__enable_interrupt();
+
+	return retval;
+}
+#endif // USCI_I2C
+
+#if defined(USE_USCI_TXQUEUE) && !defined(USCI_I2C)
+/**************************************************************************//**
+ * \brief	Starts the next queued USCI write
+ *
+ * Called on the end of each transfer (status already set back to OPEN, after
+ * the completion hook) so that queued writes follow each other back-to-back.
+ * A queued write of another app reconfigures the module, which must wait for
+ * the last byte to be sent: the module is then held (status TX) and the write
+ * started by the UART transmit complete interrupt, or on SPI by the receive
+ * interrupt of the last byte (UCBUSY is never polled in a loop, and is not
+ * checked by that interrupt as it may still be set at the last clock edge).
+ ******************************************************************************/
+static void ucxTxNext(void)
+{
+	if(usciStat[UCx_INDEX] != OPEN) return;	// A completion hook started a transfer (resume at its end)
+	if(!txqPop(UCx_INDEX, &ucxTxPend)) return;
+	if(devConf[UCx_INDEX] != ucxTxPend.commID){
+		UCx_TX_SWITCH_SYNC();
+		if(UCx_TX_SENDING()){
+			usciStat[UCx_INDEX] = TX;	// Hold the module until the last byte is out
+			ucxTxSwitch = 1;
+			UCx_TX_SWITCH_ARM();
+			return;
+		}
+	}
+	ucxTxStart();
+}
+/**************************************************************************//**
+ * \brief	Starts the queued write removed by ucxTxNext()
+ ******************************************************************************/
+static void ucxTxStart(void)
+{
+	ucxTxSwitch = 0;
+	usciStat[UCx_INDEX] = OPEN;
+#ifdef USCI_SPI
+	spixWrite(ucxTxPend.data, ucxTxPend.len, ucxTxPend.commID);
+#else
+	uartxWrite(ucxTxPend.data, ucxTxPend.len, ucxTxPend.commID);
+#endif // USCI_SPI
+}
+#endif // USE_USCI_TXQUEUE
+#ifdef USE_USCI_DMA
+/**************************************************************************//**
+ * \brief	Ends a DMA driven transfer of the USCI module
+ *
+ * Called from usciDmaIsr() when the module owns the DMA engine. Updates the
+ * buffer sizes as the module ISR would have on the end of its transfer and
+ * returns the module to interrupt driven operation. A transmit only transfer
+ * completes with its last byte still waiting in TXBUF, so the TX interrupt
+ * ends it (as on an interrupt driven write) once that byte has moved on.
+ ******************************************************************************/
+static void ucxDmaDone(void)
+{
+	unsigned int rxLen = dmaRxLen;
+
+	ucxTxSize = 0;
+	if(!rxLen){					// Transmit only: TXBUF still loaded, TXIFG follows
+		dmaStop();
+#ifndef USCI_UART
+		UCxIFG &= ~UCRXIFG;			// (Bytes clocked in while the RX interrupt was masked)
+#endif // USCI_UART
+		UCxIE |= UCRXIE + UCTXIE;
+		return;
+	}
+	ucxRxPtr += rxLen;
+	ucxRxSize += rxLen;
+	UCxIFG &= ~(UCTXIFG + UCRXIFG);
+	UCxIE |= UCRXIE + UCTXIE;
+	usciStat[UCx_INDEX] = OPEN;
+	dmaStop();
+	USCI_PROF_DONE(UCx_INDEX);
+	USCI_EVENT(UCx_INDEX, onRxDone);
+	UCx_TX_NEXT();
+}
+#endif // USE_USCI_DMA
+#ifdef USCI_I2C
+/**********************************************************************//**
+ * \brief	USCI I2C Master Interrupt Service Routine
+ *
+ * Runs the whole I2C transaction once started: loads each byte to be
+ * written, turns the bus around with a repeated start (i2cxTransfer()),
+ * stores each byte read and requests the stop condition while the last one
+ * is being received. A slave NACK of the address or of a data byte ends the
+ * transaction with a stop condition. The status returns to OPEN on the stop
+ * condition interrupt, once the bus has been released.
+ *************************************************************************/
+USCI_PRAGMA(vector=UCx_VECTOR)
+__interrupt void uscixIsr(void)
+{
+	unsigned char stat;
+
+	USCI_PROF_ENTER(UCx_INDEX);
+	switch(__even_in_range(UCxIV, USCI_I2C_IVMAX)){
+	case USCI_I2C_UCNACKIFG:				// Slave NACKed the address or a data byte
+		UCxCTL1 |= UCTXSTP;				// Release the bus
+		usciStat[UCx_INDEX] = STOP;
+		USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], nacks, 1);
+		USCI_ERROR(UCx_INDEX, USCI_ERR_NACK);
+		break;
+	case USCI_I2C_UCSTPIFG:					// Stop condition sent: transaction over
+		stat = usciStat[UCx_INDEX];
+		if(stat == RX && ucxRxSize < ucxToRxSize && (UCxIFG & UCRXIFG)){
+			*(ucxRxPtr++) = UCxRXBUF;		// Last byte not yet serviced (the stop vector has priority)
+			UCx_RXCRC(*(ucxRxPtr - 1));
+			ucxRxSize++;
+		}
+		usciStat[UCx_INDEX] = OPEN;
+		USCI_PROF_DONE(UCx_INDEX);
+		if(stat == TX) USCI_EVENT(UCx_INDEX, onTxDone);
+		else if(stat == RX) USCI_EVENT(UCx_INDEX, onRxDone);
+		USCI_WAKE(UCx_INDEX);
+		break;
+	case USCI_I2C_RXIV:					// Byte received
+		if(usciStat[UCx_INDEX] == RX && ucxRxSize < ucxToRxSize){
+			*(ucxRxPtr++) = UCxRXBUF;
+			UCx_RXCRC(*(ucxRxPtr - 1));
+			if(++ucxRxSize == ucxToRxSize - 1) UCxCTL1 |= UCTXSTP;	// Last byte under way: NACK it and stop
+		}
+		break;
+	case USCI_I2C_TXIV:					// TXBUF empty (start sent or byte under way)
+#ifdef USE_USCI_REGS
+		if(usciStat[UCx_INDEX] == REG){
+			UCxTXBUF = ucxReg;			// Register address ahead of the data
+			usciStat[UCx_INDEX] = TX;
+			break;
+		}
+#endif // USE_USCI_REGS
+		if(usciStat[UCx_INDEX] != TX) break;
+		if(ucxTxSize){
+			UCx_TXCRC(*ucxTxPtr);
+			UCxTXBUF = *(ucxTxPtr++);		// Transmit the next outgoing byte
+			ucxTxSize--;
+		}
+		else if(ucxToRxSize){
+			usciStat[UCx_INDEX] = RX;		// Turn the bus around with a repeated start
+			ucxI2cStartRx();
+		}
+		else UCxCTL1 |= UCTXSTP;			// Stop once the last byte is out
+		break;
+	default:
+		break;
+	}
+	USCI_PROF_EXIT(UCx_INDEX);
+}
+#else
+/**********************************************************************//**
+ * \brief	USCI RX/TX Interrupt Service Routine
+ *
+ * This ISR manages all TX/RX proceedures with the exception of transfer
+ * initialization. Once a transfer (read or write) is underway, this method
+ * assures the correct amount of bytes are written to the correct location.
+ *************************************************************************/
+USCI_PRAGMA(vector=UCx_VECTOR)
+__interrupt void uscixIsr(void)
+{
+#ifdef USCI_SPI
+	unsigned int dummy = 0xFF;
+#endif // USCI_SPI
+	unsigned int err;
+#ifdef USCI_RXRING
+	unsigned int head;
+#endif // USCI_RXRING
+
+	USCI_PROF_ENTER(UCx_INDEX);
+	// Transmit Interrupt Flag Set
+	if(UCx_TX_PENDING()){
+#ifndef USCI_UART
+		if(usciStat[UCx_INDEX] == TX){
+#endif // USCI_UART
+#ifdef USCI_FLOW
+		if(ucxFlow && UCx_TX_MORE && ucxCtsPause(0)){	// Peer not ready: TX interrupt masked until CTS
+		}
+		else
+#endif // USCI_FLOW
+#ifdef USCI_FRAMING
+		if(ucxFraming && ucxFrameTx()){		// Next byte of the frame (payload, code, escape or delimiter)
+		}
+		else
+#endif // USCI_FRAMING
+		if(ucxTxSize > 0){
+			UCxTXBUF = *(++ucxTxPtr);		// Transmit the next outgoing byte
+			UCx_TXCRC(*ucxTxPtr);
+			ucxTxSize--;
+		}
+#ifdef USE_USCI_IOVEC
+		else if(ucxTxSegLeft){				// Move on to the next segment
+			ucxTxPtr = ucxTxSeg->data;
+			ucxTxSize = ucxTxSeg->len - 1;
+			ucxTxSeg++;
+			ucxTxSegLeft--;
+			UCx_TXCRC(*ucxTxPtr);
+			UCxTXBUF = *ucxTxPtr;
+		}
+#endif // USE_USCI_IOVEC
+		else{
+			usciStat[UCx_INDEX] = OPEN; 		// Set status open if done with transmit
+			UCxIFG &= ~UCTXIFG;			// Clear TX interrupt flag from vector on end of TX
+			USCI_PROF_DONE(UCx_INDEX);
+			USCI_EVENT(UCx_INDEX, onTxDone);
+			UCx_TX_NEXT();
+			USCI_WAKE(UCx_INDEX);
+		}
+#ifndef USCI_UART
+		}
+#ifdef USE_USCI_REGS
+		else if(usciStat[UCx_INDEX] == REG && !ucxToRxSize){	// Register write: data follows the address
+			usciStat[UCx_INDEX] = TX;
+			UCx_TXCRC(*ucxTxPtr);
+			UCxTXBUF = *ucxTxPtr;
+		}
+#endif // USE_USCI_REGS
+#ifdef USCI_STREAM
+		else if(usciStat[UCx_INDEX] == STREAM && (UCxIE & UCTXIE)){	// Stream start: second byte queued behind the first
+			UCxIE &= ~UCTXIE;
+			UCxTXBUF = 0xFF;
+		}
+#endif // USCI_STREAM
+		else UCxIFG &= ~UCTXIFG;			// Clear TX interrupt flag when not transmitting
+#endif // USCI_UART
+	}
+
+	// Receive Interrupt Flag Set
+	if(UCxIFG & UCRXIFG){
+#ifdef USCI_UART
+		UCx_IDLE_RESTART();
+		err = UCxSTAT;
+#ifdef USCI_AUTOBAUD
+		if(ucxAutoBaud && ((err & UCBRK) || (UCxABCTL & (UCBTOE + UCSTOE)))){	// Sync field after a break (or timeout)
+			(void)UCxRXBUF;				// Drop the sync byte (clears UCBRK)
+			ucxBaudDetect();
+		}
+		else
+#endif // USCI_AUTOBAUD
+		if(err & UCRXERR){				// RX ERROR: Do a dummy read to clear interrupt flag
+			(void)UCxRXBUF;
+			USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxErrors, 1);
+			USCI_ERROR(UCx_INDEX, err);
+		}
+		else {						// Otherwise write the value to the RX pointer
+#ifdef USCI_FRAMING
+			if(ucxFraming){				// Framed app: decode on the fly (onRxDone once per frame)
+				ucxFrameRx(UCxRXBUF);
+				USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxBytes, 1);
+			}
+			else{
+#endif // USCI_FRAMING
+#ifdef USCI_RXRING
+			head = ucxRxHead;
+			if((unsigned int)(head - ucxRxTail) < UCx_RXRING_SIZE){	// Store unless the ring is full
+				ucxRxRing[head & (UCx_RXRING_SIZE - 1)] = UCxRXBUF;
+				UCx_RXCRC(ucxRxRing[head & (UCx_RXRING_SIZE - 1)]);
+				ucxRxHead = head + 1;		// Publish the byte to the reader
+			}
+			else{
+				(void)UCxRXBUF;			// Ring full: drop the byte
+				ucxRxOverflow++;
+				USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxErrors, 1);
+				USCI_ERROR(UCx_INDEX, USCI_ERR_RXRING);
+			}
+#else
+			*(ucxRxPtr++) = UCxRXBUF;
+			UCx_RXCRC(*(ucxRxPtr - 1));
+			ucxRxSize++;				// RX Size decrement in read function
+			usciStat[UCx_INDEX] = OPEN;
+#endif // USCI_RXRING
+			UCx_RX_THROTTLE();
+			USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxBytes, 1);
+			USCI_EVENT(UCx_INDEX, onRxDone);
+#ifdef USCI_FRAMING
+			}
+#endif // USCI_FRAMING
+		}
+#else
+#ifdef USCI_STREAM
+		if(usciStat[UCx_INDEX] == STREAM){	// Streaming read: store and keep clocking
+			ucxStreamRx();
+		}
+		else
+#endif // USCI_STREAM
+		if(usciStat[UCx_INDEX] == RX || usciStat[UCx_INDEX] == XFER){	// Check we are in RX (or transfer) mode
+			err = UCxSTAT;
+			if(err & UCRXERR){			// RX ERROR: Do a dummy read to clear interrupt flag
+				dummy = UCxRXBUF;
+				USCI_STAT(UCx_INDEX, devConf[UCx_INDEX], rxErrors, 1);
+				USCI_ERROR(UCx_INDEX, err);
+			}
+			else {					// Otherwise write the value to the RX pointer
+				*(ucxRxPtr++) = UCxRXBUF;
+				UCx_RXCRC(*(ucxRxPtr - 1));
+				ucxRxSize++;			// RX Size decrement in read function
+#ifdef USE_USCI_IOVEC
+				if(ucxRxSegLeft && --ucxRxSegSize == 0){	// Segment full: move on to the next
+					ucxRxPtr = ucxRxSeg->data;
+					ucxRxSegSize = ucxRxSeg->len;
+					ucxRxSeg++;
+					ucxRxSegLeft--;
+				}
+#endif // USE_USCI_IOVEC
+				if(ucxRxSize < ucxToRxSize){
+					UCxTXBUF = (usciStat[UCx_INDEX] == XFER) ? *(++ucxTxPtr) : dummy; // Write the next byte (or another dummy)
+					if(usciStat[UCx_INDEX] == XFER) UCx_TXCRC(*ucxTxPtr);
+				}
+				else{
+					usciStat[UCx_INDEX] = OPEN;
+					USCI_PROF_DONE(UCx_INDEX);
+					USCI_EVENT(UCx_INDEX, onRxDone);
+					UCx_TX_NEXT();
+					USCI_WAKE(UCx_INDEX);
+				}
+			}
+		}
+#ifdef USE_USCI_REGS
+		else if(usciStat[UCx_INDEX] == REG && ucxToRxSize){	// Register read: drop the byte clocked in with the address
+			usciStat[UCx_INDEX] = RX;
+			UCxTXBUF = dummy;
+			dummy = UCxRXBUF;
+		}
+#endif // USE_USCI_REGS
+		else{
+			UCxIFG &= ~UCRXIFG;			// Clear RX interrupt flag when not receiving
+#ifdef USE_USCI_TXQUEUE
+			if(ucxTxSwitch) ucxTxStart();	// Last byte received: write of the next app
+#endif // USE_USCI_TXQUEUE
+#ifdef USE_USCI_LPM
+			if(usciStat[UCx_INDEX] == SWAP){	// End of spixSwap() byte
+				ucxSwapDone = 1;
+				USCI_WAKE(UCx_INDEX);
+			}
+#endif // USE_USCI_LPM
+		}
+#endif // USCI_UART
+	}
+#if defined(USCI_UART) && !defined(USCI_RXRING)	// (RXBUF reads clear the flag, clearing here could drop a byte arriving meanwhile)
+	UCxIFG &= ~UCRXIFG;	// Clear RX interrupt flag from vector on end of RX
+#endif // USCI_UART && !USCI_RXRING
+#if defined(USCI_UART) && defined(USE_USCI_TXQUEUE)
+	if(ucxTxSwitch && (UCxIFG & UCTXCPTIFG)){	// Last byte sent: write of the next app
+		UCxIE &= ~UCTXCPTIE;
+		ucxTxStart();
+	}
+#endif // USCI_UART && USE_USCI_TXQUEUE
+	USCI_PROF_EXIT(UCx_INDEX);
+}
+#endif // USCI_I2C
+
+// End of instantiation: release the module parameters for the next one
+#undef UCx_TX_NEXT
+#undef UCx_TXCPT_CLEAR
+#undef UCx_TX_SENDING
+#undef UCx_TX_SWITCH_ARM
+#undef UCx_TX_SWITCH_SYNC
+#undef UCx_CRC_START
+#undef UCx_IDLE_RESTART
+#undef UCx_RX_UNREAD
+#undef UCx_TX_MORE
+#undef UCx_TX_PENDING
+#undef UCx_CTS_HOLD
+#undef UCx_RX_THROTTLE
+#undef UCx_RX_RELEASE
+#undef UCx_CTLW0_IMAGE
+#undef USCI_FLOW
+#undef USCI_AUTOBAUD
+#undef USCI_STREAM
+#undef USCI_RXRING
+#undef USCI_FRAMING
+#undef USCI_IDLE
+#undef USCI_UART
+#undef USCI_SPI
+#undef USCI_I2C
+#undef USCI_X
+#undef USCI_x
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * UART automatic baud rate test (USE_UART_AUTOBAUD): a peer running at
+ * another rate sends a break + sync field to UART A0, then a message. Each
+ * case checks that the rate locks to the peer (UCA0BRW/UCA0MCTLW and the
+ * app config), that the sync byte is dropped and the message received:
+ *
+ *	test=<name> brw= mctlw= bytes= result=PASS|FAIL
+ *
+ * The lock is checked without and with oversampling, then the measured rate
+ * must survive a reconfiguration by another app and back. Returns non-zero
+ * when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define PEER_BRW	833		///< Peer at 9600 baud (8 MHz, no oversampling)
+#define PEER_OS16_BRW	52		///< Peer at 9600 baud (8 MHz, oversampling)
+#define PEER_OS16_MCTLW	(UCOS16 + 0x0010)	///< Peer at 9600 baud (8 MHz, oversampling, UCBRF 1)
+#define MSG_LEN		6		///< Bytes of the message following the sync field
+
+unsigned char rxA0[64];			///< UART A0 receive buffer
+usciConfig autoConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, USCI_OPT_AUTOBAUD, 0};
+usciConfig autoOs16Conf = {UCA0_UART, UART_8N1, DEF_CTLW1, 4, rxA0, USCI_OPT_AUTOBAUD, UCOS16 + 0x0050};
+usciConfig plainConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, 0, 0};
+
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Sends a break + sync field and a message at the peer rate
+ *
+ * \param	*msg	Message following the sync field
+ * \param	brw	Baud rate divisor of the peer
+ * \param	mctlw	Modulation control word of the peer
+ * \param	commID	Communication ID of the receiving app
+ * \return	Bytes received by the app (sync byte excluded)
+ ******************************************************************************/
+static unsigned int peerSend(const unsigned char *msg, unsigned int brw, unsigned int mctlw, int commID)
+{
+	unsigned int n;
+
+	usciSimBreak(USIM_A0, brw, mctlw);
+	usciSimFeed(USIM_A0, msg, MSG_LEN);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = getUCA0RxSize();
+	uartA0Read(n, commID);				// (The bytes stay in rxA0, from its start once the app is configured)
+	return n;
+}
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	bytes	Bytes received by the app
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int bytes, int ok)
+{
+	printf("test=%s brw=%u mctlw=0x%04X bytes=%u result=%s\n", name, UCA0BRW, UCA0MCTLW, bytes, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char msg[MSG_LEN] = {'L', 'O', 'C', 'K', 0x55, 0x00};
+	unsigned int n;
+	int autoId, os16Id, plain, ok;
+
+	usciSimReset();
+	__enable_interrupt();
+	autoId = registerComm(&autoConf);
+	os16Id = registerComm(&autoOs16Conf);
+	plain = registerComm(&plainConf);
+
+	// Lock: the module measures the peer rate, the app config follows
+	confUCA0(autoId);
+	ok = uartA0BaudLocked() == 0;
+	n = peerSend(msg, PEER_BRW, 0, autoId);
+	caseEnd("autobaudLock", n, ok && uartA0BaudLocked() == 1 && uartA0BaudLocked() == 0 && UCA0BRW == PEER_BRW &&
+		autoConf.baudDiv == PEER_BRW && autoConf.mctlw == UCA0MCTLW && n == MSG_LEN && !memcmp(rxA0, msg, MSG_LEN));
+
+	// Oversampling: UCBRx and UCBRFx measured
+	memset(rxA0, 0, sizeof(rxA0));
+	confUCA0(os16Id);
+	n = peerSend(msg, PEER_OS16_BRW, PEER_OS16_MCTLW, os16Id);
+	caseEnd("autobaudLockOs16", n, uartA0BaudLocked() == 1 && UCA0BRW == PEER_OS16_BRW &&
+		(UCA0MCTLW & (UCOS16 + 0x00F0)) == PEER_OS16_MCTLW && autoOs16Conf.baudDiv == PEER_OS16_BRW &&
+		n == MSG_LEN && !memcmp(rxA0, msg, MSG_LEN));
+
+	// Reconfiguration: the measured rate is kept by the app
+	confUCA0(plain);
+	ok = UCA0BRW == SIM_UART_BRW;
+	confUCA0(autoId);
+	caseEnd("autobaudKeep", 0, ok && UCA0BRW == PEER_BRW && uartA0BaudLocked() == 0);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * UART baud rate generator test: UART_BRW()/UART_MCTLW() for every common
+ * baud rate at each clkInit() frequency (timing.h), against the plain
+ * UBR_DIV() divisor. The error is the worst accumulated bit error over a 10
+ * bit frame (start, 8 data, stop), in % of a bit, with the bit lengths the
+ * eUSCI (and the simulator) generate: BRW cycles, or 16 * UCBRx + UCBRFx with
+ * UCOS16, plus one cycle where the UCBRSx pattern bit is set. One line per
+ * rate, then the old/new table:
+ *
+ *	baud clk= baud= n= brw= mctlw= err_old= err_new= budget=yes|no result=PASS|FAIL|SKIP
+ *
+ * The modulated error must never exceed the plain divisor error. With
+ * N = clk / baud >= 16 (UCOS16 oversampling) it must also stay within
+ * BAUD_MAX_ERR, the share of the UART timing budget left to the transmitter
+ * (the receiver samples mid bit with up to 1/16 bit of uncertainty, the peer
+ * clock takes the rest). Below N = 16 the bits are whole BRCLK cycles and
+ * the error floor is above that budget (TI lists TX errors of 5-15% for such
+ * pairs), so the error must only stay below one BRCLK cycle (100 / N %) and
+ * is reported with budget=no. Pairs with N < 3 cannot carry a frame (a
+ * single cycle is over a third of a bit) and are skipped. The user guide
+ * examples and a 10 byte burst on the simulated UART A0 are checked as well.
+ * Returns non-zero on any failure.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define BAUD_CLKS	6		///< Number of clkInit() frequencies
+#define BAUD_RATES	7		///< Number of baud rates
+#define BAUD_FRAME	10		///< Bits per frame (8N1)
+#define BAUD_MAX_ERR	5.0		///< Transmitter share of the timing budget (% of a bit, accumulated over the frame)
+#define BAUD_MIN_N	3		///< Lowest usable clk / baud ratio
+#define BAUD_OS16_N	16		///< Lowest clk / baud ratio with UCOS16 oversampling
+
+static const unsigned long clk[BAUD_CLKS] = {1000000, 4000000, 8000000, 16000000, 20000000, 24000000};
+static const unsigned long baud[BAUD_RATES] = {9600, 19200, 38400, 57600, 115200, 230400, 460800};
+static double errOld[BAUD_CLKS][BAUD_RATES];	///< Error of UBR_DIV() (% of a bit)
+static double errNew[BAUD_CLKS][BAUD_RATES];	///< Error of UART_BRW()/UART_MCTLW() (% of a bit)
+static int fails = 0;				///< Number of failed checks
+
+unsigned char rx[16];				///< UART A0 receive buffer (unused)
+usciConfig uartConf = {UCA0_UART, UART_8N1, DEF_CTLW1, 0, rx, 0};
+
+/**************************************************************************//**
+ * \brief	Length of one bit as generated by the eUSCI_A
+ *
+ * \param	brw	UCAxBRW
+ * \param	mctlw	UCAxMCTLW
+ * \param	bit	Bit of the frame (0 for the start bit)
+ * \return	The bit length in clock cycles
+ ******************************************************************************/
+static unsigned long bitCycles(unsigned int brw, unsigned int mctlw, unsigned char bit)
+{
+	unsigned long len = brw;
+
+	if(mctlw & UCOS16) len = 16UL * brw + ((mctlw >> 4) & 0x0F);
+	if((mctlw >> 8) & (0x80 >> (bit & 0x07))) len++;
+	return len;
+}
+/**************************************************************************//**
+ * \brief	Worst accumulated bit error over a frame
+ *
+ * \param	c	Clock frequency (Hz)
+ * \param	b	Baud rate
+ * \param	brw	UCAxBRW
+ * \param	mctlw	UCAxMCTLW
+ * \return	The largest error of a bit end (% of an ideal bit)
+ ******************************************************************************/
+static double frameError(unsigned long c, unsigned long b, unsigned int brw, unsigned int mctlw)
+{
+	double ideal = (double)c / b, err, worst = 0;
+	unsigned long t = 0;
+	unsigned char bit;
+
+	for(bit = 0; bit < BAUD_FRAME; bit++){
+		t += bitCycles(brw, mctlw, bit);
+		err = (t - (bit + 1) * ideal) * 100.0 / ideal;
+		if(err < 0) err = -err;
+		if(err > worst) worst = err;
+	}
+	return worst;
+}
+/**************************************************************************//**
+ * \brief	Checks a generated register pair against the user guide
+ *
+ * \param	c	Clock frequency (Hz)
+ * \param	b	Baud rate
+ * \param	brw	Expected UCAxBRW
+ * \param	mctlw	Expected UCAxMCTLW
+ ******************************************************************************/
+static void checkUg(unsigned long c, unsigned long b, unsigned int brw, unsigned int mctlw)
+{
+	int ok = UART_BRW(c, b) == brw && UART_MCTLW(c, b) == mctlw;
+
+	printf("ug clk=%lu baud=%lu brw=%lu mctlw=0x%04lX result=%s\n", c, b,
+		(unsigned long)UART_BRW(c, b), (unsigned long)UART_MCTLW(c, b), ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char data[10] = "0123456789";
+	unsigned char out[USIM_BUF_SIZE];
+	unsigned long c, b, frame;
+	double n;
+	unsigned int brw, mctlw, i, j;
+	usciSimStats s0, s1;
+	unsigned char bit;
+	int commID, ok;
+
+	for(i = 0; i < BAUD_CLKS; i++){
+		for(j = 0; j < BAUD_RATES; j++){
+			c = clk[i];
+			b = baud[j];
+			brw = UART_BRW(c, b);
+			mctlw = UART_MCTLW(c, b);
+			errOld[i][j] = frameError(c, b, c / b, 0);
+			errNew[i][j] = frameError(c, b, brw, mctlw);
+			n = (double)c / b;
+			if(n < BAUD_MIN_N){
+				printf("baud clk=%lu baud=%lu n=%.2f result=SKIP\n", c, b, n);
+				continue;
+			}
+			ok = errNew[i][j] <= errOld[i][j] && errNew[i][j] < (n < BAUD_OS16_N ? 100.0 / n : BAUD_MAX_ERR);
+			printf("baud clk=%lu baud=%lu n=%.2f brw=%u mctlw=0x%04X err_old=%.1f err_new=%.1f budget=%s result=%s\n",
+				c, b, n, brw, mctlw, errOld[i][j], errNew[i][j], errNew[i][j] < BAUD_MAX_ERR ? "yes" : "no", ok ? "PASS" : "FAIL");
+			if(!ok) fails++;
+		}
+	}
+	checkUg(1000000, 9600, 6, 0x2081);
+	checkUg(8000000, 115200, 4, 0x5551);
+
+	// Simulated burst: the bus time must follow the modulated bit lengths
+	usciSimReset();
+	__enable_interrupt();
+	uartConf.baudDiv = UART_BRW(8000000UL, 230400UL);
+	uartConf.mctlw = UART_MCTLW(8000000UL, 230400UL);
+	commID = registerComm(&uartConf);
+	for(frame = 0, bit = 0; bit < BAUD_FRAME; bit++) frame += bitCycles(uartConf.baudDiv, uartConf.mctlw, bit);
+	usciSimGetStats(USIM_A0, &s0);
+	uartA0Write(data, sizeof(data), commID);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimGetStats(USIM_A0, &s1);
+	ok = usciSimDrain(USIM_A0, out, sizeof(out)) == sizeof(data) && !memcmp(out, data, sizeof(data))
+		&& s1.busCycles - s0.busCycles == frame * sizeof(data);
+	printf("sim clk=8000000 baud=230400 bytes=%u bus_cycles=%lu ideal_cycles=%.0f result=%s\n", (unsigned int)sizeof(data),
+		s1.busCycles - s0.busCycles, sizeof(data) * BAUD_FRAME * 8000000.0 / 230400, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+
+	// Old/new table (% of a bit)
+	printf("%-6s", "clk");
+	for(j = 0; j < BAUD_RATES; j++) printf(" %12lu", baud[j]);
+	printf("\n");
+	for(i = 0; i < BAUD_CLKS; i++){
+		printf("%-6lu", clk[i] / 1000000);
+		for(j = 0; j < BAUD_RATES; j++) printf(" %5.1f/%-6.1f", errOld[i][j], errNew[i][j]);
+		printf("\n");
+	}
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
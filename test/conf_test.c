@@ -0,0 +1,135 @@
+/******************************************************************************
+ * App switch test (USE_USCI_CONST_CONF): const configs, the RAM they save and
+ * the cost of a commID switch. The switch cost is the number of module
+ * register accesses made by confUCxx() (USIM_ACCESS_CYCLES each, interrupts
+ * held off), then the ISR entries and accesses of the interrupts the switch
+ * leaves pending, for a switch between UART apps at different rates and
+ * between SPI apps sharing the mode and clock:
+ *
+ *	switch case= accesses= cycles= isr= isr_accesses= result=PASS|FAIL
+ *	ram apps= config_bytes= table_bytes= saved_bytes=
+ *
+ * RAM figures are for the MSP430 small model (2 byte pointers): each const
+ * config leaves RAM, the rate table of USE_USCI_CONST_CONF is added. A switch
+ * must only write the registers that differ between the two apps, and writes
+ * made after each switch must use the rate of the new app. Returns non-zero
+ * when a check fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define CONF_APPS		4	///< Registered apps
+#ifdef USE_UART_AUTOBAUD
+#define CONF_MAX_SWITCH		5	///< Highest acceptable register accesses of a switch with a rate change (reset, BRW, ABCTL, release, IE)
+#else
+#define CONF_MAX_SWITCH		4	///< Highest acceptable register accesses of a switch with a rate change (reset, BRW, release, IE)
+#endif // USE_UART_AUTOBAUD
+#define CONF_MAX_SAME		1	///< Highest acceptable register accesses of a switch to identical registers (IE)
+
+unsigned char rx[CONF_APPS][16];	///< Receive buffers
+const usciConfig conf[CONF_APPS] = {
+	{.rAddr = UCA0_UART, .usciCtlW0 = UART_8N1, .usciCtlW1 = DEF_CTLW1, .baudDiv = 69, .rxPtr = rx[0]},
+	{.rAddr = UCA0_UART, .usciCtlW0 = UART_8N1, .usciCtlW1 = DEF_CTLW1, .baudDiv = 833, .rxPtr = rx[1]},
+	{.rAddr = UCB0_SPI + 1, .usciCtlW0 = SPI_8M0_BE, .usciCtlW1 = DEF_CTLW1, .baudDiv = 2, .rxPtr = rx[2]},
+	{.rAddr = UCB0_SPI + 2, .usciCtlW0 = SPI_8M0_BE, .usciCtlW1 = DEF_CTLW1, .baudDiv = 2, .rxPtr = rx[3]},
+};
+static int fails = 0;			///< Number of failed checks
+extern unsigned int devBrw[MAX_DEVS+1];		// Rate table of comm.c
+#ifdef USE_UART_AUTOBAUD
+extern unsigned int devMctlw[MAX_DEVS+1];
+#endif // USE_UART_AUTOBAUD
+
+/**************************************************************************//**
+ * \brief	Size of a usciConfig on the MSP430 small model
+ *
+ * \return	The size in bytes (2 byte pointers, word aligned)
+ ******************************************************************************/
+static unsigned int msp430ConfBytes(void)
+{
+	unsigned int bytes = 7 * 2;		// rAddr, usciCtlW0, usciCtlW1, baudDiv, rxPtr, opts, mctlw
+#ifdef USE_USCI_CALLBACKS
+	bytes += 3 * 2;				// onTxDone, onRxDone, onError
+#endif // USE_USCI_CALLBACKS
+#ifdef USE_UART_IDLE
+	bytes += 2;				// idleBits
+#ifdef USE_USCI_CALLBACKS
+	bytes += 2;				// onRxIdle
+#endif // USE_USCI_CALLBACKS
+#endif // USE_UART_IDLE
+#ifdef USE_USCI_PRIORITY
+	bytes += 2;				// priority (padded)
+#endif // USE_USCI_PRIORITY
+	return bytes;
+}
+/**************************************************************************//**
+ * \brief	Switches a module to an app and checks the cost and the rate
+ *
+ * \param	*name	Name of the case
+ * \param	mod	The simulated module
+ * \param	commID	Comm ID of the app to switch to
+ * \param	brw	Expected UCxBRW after the switch
+ * \param	max	Highest acceptable number of register accesses
+ ******************************************************************************/
+static void checkSwitch(const char *name, unsigned char mod, int commID, unsigned int brw, unsigned long max)
+{
+	usciSimStats s0, s1, s2;
+	unsigned long access;
+	int ok;
+
+	__disable_interrupt();
+	usciSimGetStats(mod, &s0);
+	if(mod == USIM_A0) confUCA0(commID);
+	else confUCB0(commID);
+	usciSimGetStats(mod, &s1);
+	__enable_interrupt();
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimGetStats(mod, &s2);
+	access = s1.regAccess - s0.regAccess;
+	ok = access <= max && *usciSimReg(mod, USIM_BRW) == brw;
+	printf("switch case=%s accesses=%lu cycles=%lu isr=%lu isr_accesses=%lu result=%s\n", name, access, access * USIM_ACCESS_CYCLES,
+		s2.isrEntries - s1.isrEntries, s2.regAccess - s1.regAccess, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char data[2] = {0xA5, 0x5A};
+	unsigned char out[USIM_BUF_SIZE];
+	int commID[CONF_APPS];
+	usciSimStats s0, s1;
+	unsigned int i, table;
+	int ok;
+
+	usciSimReset();
+	__enable_interrupt();
+	for(i = 0; i < CONF_APPS; i++) commID[i] = registerComm(&conf[i]);
+
+	checkSwitch("uart_first", USIM_A0, commID[0], 69, 99);
+	checkSwitch("uart_rate", USIM_A0, commID[1], 833, CONF_MAX_SWITCH);
+	checkSwitch("uart_back", USIM_A0, commID[0], 69, CONF_MAX_SWITCH);
+	checkSwitch("spi_first", USIM_B0, commID[2], 2, 99);
+	checkSwitch("spi_same", USIM_B0, commID[3], 2, CONF_MAX_SAME);
+
+	// A write after the switch runs at the rate of the new app
+	usciSimGetStats(USIM_A0, &s0);
+	uartA0Write(data, sizeof(data), commID[1]);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimGetStats(USIM_A0, &s1);
+	ok = usciSimDrain(USIM_A0, out, sizeof(out)) == sizeof(data) && !memcmp(out, data, sizeof(data))
+		&& s1.busCycles - s0.busCycles == sizeof(data) * 10 * 833UL;
+	printf("switch case=uart_write bus_cycles=%lu result=%s\n", s1.busCycles - s0.busCycles, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+
+	table = sizeof(devBrw);
+#ifdef USE_UART_AUTOBAUD
+	table += sizeof(devMctlw);
+#endif // USE_UART_AUTOBAUD
+	table = table / sizeof(unsigned int) * 2;	// MSP430 words
+	printf("ram apps=%u config_bytes=%u table_bytes=%u saved_bytes=%d\n", CONF_APPS, msp430ConfBytes(), table,
+		(int)(CONF_APPS * msp430ConfBytes()) - (int)table);
+	if(CONF_APPS * msp430ConfBytes() <= table) fails++;
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
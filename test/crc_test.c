@@ -0,0 +1,147 @@
+/******************************************************************************
+ * Streaming CRC test (USE_USCI_CRC): apps registered with USCI_OPT_CRC write
+ * and read on UART A0, SPI B0 and I2C B1 (against the simulated slave). Each
+ * case checks the CRC-16-CCITT computed by the ISRs for the bytes sent and
+ * received against the reference value:
+ *
+ *	test=<name> bytes= tx_crc= rx_crc= result=PASS|FAIL
+ *
+ * The check cases send and receive "123456789" (CRC-16-CCITT check value
+ * 0x29B1), the block cases a 64 byte block against a bitwise reference. The
+ * UART block is received with its own (big endian) CRC appended, which must
+ * check to 0, and an app without USCI_OPT_CRC reads USCI_CRC_SEED. Returns
+ * non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define SIM_SPI_BRW	2		///< SPI bit clock of SMCLK / 2
+#define SIM_I2C_BRW	20		///< I2C bit clock of SMCLK / 20
+#define SIM_I2C_ADDR	0x50		///< Address of the simulated I2C slave
+#define CRC_CHECK	0x29B1		///< CRC-16-CCITT (0xFFFF seed) of "123456789"
+#define BLOCK_LEN	64		///< Bytes of the block cases
+
+unsigned char rxA0[128];		///< UART A0 receive buffer
+unsigned char rxB0[128];		///< SPI B0 receive buffer
+unsigned char rxB1[128];		///< I2C B1 receive buffer
+usciConfig uartConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, USCI_OPT_CRC};
+usciConfig spiConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0, USCI_OPT_CRC};
+usciConfig i2cConf = {UCB1_I2C + SIM_I2C_ADDR, I2C_7SMT, DEF_CTLW1, SIM_I2C_BRW, rxB1, USCI_OPT_CRC};
+usciConfig plainConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0, 0};
+
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Bitwise CRC-16-CCITT reference (polynomial 0x1021, MSB first)
+ *
+ * \param	*data	Bytes to be covered
+ * \param	len	Number of bytes
+ * \return	The CRC, starting from USCI_CRC_SEED
+ ******************************************************************************/
+static unsigned int crcRef(const unsigned char *data, unsigned int len)
+{
+	unsigned int crc = USCI_CRC_SEED, i, b;
+
+	for(i = 0; i < len; i++){
+		crc ^= data[i] << 8;
+		for(b = 0; b < 8; b++) crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) & 0xFFFF : (crc << 1) & 0xFFFF;
+	}
+	return crc;
+}
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	bytes	Bytes sent or received
+ * \param	tx	CRC of the bytes sent
+ * \param	rx	CRC of the bytes received
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int bytes, unsigned int tx, unsigned int rx, int ok)
+{
+	printf("test=%s bytes=%u tx_crc=0x%04X rx_crc=0x%04X result=%s\n", name, bytes, tx, rx, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char check[9] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	unsigned char block[BLOCK_LEN + 2], out[USIM_BUF_SIZE];
+	unsigned int i, n, tx, rx, ref;
+	int uart, spi, i2c, plain;
+
+	for(i = 0; i < BLOCK_LEN; i++) block[i] = i * 37 + 11;
+	ref = crcRef(block, BLOCK_LEN);
+	block[BLOCK_LEN] = ref >> 8;
+	block[BLOCK_LEN + 1] = ref & 0xFF;
+	usciSimReset();
+	__enable_interrupt();
+	uart = registerComm(&uartConf);
+	spi = registerComm(&spiConf);
+	i2c = registerComm(&i2cConf);
+	plain = registerComm(&plainConf);
+	usciSimI2cSlave(USIM_B1, SIM_I2C_ADDR);
+
+	// UART: the bytes sent are looped back, receive CRC restarted on each read
+	confUCA0(uart);
+	uartA0Write(check, sizeof(check), uart);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	tx = getUCA0TxCrc();
+	usciSimFeed(USIM_A0, out, n);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	rx = getUCA0RxCrc(1);
+	caseEnd("uartA0Check", n, tx, rx, n == sizeof(check) && tx == CRC_CHECK && rx == CRC_CHECK);
+	uartA0Write(block, BLOCK_LEN, uart);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	tx = getUCA0TxCrc();
+	usciSimFeed(USIM_A0, block, BLOCK_LEN + 2);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	rx = getUCA0RxCrc(1);
+	caseEnd("uartA0Block", n, tx, rx, n == BLOCK_LEN && tx == ref && rx == 0);
+
+	// SPI: write, then read the same bytes from the slave
+	spiB0Write(check, sizeof(check), spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	tx = getUCB0TxCrc();
+	usciSimFeed(USIM_B0, check, sizeof(check));
+	spiB0Read(sizeof(check), spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimDrain(USIM_B0, out + n, sizeof(out) - n);
+	rx = getUCB0RxCrc(0);
+	caseEnd("spiB0Check", n, tx, rx, n == sizeof(check) && tx == CRC_CHECK && rx == CRC_CHECK);
+	usciSimFeed(USIM_B0, block, BLOCK_LEN);
+	spiB0Transfer(block, rxB0, BLOCK_LEN, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	tx = getUCB0TxCrc();
+	rx = getUCB0RxCrc(0);
+	caseEnd("spiB0Block", n, tx, rx, n == BLOCK_LEN && tx == ref && rx == ref);
+
+	// I2C: the address bytes are not covered
+	i2cB1Write(check, sizeof(check), i2c);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B1, out, sizeof(out));
+	tx = getUCB1TxCrc();
+	usciSimFeed(USIM_B1, check, sizeof(check));
+	i2cB1Read(sizeof(check), i2c);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	rx = getUCB1RxCrc(0);
+	caseEnd("i2cB1Check", n, tx, rx, n == sizeof(check) && tx == CRC_CHECK && rx == CRC_CHECK &&
+		!memcmp(rxB1, check, sizeof(check)));
+
+	// No USCI_OPT_CRC: the CRCs stay at the seed
+	spiB0Write(check, sizeof(check), plain);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	tx = getUCB0TxCrc();
+	rx = getUCB0RxCrc(0);
+	caseEnd("spiB0NoCrc", n, tx, rx, n == sizeof(check) && tx == USCI_CRC_SEED && rx == USCI_CRC_SEED);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,181 @@
+/******************************************************************************
+ * DMA transfer engine test: the same UART A0 write, SPI B0 write and SPI B0
+ * read run once through the module ISR and once through the DMA controller
+ * (USCI_OPT_DMA), and a line is printed per run with the interrupts and CPU
+ * cycles per byte (module ISR + DMA ISR + DMA cycle stealing):
+ *
+ *	test=<name> mode=isr|dma bytes= isr_per_byte= cpu_per_byte= result=PASS|FAIL
+ *
+ * A DMA run must move the data intact, end with the module OPEN, enter the
+ * ISRs at most 4 times per transfer and use fewer CPU cycles than the ISR
+ * run. The completion cases then check that a write issued as soon as a DMA
+ * write has finished (and one issued right after a DMA read) reaches the bus
+ * intact. Returns non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define SIM_SPI_BRW	2		///< SPI bit clock of SMCLK / 2
+#define DMA_LEN		48		///< Bytes per measured transfer
+#define DMA_ISR_MAX	4		///< ISR entries allowed per DMA transfer (DMA done, TX done, last RX bytes)
+
+unsigned char rxA0[64];			///< UART A0 receive buffer
+unsigned char rxB0[64];			///< SPI B0 receive buffer
+usciConfig uartConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, 0};
+usciConfig uartDmaConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, USCI_OPT_DMA};
+usciConfig spiConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0, 0};
+usciConfig spiDmaConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0, USCI_OPT_DMA};
+
+static usciSimStats before;		///< Module statistics at the start of the run
+static usciSimDmaStats dmaBefore;	///< DMA statistics at the start of the run
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Starts a measured run on a module
+ *
+ * \param	mod	The simulated module
+ ******************************************************************************/
+static void runStart(unsigned char mod)
+{
+	usciSimGetStats(mod, &before);
+	usciSimGetDmaStats(&dmaBefore);
+}
+/**************************************************************************//**
+ * \brief	Ends a measured run and prints its line
+ *
+ * \param	*name	Name of the transfer
+ * \param	dma	Non-zero for the DMA run
+ * \param	mod	The simulated module
+ * \param	stat	Module status after the run (OPEN expected)
+ * \param	*got	Data received by the library or captured from the bus
+ * \param	*want	Expected data
+ * \param	len	Number of bytes of the run
+ * \return	CPU cycles spent on the run
+ ******************************************************************************/
+static unsigned long runEnd(const char *name, int dma, unsigned char mod, unsigned char stat, const unsigned char *got, const unsigned char *want, unsigned int len)
+{
+	usciSimStats s;
+	usciSimDmaStats d;
+	unsigned long isr, cpu;
+	int ok = 1;
+
+	usciSimGetStats(mod, &s);
+	usciSimGetDmaStats(&d);
+	isr = (s.isrEntries - before.isrEntries) + (d.isrEntries - dmaBefore.isrEntries);
+	cpu = (s.isrCycles - before.isrCycles) + (d.isrCycles - dmaBefore.isrCycles) + (d.stallCycles - dmaBefore.stallCycles);
+	if(memcmp(got, want, len) || stat != OPEN) ok = 0;
+	if(dma && (isr > DMA_ISR_MAX || d.transfers == dmaBefore.transfers)) ok = 0;
+	printf("test=%s mode=%s bytes=%u isr_per_byte=%.2f cpu_per_byte=%.1f result=%s\n",
+		name, dma ? "dma" : "isr", len, (double)isr / len, (double)cpu / len, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+	return cpu;
+}
+/**************************************************************************//**
+ * \brief	Checks that the DMA run of a transfer was cheaper than its ISR run
+ *
+ * \param	*name	Name of the transfer
+ * \param	isrCpu	CPU cycles of the ISR run
+ * \param	dmaCpu	CPU cycles of the DMA run
+ ******************************************************************************/
+static void compare(const char *name, unsigned long isrCpu, unsigned long dmaCpu)
+{
+	int ok = dmaCpu < isrCpu;
+
+	printf("test=%s cpu_saved=%.1f%% result=%s\n", name, 100.0 * (isrCpu - (double)dmaCpu) / isrCpu, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+/**************************************************************************//**
+ * \brief	Prints the line of a completion case
+ *
+ * \param	*name	Name of the case
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, int ok)
+{
+	printf("test=%s result=%s\n", name, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char data[DMA_LEN], out[USIM_BUF_SIZE], want[2 * DMA_LEN];
+	unsigned long isrCpu;
+	unsigned int i, n;
+	int uart, uartDma, spi, spiDma, ret;
+
+	for(i = 0; i < DMA_LEN; i++) data[i] = i * 37 + 1;
+	usciSimReset();
+	__enable_interrupt();
+	uart = registerComm(&uartConf);
+	uartDma = registerComm(&uartDmaConf);
+	spi = registerComm(&spiConf);
+	spiDma = registerComm(&spiDmaConf);
+
+	// UART A0 write
+	runStart(USIM_A0);
+	uartA0Write(data, DMA_LEN, uart);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	isrCpu = runEnd("uartA0Write", 0, USIM_A0, getUCA0Stat(), out, data, n == DMA_LEN ? DMA_LEN : 0);
+	runStart(USIM_A0);
+	uartA0Write(data, DMA_LEN, uartDma);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	compare("uartA0Write", isrCpu, runEnd("uartA0Write", 1, USIM_A0, getUCA0Stat(), out, data, n == DMA_LEN ? DMA_LEN : 0));
+
+	// SPI B0 write
+	runStart(USIM_B0);
+	spiB0Write(data, DMA_LEN, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	isrCpu = runEnd("spiB0Write", 0, USIM_B0, getUCB0Stat(), out, data, n == DMA_LEN ? DMA_LEN : 0);
+	runStart(USIM_B0);
+	spiB0Write(data, DMA_LEN, spiDma);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	compare("spiB0Write", isrCpu, runEnd("spiB0Write", 1, USIM_B0, getUCB0Stat(), out, data, n == DMA_LEN ? DMA_LEN : 0));
+
+	// SPI B0 read
+	runStart(USIM_B0);
+	usciSimFeed(USIM_B0, data, DMA_LEN);
+	spiB0Read(DMA_LEN, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimDrain(USIM_B0, out, sizeof(out));
+	isrCpu = runEnd("spiB0Read", 0, USIM_B0, getUCB0Stat(), rxB0, data, getUCB0RxSize() == DMA_LEN ? DMA_LEN : 0);
+	memset(rxB0, 0, sizeof(rxB0));
+	runStart(USIM_B0);
+	usciSimFeed(USIM_B0, data, DMA_LEN);
+	spiB0Read(DMA_LEN, spiDma);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimDrain(USIM_B0, out, sizeof(out));
+	compare("spiB0Read", isrCpu, runEnd("spiB0Read", 1, USIM_B0, getUCB0Stat(), rxB0, data, getUCB0RxSize() == DMA_LEN ? DMA_LEN : 0));
+
+	// Completion: a write accepted as soon as the DMA write releases the module
+	// must not overwrite the last DMA byte still waiting in TXBUF
+	memcpy(want, data, DMA_LEN);
+	memcpy(want + DMA_LEN, data, DMA_LEN);
+	uartA0Write(data, DMA_LEN, uartDma);
+	while((ret = uartA0Write(data, DMA_LEN, uartDma)) == USCI_BUSY_ERROR) usciSimRun(1);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("uartA0BackToBack", ret == 1 && n == 2 * DMA_LEN && !memcmp(out, want, n) && getUCA0Stat() == OPEN);
+
+	spiB0Write(data, DMA_LEN, spiDma);
+	while((ret = spiB0Write(data, DMA_LEN, spiDma)) == USCI_BUSY_ERROR) usciSimRun(1);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0BackToBack", ret == 1 && n == 2 * DMA_LEN && !memcmp(out, want, n) && getUCB0Stat() == OPEN);
+
+	// Completion: a DMA read leaves the module ready for an ISR driven write
+	usciSimFeed(USIM_B0, data, DMA_LEN);
+	spiB0Read(DMA_LEN, spiDma);
+	while((ret = spiB0Write(data, 8, spi)) == USCI_BUSY_ERROR) usciSimRun(1);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0ReadThenWrite", ret == 1 && n == DMA_LEN + 8 && !memcmp(out + DMA_LEN, data, 8) && getUCB0Stat() == OPEN);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+ * UART flow control test (USE_UART_FLOW): an app registered with
+ * USCI_OPT_RTSCTS writes on UART A0 while the simulated peer drives CTS, and
+ * receives from a peer honouring RTS. Each case checks the bytes seen on
+ * each side of the pause and that no byte is lost:
+ *
+ *	test=<name> bytes= held= result=PASS|FAIL
+ *
+ * held is the number of bytes that crossed the line while paused: none for
+ * a write started with CTS deasserted, at most the character under way and
+ * the one in TXBUF when CTS drops during a write, and at most UART_RTS_STOP
+ * plus the character under way before RTS stops the peer. Returns non-zero
+ * when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define BYTE_CYCLES	(10 * SIM_UART_BRW)	///< Cycles per 8N1 byte
+#define HOLD_CYCLES	(40 * BYTE_CYCLES)	///< Cycles run while paused
+#define TX_LEN		20		///< Bytes per write
+#define RX_LEN		100		///< Bytes fed by the peer
+
+unsigned char rxA0[128];		///< UART A0 receive buffer
+usciConfig uartConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, USCI_OPT_RTSCTS};
+
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	bytes	Bytes of the case
+ * \param	held	Bytes that crossed the line while paused
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int bytes, unsigned int held, int ok)
+{
+	usciSimStats s;
+
+	usciSimGetStats(USIM_A0, &s);
+	if(s.overruns) ok = 0;
+	printf("test=%s bytes=%u held=%u result=%s\n", name, bytes, held, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char tx[TX_LEN], in[RX_LEN], out[USIM_BUF_SIZE];
+	unsigned int i, n, held, total;
+	int uart, ret, ok;
+
+	for(i = 0; i < TX_LEN; i++) tx[i] = 0x40 + i;
+	for(i = 0; i < RX_LEN; i++) in[i] = i * 5 + 3;
+	usciSimReset();
+	__enable_interrupt();
+	usciSimFlow(USIM_A0, UCA0_RTS_PIN, UCA0_CTS_PIN);
+	uart = registerComm(&uartConf);
+	confUCA0(uart);
+
+	// CTS hold: a write started with CTS deasserted waits for it
+	usciSimCts(USIM_A0, 0);
+	ret = uartA0Write(tx, TX_LEN, uart);
+	usciSimRun(HOLD_CYCLES);
+	held = usciSimDrain(USIM_A0, out, sizeof(out));
+	ok = ret == 1 && getUCA0Stat() != OPEN;
+	usciSimCts(USIM_A0, 1);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("ctsHold", n, held, ok && !held && n == TX_LEN && !memcmp(out, tx, n) && getUCA0Stat() == OPEN);
+
+	// CTS release: CTS drops during a write, the rest follows its return
+	ret = uartA0Write(tx, TX_LEN, uart);
+	usciSimRun(5 * BYTE_CYCLES);
+	usciSimCts(USIM_A0, 0);
+	usciSimRun(2 * BYTE_CYCLES);
+	held = usciSimDrain(USIM_A0, out, sizeof(out));
+	usciSimRun(HOLD_CYCLES);
+	n = usciSimDrain(USIM_A0, out + held, sizeof(out) - held);
+	ok = ret == 1 && !n && held >= 5 && held <= 7 && getUCA0Stat() != OPEN;
+	usciSimCts(USIM_A0, 1);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = held + usciSimDrain(USIM_A0, out + held, sizeof(out) - held);
+	caseEnd("ctsRelease", n, held, ok && n == TX_LEN && !memcmp(out, tx, n) && getUCA0Stat() == OPEN);
+
+	// RTS: the peer stops at UART_RTS_STOP unread bytes, reading below UART_RTS_GO resumes it
+	usciSimFeed(USIM_A0, in, RX_LEN);
+	usciSimRun(HOLD_CYCLES * 2);
+	held = getUCA0RxSize();
+	ok = held >= UART_RTS_STOP && held <= UART_RTS_STOP + 1 && (P1OUT & UCA0_RTS_PIN);
+	total = uartA0Read(held - UART_RTS_GO, uart);
+	ok = ok && !(P1OUT & UCA0_RTS_PIN);
+	for(i = 0; i < RX_LEN && total < RX_LEN; i++){	// Each read lets the peer send up to UART_RTS_STOP more
+		usciSimRun(HOLD_CYCLES);
+		if(getUCA0RxSize() > UART_RTS_STOP + 1) ok = 0;
+		total += uartA0Read(getUCA0RxSize(), uart);
+	}
+	caseEnd("rtsStop", total, held, ok && total == RX_LEN && !memcmp(rxA0, in, RX_LEN) && !(P1OUT & UCA0_RTS_PIN));
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
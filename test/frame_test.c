@@ -0,0 +1,171 @@
+/******************************************************************************
+ * UART framing test (USE_USCI_FRAMING): payloads are written on UART A0 by a
+ * COBS app and by a SLIP app, the bytes seen on the bus are checked against
+ * a reference encoder, then fed back to the module and the decoded frame is
+ * checked against the payload (built with USCI_FRAME_MAX 256):
+ *
+ *	test=<name> bytes= wire= result=PASS|FAIL
+ *
+ * The payloads cover a full 254 byte COBS block, a block running past it,
+ * runs of 0x00, SLIP_END (0xC0) and SLIP_ESC (0xDB), and a frame longer than
+ * USCI_FRAME_MAX (dropped with the next frame still decoded). Returns
+ * non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define WIRE_MAX	(2 * USCI_FRAME_MAX + 4)	///< Largest encoded frame of the cases (SLIP, every byte escaped)
+
+unsigned char rxA0[2 * USCI_FRAME_MAX];	///< UART A0 receive buffer (two frame halves)
+usciConfig cobsConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, USCI_OPT_COBS};
+usciConfig slipConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, USCI_OPT_SLIP};
+
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Reference COBS encoder (0x00 delimiter appended)
+ *
+ * \param	*out	Destination of the encoded frame
+ * \param	*data	Payload
+ * \param	len	Length of the payload
+ * \return	Length of the encoded frame
+ ******************************************************************************/
+static unsigned int cobsEncode(unsigned char *out, const unsigned char *data, unsigned int len)
+{
+	unsigned int n = 1, code = 0, i;
+
+	for(i = 0; i < len; i++){
+		if(data[i]){
+			out[n++] = data[i];
+			if(n - code == 0xFF && i + 1 < len){	// Full block, no zero (none opened at the end)
+				out[code] = 0xFF;
+				code = n++;
+			}
+		}
+		else{
+			out[code] = n - code;
+			code = n++;
+		}
+	}
+	out[code] = n - code;
+	out[n++] = 0;
+	return n;
+}
+/**************************************************************************//**
+ * \brief	Reference SLIP encoder (opening and closing END)
+ *
+ * \param	*out	Destination of the encoded frame
+ * \param	*data	Payload
+ * \param	len	Length of the payload
+ * \return	Length of the encoded frame
+ ******************************************************************************/
+static unsigned int slipEncode(unsigned char *out, const unsigned char *data, unsigned int len)
+{
+	unsigned int n = 0, i;
+
+	out[n++] = SLIP_END;
+	for(i = 0; i < len; i++){
+		if(data[i] == SLIP_END){
+			out[n++] = SLIP_ESC;
+			out[n++] = SLIP_ESC_END;
+		}
+		else if(data[i] == SLIP_ESC){
+			out[n++] = SLIP_ESC;
+			out[n++] = SLIP_ESC_ESC;
+		}
+		else out[n++] = data[i];
+	}
+	out[n++] = SLIP_END;
+	return n;
+}
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*enc	Framing name, prefixed to the name of the case
+ * \param	*name	Name of the case
+ * \param	bytes	Length of the payload
+ * \param	wire	Bytes seen on the bus
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *enc, const char *name, unsigned int bytes, unsigned int wire, int ok)
+{
+	printf("test=%s%s bytes=%u wire=%u result=%s\n", enc, name, bytes, wire, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+/**************************************************************************//**
+ * \brief	Sends a payload, checks the encoded bytes, feeds them back and
+ * 		checks the decoded frame, then prints the line of the case
+ *
+ * \param	*enc	Framing name, prefixed to the name of the case
+ * \param	*name	Name of the case
+ * \param	*data	Payload
+ * \param	len	Length of the payload
+ * \param	commID	Communication ID of the framed app
+ ******************************************************************************/
+static void roundTrip(const char *enc, const char *name, unsigned char *data, unsigned int len, int commID)
+{
+	unsigned char want[WIRE_MAX], out[USIM_BUF_SIZE], *frame = 0;
+	unsigned int n, wire, got;
+	int ret, ok;
+
+	wire = (*enc == 'c') ? cobsEncode(want, data, len) : slipEncode(want, data, len);
+	ret = uartA0Write(data, len, commID);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	ok = ret == 1 && n == wire && !memcmp(out, want, n);
+	usciSimFeed(USIM_A0, out, n);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	got = uartA0GetFrame(&frame);
+	ok = ok && got == len && frame && !memcmp(frame, data, len) && getUCA0Stat() == OPEN;
+	uartA0ReleaseFrame();
+	caseEnd(enc, name, len, n, ok);
+}
+
+int main(void)
+{
+	unsigned char specials[12] = {0x00, 0x11, SLIP_END, 0x00, 0x00, SLIP_ESC, SLIP_ESC_END, SLIP_ESC_ESC, SLIP_ESC, SLIP_END, 0x22, 0x00};
+	unsigned char data[USCI_FRAME_MAX + 1], out[USIM_BUF_SIZE], want[WIRE_MAX], *frame = 0;
+	const char *encs[2] = {"cobs", "slip"};
+	unsigned int i, n, wire, got;
+	int ids[2], k, ok;
+
+	usciSimReset();
+	__enable_interrupt();
+	ids[0] = registerComm(&cobsConf);
+	ids[1] = registerComm(&slipConf);
+
+	for(k = 0; k < 2; k++){
+		confUCA0(ids[k]);
+		roundTrip(encs[k], "Specials", specials, sizeof(specials), ids[k]);
+		for(i = 0; i < 255; i++) data[i] = i + 1;
+		roundTrip(encs[k], "NonZero254", data, 254, ids[k]);
+		roundTrip(encs[k], "NonZero255", data, 255, ids[k]);
+		data[254] = 0x00;
+		data[255] = 0x33;
+		roundTrip(encs[k], "Block254Zero", data, 256, ids[k]);
+		memset(data, 0x00, 254);
+		roundTrip(encs[k], "Zeros254", data, 254, ids[k]);
+		memset(data, SLIP_END, 254);
+		roundTrip(encs[k], "Ends254", data, 254, ids[k]);
+		memset(data, SLIP_ESC, 254);
+		roundTrip(encs[k], "Escs254", data, 254, ids[k]);
+
+		// Too long: the frame is dropped up to its delimiter, the next one decodes
+		for(i = 0; i < USCI_FRAME_MAX + 1; i++) data[i] = i * 3 + 1;
+		wire = k ? slipEncode(want, data, USCI_FRAME_MAX + 1) : cobsEncode(want, data, USCI_FRAME_MAX + 1);
+		usciSimFeed(USIM_A0, want, wire);
+		wire = k ? slipEncode(want, specials, sizeof(specials)) : cobsEncode(want, specials, sizeof(specials));
+		usciSimFeed(USIM_A0, want, wire);
+		usciSimIdle(USIM_LPM_TIMEOUT);
+		got = uartA0GetFrame(&frame);
+		ok = got == sizeof(specials) && frame && !memcmp(frame, specials, got);
+		uartA0ReleaseFrame();
+		n = usciSimDrain(USIM_A0, out, sizeof(out));
+		caseEnd(encs[k], "TooLong", USCI_FRAME_MAX + 1, n, ok && !n);
+	}
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
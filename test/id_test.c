@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Comm ID test (unregisterComm): apps register, unregister and re-register
+ * on UART A0 and SPI B0. Each case checks the comm IDs issued, the return
+ * codes of the calls made with them and the bytes seen on the bus:
+ *
+ *	test=<name> id= bytes= result=PASS|FAIL
+ *
+ * The first registrations get the slot numbers (unchanged IDs for static
+ * apps). An unregistered ID is refused with USCI_ID_ERROR by every call,
+ * including after its slot was reused by a new registration under a new ID,
+ * while the new ID works. Unregistering an app with a transfer running is
+ * refused, and unregistering the configured app holds its module in reset.
+ * Returns non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define SIM_SPI_BRW	2		///< SPI bit clock of SMCLK / 2
+#define MSG_LEN		8		///< Bytes per write
+
+unsigned char rxA0[64];			///< UART A0 receive buffer
+unsigned char rxB0[64];			///< SPI B0 receive buffer
+usciConfig uartConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0};
+usciConfig uart2Conf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0};
+usciConfig spiConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0};
+
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	id	Comm ID under test
+ * \param	bytes	Bytes seen on the bus
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, int id, unsigned int bytes, int ok)
+{
+	printf("test=%s id=0x%04X bytes=%u result=%s\n", name, (unsigned int)id, bytes, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char msg[MSG_LEN] = {0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80};
+	unsigned char out[USIM_BUF_SIZE];
+	unsigned int n;
+	int uart, spi, stale, uart2, ok;
+
+	usciSimReset();
+	__enable_interrupt();
+
+	// Static registrations: the slot numbers
+	uart = registerComm(&uartConf);
+	spi = registerComm(&spiConf);
+	caseEnd("firstIds", spi, 0, uart == 1 && spi == 2);
+
+	// Stale: refused after unregisterComm(), and after the slot is reused
+	ok = uartA0Write(msg, MSG_LEN, uart) == 1;
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	ok = ok && n == MSG_LEN && unregisterComm(uart) == 1;
+	stale = uart;
+	ok = ok && uartA0Write(msg, MSG_LEN, stale) == USCI_ID_ERROR && uartA0Read(1, stale) == USCI_ID_ERROR &&
+		unregisterComm(stale) == USCI_ID_ERROR;
+	uart2 = registerComm(&uart2Conf);
+	ok = ok && uart2 > 0 && uart2 != stale && (uart2 & ((1 << USCI_SLOT_BITS) - 1)) == (stale & ((1 << USCI_SLOT_BITS) - 1));
+	ok = ok && uartA0Write(msg, MSG_LEN, stale) == USCI_ID_ERROR && unregisterComm(stale) == USCI_ID_ERROR;
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("staleId", stale, n, ok && n == 0);
+
+	// Reissued: the new ID of the slot works
+	ok = uartA0Write(msg, MSG_LEN, uart2) == 1;
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("newId", uart2, n, ok && n == MSG_LEN && !memcmp(out, msg, n) && getUCA0Stat() == OPEN);
+
+	// Unknown: IDs never issued
+	caseEnd("unknownId", MAX_DEVS + 1, 0, spiB0Write(msg, MSG_LEN, 0) == USCI_ID_ERROR &&
+		spiB0Write(msg, MSG_LEN, MAX_DEVS + 1) == USCI_ID_ERROR && unregisterComm(MAX_DEVS + 1) == USCI_ID_ERROR);
+
+	// Busy: refused while the app transfer runs, then the module is held in reset
+	ok = spiB0Write(msg, MSG_LEN, spi) == 1 && unregisterComm(spi) == USCI_BUSY_ERROR;
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	ok = ok && n == MSG_LEN && unregisterComm(spi) == 1 && (UCB0CTLW0 & UCSWRST) && spiB0Write(msg, MSG_LEN, spi) == USCI_ID_ERROR;
+	caseEnd("busyThenReleased", spi, n, ok);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * UART idle-line timeout test (USE_UART_IDLE): bytes are clocked into UART
+ * A0 for an app with a 35 bit time timeout, and the cycle at which the
+ * onRxIdle hook fires is measured from the start of the bytes:
+ *
+ *	test=<name> bytes= idle_events= idle_cycles= result=PASS|FAIL
+ *
+ * The timeout must fire once per message, idleBits bit times (within one bit)
+ * after the last byte, and not between bytes closer than the timeout. An app
+ * without idleBits never sees the line go idle. Returns non-zero when a case
+ * fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define IDLE_BITS	35		///< Modbus 3.5 character gap at 8N1
+#define BYTE_CYCLES	(10 * SIM_UART_BRW)	///< Cycles per 8N1 byte
+#define IDLE_CYCLES	(IDLE_BITS * SIM_UART_BRW)	///< Cycles of the idle timeout
+#define MSG_LEN		8		///< Bytes per message
+#define RUN_CYCLES	20000		///< Cycles run per case (past the timeout)
+
+static void onIdle(unsigned int commID);
+
+unsigned char rxA0[64];			///< UART A0 receive buffer
+usciConfig idleConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, 0, 0, 0, 0, 0, IDLE_BITS, onIdle};
+usciConfig plainConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0, 0, 0, 0, 0, 0, 0, onIdle};
+
+static unsigned long start = 0;		///< Simulated cycle of the start of the case
+static unsigned long idleAt = 0;	///< Cycle of the first idle event of the case
+static unsigned int events = 0;		///< Idle events of the case
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Idle hook, records the cycle of the event
+ *
+ * \param	commID	Communication ID of the app
+ ******************************************************************************/
+static void onIdle(unsigned int commID)
+{
+	(void)commID;
+	if(!events++) idleAt = usciSimCycles() - start;
+}
+/**************************************************************************//**
+ * \brief	Starts a case
+ *
+ * \param	commID	App receiving the bytes of the case
+ ******************************************************************************/
+static void caseStart(int commID)
+{
+	confUCA0(commID);
+	uartA0Read(getUCA0RxSize(), commID);	// Drop the bytes of the previous case
+	start = usciSimCycles();
+	idleAt = 0;
+	events = 0;
+}
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	bytes	Bytes fed to the module
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int bytes, int ok)
+{
+	printf("test=%s bytes=%u idle_events=%u idle_cycles=%lu result=%s\n", name, bytes, events, idleAt, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char msg[2 * MSG_LEN] = "idle-line test!";
+	unsigned long end;
+	int idle, plain, ok;
+
+	usciSimReset();
+	__enable_interrupt();
+	idle = registerComm(&idleConf);
+	plain = registerComm(&plainConf);
+
+	// Message: one event, IDLE_CYCLES after the last byte
+	caseStart(idle);
+	usciSimFeed(USIM_A0, msg, MSG_LEN);
+	usciSimRun(RUN_CYCLES);
+	end = MSG_LEN * BYTE_CYCLES + IDLE_CYCLES;
+	ok = uartA0RxIdle() == 1 && uartA0RxIdle() == 0;
+	caseEnd("idleMessage", MSG_LEN, ok && events == 1 && idleAt + SIM_UART_BRW >= end && idleAt <= end + SIM_UART_BRW &&
+		getUCA0RxSize() == MSG_LEN && !memcmp(rxA0, msg, MSG_LEN));
+
+	// Short gap: a pause under the timeout does not end the message
+	caseStart(idle);
+	usciSimFeed(USIM_A0, msg, MSG_LEN);
+	usciSimRun(MSG_LEN * BYTE_CYCLES + IDLE_CYCLES / 2);
+	usciSimFeed(USIM_A0, msg + MSG_LEN, MSG_LEN);
+	usciSimRun(RUN_CYCLES);
+	end = 2 * MSG_LEN * BYTE_CYCLES + IDLE_CYCLES / 2 + IDLE_CYCLES;
+	caseEnd("idleShortGap", 2 * MSG_LEN, uartA0RxIdle() == 1 && events == 1 && idleAt + SIM_UART_BRW >= end &&
+		idleAt <= end + SIM_UART_BRW && getUCA0RxSize() == 2 * MSG_LEN);
+
+	// Two messages: a pause over the timeout ends each
+	caseStart(idle);
+	usciSimFeed(USIM_A0, msg, MSG_LEN);
+	usciSimRun(MSG_LEN * BYTE_CYCLES + 2 * IDLE_CYCLES);
+	ok = uartA0RxIdle() == 1;
+	usciSimFeed(USIM_A0, msg + MSG_LEN, MSG_LEN);
+	usciSimRun(RUN_CYCLES);
+	caseEnd("idleTwoMessages", 2 * MSG_LEN, ok && uartA0RxIdle() == 1 && events == 2 && getUCA0RxSize() == 2 * MSG_LEN);
+
+	// No idleBits: the line never goes idle
+	caseStart(plain);
+	usciSimFeed(USIM_A0, msg, MSG_LEN);
+	usciSimRun(RUN_CYCLES);
+	caseEnd("idleOff", MSG_LEN, uartA0RxIdle() == 0 && events == 0 && getUCA0RxSize() == MSG_LEN);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Scatter-gather test (USE_USCI_IOVEC): segment lists are written on UART A0
+ * and SPI B0 and read on SPI B0. Each case checks the bytes seen on the bus
+ * (or stored in the segments) across the segment boundaries:
+ *
+ *	test=<name> segments= bytes= result=PASS|FAIL
+ *
+ * The lists mix 1 byte segments (first, inner and last) with longer ones.
+ * The invalid case checks that an empty list and a zero length segment are
+ * rejected with USCI_CONF_ERROR. Returns non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define SIM_SPI_BRW	2		///< SPI bit clock of SMCLK / 2
+
+unsigned char rxA0[64];			///< UART A0 receive buffer
+unsigned char rxB0[64];			///< SPI B0 receive buffer
+usciConfig uartConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0};
+usciConfig spiConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0};
+
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	count	Number of segments
+ * \param	bytes	Bytes seen on the bus
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int count, unsigned int bytes, int ok)
+{
+	printf("test=%s segments=%u bytes=%u result=%s\n", name, count, bytes, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char hdr[1] = {0xA5}, addr[3] = {0x10, 0x20, 0x30}, cmd[1] = {0x5A};
+	unsigned char payload[5] = {0x01, 0x02, 0x03, 0x04, 0x05};
+	unsigned char data[8] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+	unsigned char want[16], out[USIM_BUF_SIZE];
+	unsigned char r0[2], r1[1], r2[5];
+	usciSegment wr[5] = {{hdr, 1}, {addr, 3}, {cmd, 1}, {payload, 5}, {hdr, 1}};
+	usciSegment rd[3] = {{r0, 2}, {r1, 1}, {r2, 5}};
+	usciSegment bad[2] = {{hdr, 1}, {addr, 0}};
+	unsigned int n;
+	int uart, spi, ret;
+
+	memcpy(want, hdr, 1);
+	memcpy(want + 1, addr, 3);
+	memcpy(want + 4, cmd, 1);
+	memcpy(want + 5, payload, 5);
+	memcpy(want + 10, hdr, 1);
+	usciSimReset();
+	__enable_interrupt();
+	uart = registerComm(&uartConf);
+	spi = registerComm(&spiConf);
+
+	ret = uartA0WriteV(wr, 5, uart);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("uartA0WriteV", 5, n, ret == 1 && n == 11 && !memcmp(out, want, n) && getUCA0Stat() == OPEN);
+
+	ret = spiB0WriteV(wr, 5, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0WriteV", 5, n, ret == 1 && n == 11 && !memcmp(out, want, n) && getUCB0Stat() == OPEN);
+
+	ret = spiB0WriteV(&wr[1], 1, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0WriteVSingle", 1, n, ret == 1 && n == 3 && !memcmp(out, addr, n) && getUCB0Stat() == OPEN);
+
+	usciSimFeed(USIM_B0, data, sizeof(data));
+	ret = spiB0ReadV(rd, 3, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0ReadV", 3, n, ret == 1 && n == sizeof(data) && getUCB0RxSize() == sizeof(data) &&
+		!memcmp(r0, data, 2) && r1[0] == data[2] && !memcmp(r2, data + 3, 5) && getUCB0Stat() == OPEN);
+
+	ret = (uartA0WriteV(wr, 0, uart) == USCI_CONF_ERROR) && (spiB0WriteV(bad, 2, spi) == USCI_CONF_ERROR) &&
+		(spiB0ReadV(bad, 2, spi) == USCI_CONF_ERROR);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out)) + usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("invalid", 2, n, ret && n == 0);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
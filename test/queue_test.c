@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Transmit queue test (USE_USCI_TXQUEUE): writes issued while a module is
+ * busy are queued and chained by the ISR. Each case checks the return codes
+ * and the bytes seen on the bus:
+ *
+ *	test=<name> writes= bytes= result=PASS|FAIL
+ *
+ * uartFifo queues writes of three apps on UART A0 (sent in call order),
+ * uartFull fills the queue (the next write is rejected), zeroLength checks
+ * that zero length writes are rejected (and not queued), spiSwitch queues a
+ * write of a second SPI app (other bit clock) on B0, which must complete
+ * after the running write, spiSwitchSlow does the same behind a write at a
+ * slow bit clock (UCBUSY still set when the last byte is received) and
+ * spiReadThenWrite chains a write of a second app behind an SPI read.
+ *
+ * Built with USE_USCI_PRIORITY (prio_test), the FIFO cases run with equal
+ * priorities (ties keep the call order), then uartPriority queues writes of
+ * a low, a mid and a high priority app (started high first) and uartAging
+ * keeps a high priority app queueing while a low priority write waits (it
+ * must start after three high priority writes). Returns non-zero when a
+ * case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define SIM_SPI_BRW	2		///< SPI bit clock of SMCLK / 2
+#define SIM_SPI2_BRW	4		///< SPI bit clock of the second SPI app (SMCLK / 4)
+#define SIM_SPI_SLOW_BRW	64		///< SPI bit clock of the slow SPI app (SMCLK / 64)
+#define MSG_LEN		10		///< Bytes per queued write
+#ifdef USE_USCI_PRIORITY
+#define PRIO_MID	(USCI_TXQ_AGE_STEP + 4)		///< Priority of the mid priority app
+#define PRIO_HIGH	(2 * USCI_TXQ_AGE_STEP + 8)	///< Priority of the high priority app (passed by the low one after 3 agings)
+#define POLL_CYCLES	100		///< Cycles between polls of the aging case
+#endif // USE_USCI_PRIORITY
+
+unsigned char rxA0[64];			///< UART A0 receive buffer
+unsigned char rxB0[64];			///< SPI B0 receive buffer
+usciConfig uartConf[3] = {
+	{UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0},
+	{UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0},
+	{UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0}};
+usciConfig spiConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0};
+usciConfig spi2Conf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI2_BRW, rxB0};
+usciConfig spiSlowConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_SLOW_BRW, rxB0};
+#ifdef USE_USCI_PRIORITY
+static const unsigned char agingOrder[6] = {0, 2, 3, 4, 1, 2};	///< Messages of the aging case in line order (low priority one is msg[1])
+#endif // USE_USCI_PRIORITY
+
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	writes	Writes issued by the case
+ * \param	bytes	Bytes seen on the bus
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int writes, unsigned int bytes, int ok)
+{
+	printf("test=%s writes=%u bytes=%u result=%s\n", name, writes, bytes, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char msg[USCI_TXQ_SIZE + 1][MSG_LEN], want[(USCI_TXQ_SIZE + 1) * MSG_LEN], out[USIM_BUF_SIZE];
+	unsigned char data[8] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+	int uart[3], spi, spi2, spiSlow, ret[USCI_TXQ_SIZE + 2];
+	unsigned int i, n;
+#ifdef USE_USCI_PRIORITY
+	unsigned int k;
+#endif // USE_USCI_PRIORITY
+	int ok;
+
+	for(i = 0; i < USCI_TXQ_SIZE + 1; i++) memset(msg[i], 'A' + i, MSG_LEN);
+	usciSimReset();
+	__enable_interrupt();
+	for(i = 0; i < 3; i++) uart[i] = registerComm(&uartConf[i]);
+	spi = registerComm(&spiConf);
+	spi2 = registerComm(&spi2Conf);
+	spiSlow = registerComm(&spiSlowConf);
+
+	// FIFO: writes of three apps leave in call order
+	for(i = 0; i < 3; i++){
+		ret[i] = uartA0Write(msg[i], MSG_LEN, uart[i]);
+		memcpy(want + i * MSG_LEN, msg[i], MSG_LEN);
+	}
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("uartFifo", 3, n, ret[0] == 1 && ret[1] == USCI_QUEUED && ret[2] == USCI_QUEUED &&
+		n == 3 * MSG_LEN && !memcmp(out, want, n) && getUCA0Stat() == OPEN);
+
+	// Full: USCI_TXQ_SIZE writes queue behind the running one, the next is rejected
+	ok = 1;
+	for(i = 0; i < USCI_TXQ_SIZE + 1; i++){
+		ret[i] = uartA0Write(msg[i], MSG_LEN, uart[i % 3]);
+		memcpy(want + i * MSG_LEN, msg[i], MSG_LEN);
+		if(ret[i] != (i ? USCI_QUEUED : 1)) ok = 0;
+	}
+	ret[i] = uartA0Write(msg[0], MSG_LEN, uart[0]);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("uartFull", USCI_TXQ_SIZE + 2, n, ok && ret[i] == USCI_BUSY_ERROR &&
+		n == (USCI_TXQ_SIZE + 1) * MSG_LEN && !memcmp(out, want, n) && getUCA0Stat() == OPEN);
+
+	// Zero length: rejected by an idle module and never queued behind a running write
+	ret[0] = uartA0Write(msg[0], 0, uart[0]);
+	ret[1] = uartA0Write(msg[0], MSG_LEN, uart[0]);
+	ret[2] = uartA0Write(msg[1], 0, uart[1]);
+	ret[3] = spiB0Write(msg[0], 0, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("zeroLength", 4, n, ret[0] == USCI_CONF_ERROR && ret[1] == 1 && ret[2] == USCI_CONF_ERROR &&
+		ret[3] == USCI_CONF_ERROR && n == MSG_LEN && !memcmp(out, msg[0], MSG_LEN) && getUCA0Stat() == OPEN);
+
+	// Switch: a queued write of a second SPI app reconfigures the module and completes
+	ret[0] = spiB0Write(msg[0], MSG_LEN, spi);
+	ret[1] = spiB0Write(msg[1], MSG_LEN, spi2);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiSwitch", 2, n, ret[0] == 1 && ret[1] == USCI_QUEUED && n == 2 * MSG_LEN &&
+		!memcmp(out, msg[0], MSG_LEN) && !memcmp(out + MSG_LEN, msg[1], MSG_LEN) &&
+		UCB0BRW == SIM_SPI2_BRW && getUCB0Stat() == OPEN);
+
+	// Slow switch: the write of the second app starts once the slow last byte is in
+	ret[0] = spiB0Write(msg[1], MSG_LEN, spiSlow);
+	ret[1] = spiB0Write(msg[2], MSG_LEN, spi2);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiSwitchSlow", 2, n, ret[0] == 1 && ret[1] == USCI_QUEUED && n == 2 * MSG_LEN &&
+		!memcmp(out, msg[1], MSG_LEN) && !memcmp(out + MSG_LEN, msg[2], MSG_LEN) &&
+		UCB0BRW == SIM_SPI2_BRW && getUCB0Stat() == OPEN);
+
+	// Read then write: the queued write starts on the end of the SPI read
+	usciSimFeed(USIM_B0, data, sizeof(data));
+	ret[0] = spiB0Read(sizeof(data), spi);
+	ret[1] = spiB0Write(msg[2], MSG_LEN, spi2);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiReadThenWrite", 2, n, ret[0] == 1 && ret[1] == USCI_QUEUED && n == sizeof(data) + MSG_LEN &&
+		!memcmp(rxB0, data, sizeof(data)) && !memcmp(out + sizeof(data), msg[2], MSG_LEN) && getUCB0Stat() == OPEN);
+
+#ifdef USE_USCI_PRIORITY
+	// Priority: queued writes start highest priority first
+	uartConf[0].priority = 0;
+	uartConf[1].priority = PRIO_MID;
+	uartConf[2].priority = PRIO_HIGH;
+	ret[0] = uartA0Write(msg[0], MSG_LEN, uart[0]);
+	for(i = 1; i < 4; i++) ret[i] = uartA0Write(msg[i], MSG_LEN, uart[i - 1]);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("uartPriority", 4, n, ret[0] == 1 && ret[1] == USCI_QUEUED && ret[2] == USCI_QUEUED && ret[3] == USCI_QUEUED &&
+		n == 4 * MSG_LEN && !memcmp(out, msg[0], MSG_LEN) && !memcmp(out + MSG_LEN, msg[3], MSG_LEN) &&
+		!memcmp(out + 2 * MSG_LEN, msg[2], MSG_LEN) && !memcmp(out + 3 * MSG_LEN, msg[1], MSG_LEN) && getUCA0Stat() == OPEN);
+
+	// Aging: a high priority write is queued as each one starts, the low one still gets through
+	ok = uartA0Write(msg[0], MSG_LEN, uart[0]) == 1 && uartA0Write(msg[1], MSG_LEN, uart[0]) == USCI_QUEUED &&
+		uartA0Write(msg[2], MSG_LEN, uart[2]) == USCI_QUEUED;
+	for(i = 0, n = 0, k = 2; i < 1000 && n < 6 * MSG_LEN; i++){
+		usciSimRun(POLL_CYCLES);
+		n += usciSimDrain(USIM_A0, out + n, sizeof(out) - n);
+		if(k < 5 && n > (k - 1) * MSG_LEN){			// The previous high priority write has started
+			if(uartA0Write(msg[k < 4 ? k + 1 : 2], MSG_LEN, uart[2]) != USCI_QUEUED) ok = 0;
+			k++;
+		}
+	}
+	for(i = 0; i < 6; i++) if(memcmp(out + i * MSG_LEN, msg[agingOrder[i]], MSG_LEN)) ok = 0;
+	caseEnd("uartAging", 6, n, ok && n == 6 * MSG_LEN && getUCA0Stat() == OPEN);
+#endif // USE_USCI_PRIORITY
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
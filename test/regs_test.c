@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Register access test (USE_USCI_REGS): register writes and reads on SPI B0
+ * and on I2C B1 (against the simulated slave). Each case checks the bytes
+ * seen on the bus, the bytes stored for a read and, on I2C, that the bus
+ * stayed busy from the first start to the stop (the read turns around with
+ * a repeated start, no stop in between):
+ *
+ *	test=<name> bytes= bus_busy= bus_cycles= result=PASS|FAIL
+ *
+ * Each read runs twice by the same app (the second must not inherit the
+ * receive size of the first), then a register write follows a read.
+ * Returns non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_SPI_BRW	2		///< SPI bit clock of SMCLK / 2
+#define SIM_I2C_BRW	20		///< I2C bit clock of SMCLK / 20
+#define SIM_I2C_ADDR	0x68		///< Address of the simulated I2C slave
+#define REG_LEN		6		///< Data bytes per register access
+#define REG_MAX_CYCLES	1000000		///< Cycle limit of a case
+#define REG_RD_CYCLES	((10 + 9 + 10 + 9 * REG_LEN + 1) * SIM_I2C_BRW)	///< I2C register read bus time (plus under a bit of clock hold)
+
+unsigned char rxB0[64];			///< SPI B0 receive buffer
+unsigned char rxB1[64];			///< I2C B1 receive buffer
+usciConfig spiConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0};
+usciConfig i2cConf = {UCB1_I2C + SIM_I2C_ADDR, I2C_7SMT, DEF_CTLW1, SIM_I2C_BRW, rxB1};
+
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Runs a transfer to its end, counting the I2C bus busy periods
+ *
+ * \param	mod	The simulated module
+ * \param	*stat	Status get method of the module
+ * \param	*bus	Destination for the bus cycles of the transfer
+ * \return	Number of times UCBBUSY was set (1 for a single transaction)
+ ******************************************************************************/
+static unsigned int runBusy(unsigned char mod, unsigned char (*stat)(void), unsigned long *bus)
+{
+	usciSimStats s0, s1;
+	unsigned int busy = 0, was = 0, now;
+	unsigned long n;
+
+	usciSimGetStats(mod, &s0);
+	for(n = 0; n < REG_MAX_CYCLES && (stat() != OPEN || was); n++){
+		usciSimRun(1);
+		now = (*usciSimReg(mod, USIM_STATW) & UCBBUSY) != 0;
+		if(now && !was) busy++;
+		was = now;
+	}
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimGetStats(mod, &s1);
+	*bus = s1.busCycles - s0.busCycles;
+	return busy;
+}
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	bytes	Bytes seen on the bus
+ * \param	busy	Number of bus busy periods (0 for SPI)
+ * \param	bus	Bus cycles of the case
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int bytes, unsigned int busy, unsigned long bus, int ok)
+{
+	printf("test=%s bytes=%u bus_busy=%u bus_cycles=%lu result=%s\n", name, bytes, busy, bus, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char data[REG_LEN] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+	unsigned char in[REG_LEN + 1] = {0xEE, 0xA1, 0xB2, 0xC3, 0xD4, 0xE5, 0xF6};
+	unsigned char want[REG_LEN + 1], out[USIM_BUF_SIZE], buf[REG_LEN];
+	unsigned long bus;
+	unsigned int n, busy, k;
+	int spi, i2c, ret;
+
+	usciSimReset();
+	__enable_interrupt();
+	spi = registerComm(&spiConf);
+	i2c = registerComm(&i2cConf);
+	usciSimI2cSlave(USIM_B1, SIM_I2C_ADDR);
+
+	// SPI: address byte, then the data (the byte clocked in with the address is dropped)
+	want[0] = 0x2A;
+	memcpy(want + 1, data, REG_LEN);
+	ret = spiB0RegWrite(0x2A, data, REG_LEN, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0RegWrite", n, 0, 0, ret == 1 && n == REG_LEN + 1 && !memcmp(out, want, n) && getUCB0Stat() == OPEN);
+	for(k = 0; k < 2; k++){
+		memset(buf, 0, sizeof(buf));
+		usciSimFeed(USIM_B0, in, REG_LEN + 1);
+		ret = spiB0RegRead(0x3B | 0x80, buf, REG_LEN, spi);
+		usciSimIdle(USIM_LPM_TIMEOUT);
+		n = usciSimDrain(USIM_B0, out, sizeof(out));
+		caseEnd(k ? "spiB0RegReadAgain" : "spiB0RegRead", n, 0, 0, ret == 1 && n == REG_LEN + 1 && out[0] == (0x3B | 0x80) &&
+			!memcmp(buf, in + 1, REG_LEN) && getUCB0RxSize() == REG_LEN && getUCB0Stat() == OPEN);
+	}
+	ret = spiB0RegWrite(0x2A, data, REG_LEN, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0RegWriteAfterRead", n, 0, 0, ret == 1 && n == REG_LEN + 1 && !memcmp(out, want, n) && getUCB0Stat() == OPEN);
+
+	// I2C: start + address (W), register byte, then data + stop or repeated start + address (R), data + stop
+	ret = i2cB1RegWrite(0x2A, data, REG_LEN, i2c);
+	busy = runBusy(USIM_B1, getUCB1Stat, &bus);
+	n = usciSimDrain(USIM_B1, out, sizeof(out));
+	caseEnd("i2cB1RegWrite", n, busy, bus, ret == 1 && busy == 1 && n == REG_LEN + 1 && !memcmp(out, want, n) &&
+		bus == (10 + 9 * (REG_LEN + 1) + 1) * SIM_I2C_BRW && getUCB1Stat() == OPEN);
+	for(k = 0; k < 2; k++){
+		memset(buf, 0, sizeof(buf));
+		usciSimFeed(USIM_B1, in + 1, REG_LEN);
+		ret = i2cB1RegRead(0x3B, buf, REG_LEN, i2c);
+		busy = runBusy(USIM_B1, getUCB1Stat, &bus);
+		n = usciSimDrain(USIM_B1, out, sizeof(out));
+		caseEnd(k ? "i2cB1RegReadAgain" : "i2cB1RegRead", n, busy, bus, ret == 1 && busy == 1 && n == 1 && out[0] == 0x3B &&
+			!memcmp(buf, in + 1, REG_LEN) && bus >= REG_RD_CYCLES && bus < REG_RD_CYCLES + SIM_I2C_BRW && getUCB1Stat() == OPEN);
+	}
+	ret = i2cB1RegWrite(0x2A, data, REG_LEN, i2c);
+	busy = runBusy(USIM_B1, getUCB1Stat, &bus);
+	n = usciSimDrain(USIM_B1, out, sizeof(out));
+	caseEnd("i2cB1RegWriteAfterRead", n, busy, bus, ret == 1 && busy == 1 && n == REG_LEN + 1 && !memcmp(out, want, n) &&
+		getUCB1Stat() == OPEN);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * UART receive ring test (USE_UART_RXRING): bytes clocked into UART A0 are
+ * read back through uartA0Read, checking the data, the fill level and the
+ * overflow count:
+ *
+ *	test=<name> bytes= read= dropped= result=PASS|FAIL
+ *
+ * ringWrap reads across the end of the ring storage in several pieces,
+ * ringOverflow fills the ring past its size (the newest bytes are dropped
+ * and counted, the ring keeps working once read) and ringStream receives a
+ * long stream read at a period shorter than the ring fill time without any
+ * loss. Returns non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define STREAM_LEN	4000		///< Bytes of the stream case
+#define STREAM_PERIOD	20000		///< Cycles between reads of the stream case (ring fills in 64 * 690)
+
+unsigned char rxA0[UCA0_RXRING_SIZE];	///< UART A0 application receive buffer
+usciConfig uartConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0};
+
+static unsigned char data[STREAM_LEN];	///< Bytes fed to the module
+static unsigned char got[STREAM_LEN];	///< Bytes read back
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	fed	Bytes fed to the module
+ * \param	read	Bytes read back
+ * \param	dropped	Overflow count added by the case
+ * \param	ok	Non-zero when the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int fed, unsigned int read, unsigned int dropped, int ok)
+{
+	printf("test=%s bytes=%u read=%u dropped=%u result=%s\n", name, fed, read, dropped, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned int i, n, total, over;
+	int uart, ok;
+
+	for(i = 0; i < STREAM_LEN; i++) data[i] = i * 7 + (i >> 8);
+	usciSimReset();
+	__enable_interrupt();
+	uart = registerComm(&uartConf);
+	confUCA0(uart);
+
+	// Wrap: the second block spans the end of the ring storage
+	usciSimFeed(USIM_A0, data, 40);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = uartA0Read(40, uart);
+	ok = n == 40 && !memcmp(rxA0, data, 40);
+	usciSimFeed(USIM_A0, data + 40, 40);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	ok = ok && getUCA0RxSize() == 40;
+	n = uartA0Read(25, uart);
+	ok = ok && n == 25 && !memcmp(rxA0, data + 40, 25);
+	n = uartA0Read(40, uart);
+	ok = ok && n == 15 && !memcmp(rxA0, data + 65, 15);
+	ok = ok && uartA0Read(1, uart) == 0 && getUCA0RxSize() == 0;
+	caseEnd("ringWrap", 80, 80, getUCA0RxOverflow(), ok && getUCA0RxOverflow() == 0);
+
+	// Overflow: the bytes past the ring size are dropped and counted
+	usciSimFeed(USIM_A0, data, UCA0_RXRING_SIZE + 36);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	over = getUCA0RxOverflow();
+	ok = getUCA0RxSize() == UCA0_RXRING_SIZE && over == 36;
+	n = uartA0Read(UCA0_RXRING_SIZE, uart);
+	ok = ok && n == UCA0_RXRING_SIZE && !memcmp(rxA0, data, n);
+	usciSimFeed(USIM_A0, data + 100, 10);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	total = n;
+	n = uartA0Read(UCA0_RXRING_SIZE, uart);
+	total += n;
+	ok = ok && n == 10 && !memcmp(rxA0, data + 100, 10) && getUCA0RxOverflow() == over;
+	caseEnd("ringOverflow", UCA0_RXRING_SIZE + 46, total, over, ok);
+
+	// Stream: read every STREAM_PERIOD cycles while the bytes arrive
+	usciSimFeed(USIM_A0, data, STREAM_LEN);
+	total = 0;
+	for(i = 0; i < 1000 && total < STREAM_LEN; i++){
+		usciSimRun(STREAM_PERIOD);
+		n = uartA0Read(UCA0_RXRING_SIZE, uart);
+		memcpy(got + total, rxA0, n);
+		total += n;
+	}
+	caseEnd("ringStream", STREAM_LEN, total, getUCA0RxOverflow() - over,
+		total == STREAM_LEN && !memcmp(got, data, STREAM_LEN) && getUCA0RxOverflow() == over);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
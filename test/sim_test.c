@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Simulator end-to-end test: UART A0, SPI B0 and I2C B1 transfers run through
+ * the library ISRs on the register simulator. Each case checks the data seen
+ * on the peer side (or received) and prints one line with the ISR entries,
+ * register accesses and bus cycles per byte:
+ *
+ *	test=<name> bytes= isr_per_byte= access_per_byte= bus_per_byte= result=PASS|FAIL
+ *
+ * The bus time of UART and SPI cases must match the frame length exactly,
+ * the ISR entries stay within one per byte plus the start and end events of
+ * the transfer. Returns non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_UART_BRW	69		///< 115200 baud at 8 MHz (no oversampling, no modulation)
+#define SIM_SPI_BRW	2		///< SPI bit clock of SMCLK / 2
+#define SIM_I2C_BRW	20		///< I2C bit clock of SMCLK / 20
+#define SIM_I2C_ADDR	0x50		///< Address of the simulated I2C slave
+
+unsigned char rxA0[64];			///< UART A0 receive buffer
+unsigned char rxB0[64];			///< SPI B0 receive buffer
+unsigned char rxB1[64];			///< I2C B1 receive buffer
+usciConfig uartConf = {UCA0_UART, UART_8N1, DEF_CTLW1, SIM_UART_BRW, rxA0};
+usciConfig spiConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0};
+usciConfig i2cConf = {UCB1_I2C + SIM_I2C_ADDR, I2C_7SMT, DEF_CTLW1, SIM_I2C_BRW, rxB1};
+
+static usciSimStats before;		///< Module statistics at the start of the case
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Starts a test case on a module
+ *
+ * \param	mod	The simulated module
+ ******************************************************************************/
+static void caseStart(unsigned char mod)
+{
+	usciSimGetStats(mod, &before);
+}
+/**************************************************************************//**
+ * \brief	Ends a test case and prints its line
+ *
+ * Runs the simulation until idle, then compares the data and the per byte
+ * figures of the case.
+ *
+ * \param	*name	Name of the case
+ * \param	mod	The simulated module
+ * \param	*got	Data received by the library or captured from the bus
+ * \param	*want	Expected data
+ * \param	len	Number of bytes of the case
+ * \param	frame	Bus cycles per byte (0 to skip the bus time check)
+ * \param	extra	ISR entries allowed on top of one per byte
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned char mod, const unsigned char *got, const unsigned char *want, unsigned int len, unsigned long frame, unsigned int extra)
+{
+	usciSimStats s;
+	unsigned long isr, access, bus;
+	int ok = 1;
+
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimGetStats(mod, &s);
+	isr = s.isrEntries - before.isrEntries;
+	access = s.regAccess - before.regAccess;
+	bus = s.busCycles - before.busCycles;
+	if(memcmp(got, want, len)) ok = 0;
+	if(isr > len + extra) ok = 0;
+	if(frame && bus != frame * len) ok = 0;
+	printf("test=%s bytes=%u isr_per_byte=%.2f access_per_byte=%.2f bus_per_byte=%.1f result=%s\n",
+		name, len, (double)isr / len, (double)access / len, (double)bus / len, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+}
+
+int main(void)
+{
+	unsigned char msg[] = "Hello, world";
+	unsigned char data[8] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+	unsigned char out[USIM_BUF_SIZE];
+	unsigned char swap;
+	int uart, spi, i2c;
+
+	usciSimReset();
+	__enable_interrupt();
+	uart = registerComm(&uartConf);
+	spi = registerComm(&spiConf);
+	i2c = registerComm(&i2cConf);
+	usciSimI2cSlave(USIM_B1, SIM_I2C_ADDR);
+
+	// UART: 10 bit frames (start, 8 data, stop) of SIM_UART_BRW cycles per bit
+	caseStart(USIM_A0);
+	uartA0Write(msg, sizeof(msg) - 1, uart);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimDrain(USIM_A0, out, sizeof(out));
+	caseEnd("uartA0Write", USIM_A0, out, msg, sizeof(msg) - 1, 10 * SIM_UART_BRW, 1);
+
+	caseStart(USIM_A0);
+	uartA0Read(sizeof(data), uart);
+	usciSimFeed(USIM_A0, data, sizeof(data));
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	caseEnd("uartA0Read", USIM_A0, rxA0, data, sizeof(data), 10 * SIM_UART_BRW, 1);
+
+	// SPI: 8 bit clocks of SIM_SPI_BRW cycles per byte
+	caseStart(USIM_B0);
+	spiB0Write(data, sizeof(data), spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0Write", USIM_B0, out, data, sizeof(data), 8 * SIM_SPI_BRW, 1);
+
+	caseStart(USIM_B0);
+	usciSimFeed(USIM_B0, data, sizeof(data));
+	spiB0Read(sizeof(data), spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0Read", USIM_B0, rxB0, data, sizeof(data), 8 * SIM_SPI_BRW, 1);
+
+	caseStart(USIM_B0);
+	usciSimFeed(USIM_B0, data, 1);
+	swap = spiB0Swap(0x55, spi);
+	usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0Swap", USIM_B0, &swap, data, 1, 8 * SIM_SPI_BRW, 1);
+
+	// I2C: start + address, data bytes and stop (bus time not checked, the clock is held low between bytes)
+	caseStart(USIM_B1);
+	i2cB1Write(data, sizeof(data), i2c);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimDrain(USIM_B1, out, sizeof(out));
+	caseEnd("i2cB1Write", USIM_B1, out, data, sizeof(data), 0, 3);
+
+	caseStart(USIM_B1);
+	usciSimFeed(USIM_B1, data, sizeof(data));
+	i2cB1Read(sizeof(data), i2c);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	caseEnd("i2cB1Read", USIM_B1, rxB1, data, sizeof(data), 0, 3);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * SPI stream test (USE_SPI_STREAM): spiB0Stream reads blocks from the
+ * simulated slave on SPI B0 while the app collects them at its own pace.
+ * Each case checks the buffer handoff (bufA, bufB, bufA, ...), the data of
+ * each block, the dropped block count and the bus use:
+ *
+ *	test=<name> blocks= drops= bus_per_byte= result=PASS|FAIL
+ *
+ * streamHandoff releases each block as soon as it is seen, so no block may
+ * be dropped and the bus must run back to back (8 bit clocks per byte).
+ * streamHold keeps a block past the end of the next one, which is dropped,
+ * and the stream must carry on with the block after it once released.
+ * Returns non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_SPI_BRW	8		///< SPI bit clock of SMCLK / 8
+#define BLOCK_LEN	16		///< Bytes per block
+#define BLOCKS		6		///< Blocks collected by the handoff case
+#define POLL_CYCLES	64		///< Cycles between polls of the app
+#define MAX_POLLS	10000		///< Poll limit of a case
+
+unsigned char rxB0[64];			///< SPI B0 receive buffer
+unsigned char bufA[BLOCK_LEN];		///< First stream block buffer
+unsigned char bufB[BLOCK_LEN];		///< Second stream block buffer
+usciConfig spiConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0, 0};
+
+static unsigned char data[BLOCKS * BLOCK_LEN];	///< Bytes fed by the slave
+static usciSimStats before;		///< Module statistics at the start of the case
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Waits for the next block of the stream
+ *
+ * \param	**block	Set to the block handed to the app
+ * \return	The length of the block, 0 on timeout
+ ******************************************************************************/
+static unsigned int nextBlock(unsigned char **block)
+{
+	unsigned int i, len = 0;
+
+	for(i = 0; i < MAX_POLLS && !len; i++){
+		usciSimRun(POLL_CYCLES);
+		len = spiB0StreamGet(block);
+	}
+	return len;
+}
+/**************************************************************************//**
+ * \brief	Stops the stream and prints the line of a case
+ *
+ * \param	*name	Name of the case
+ * \param	blocks	Blocks collected by the app
+ * \param	drops	Blocks dropped during the case
+ * \param	busy	Bus cycles per byte while streaming
+ * \param	ok	Non-zero when the other checks of the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int blocks, unsigned int drops, double busy, int ok)
+{
+	usciSimStats s;
+	unsigned char out[USIM_BUF_SIZE];
+
+	spiB0StreamStop();
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	usciSimDrain(USIM_B0, out, sizeof(out));
+	usciSimGetStats(USIM_B0, &s);
+	if(s.overruns != before.overruns || getUCB0Stat() != OPEN) ok = 0;
+	printf("test=%s blocks=%u drops=%u bus_per_byte=%.1f result=%s\n", name, blocks, drops, busy, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+	usciSimGetStats(USIM_B0, &before);
+}
+
+int main(void)
+{
+	unsigned char *block = 0;
+	usciSimStats s0, s1;
+	unsigned int i, n, drops;
+	int spi, ok;
+
+	for(i = 0; i < sizeof(data); i++) data[i] = i * 11 + 7;
+	usciSimReset();
+	__enable_interrupt();
+	spi = registerComm(&spiConf);
+	usciSimGetStats(USIM_B0, &before);
+
+	// Handoff: every block released in time, the buffers alternate
+	usciSimFeed(USIM_B0, data, BLOCKS * BLOCK_LEN);
+	ok = spiB0Stream(bufA, bufB, BLOCK_LEN, spi) == 1;
+	n = nextBlock(&block);
+	usciSimGetStats(USIM_B0, &s0);
+	ok = ok && n == BLOCK_LEN && block == bufA && !memcmp(block, data, BLOCK_LEN);
+	spiB0StreamRelease();
+	for(i = 1; ok && i < BLOCKS; i++){
+		n = nextBlock(&block);
+		ok = n == BLOCK_LEN && block == ((i & 1) ? bufB : bufA) && !memcmp(block, data + i * BLOCK_LEN, BLOCK_LEN);
+		spiB0StreamRelease();
+	}
+	usciSimGetStats(USIM_B0, &s1);
+	drops = getUCB0StreamDrops();
+	caseEnd("streamHandoff", i, drops, (double)(s1.busCycles - s0.busCycles) / ((BLOCKS - 1) * BLOCK_LEN),
+		ok && !drops && s1.busCycles - s0.busCycles <= (BLOCKS - 1) * BLOCK_LEN * 8 * SIM_SPI_BRW + POLL_CYCLES);
+
+	// Hold: the block after a held one is dropped, the stream goes on
+	usciSimFeed(USIM_B0, data, 4 * BLOCK_LEN);
+	ok = spiB0Stream(bufA, bufB, BLOCK_LEN, spi) == 1;
+	n = nextBlock(&block);
+	ok = ok && n == BLOCK_LEN && block == bufA && !memcmp(block, data, BLOCK_LEN);
+	for(i = 0; i < MAX_POLLS && getUCB0StreamDrops() == drops; i++) usciSimRun(POLL_CYCLES);
+	ok = ok && spiB0StreamGet(&block) == BLOCK_LEN && block == bufA && !memcmp(bufA, data, BLOCK_LEN);
+	spiB0StreamRelease();
+	n = nextBlock(&block);
+	ok = ok && n == BLOCK_LEN && block == bufB && !memcmp(block, data + 2 * BLOCK_LEN, BLOCK_LEN);
+	spiB0StreamRelease();
+	caseEnd("streamHold", 2, getUCB0StreamDrops() - drops, 0, ok && getUCB0StreamDrops() == drops + 1);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Template test: the four modules are generated from comm_usci.h, so the same
+ * SPI transfer must cost the same on A0, A1, B0 and B1. Each case (write,
+ * read, transfer) runs on every module and prints one line per module:
+ *
+ *	test=<case>/<module> bytes= isr_per_byte= access_per_byte= cycles_per_byte= result=PASS|FAIL
+ *
+ * cycles_per_byte is the estimated ISR plus polling CPU time. A case fails
+ * when the data is wrong or a module differs from A0 in any figure. Returns
+ * non-zero when a case fails. "make size" gives the matching code sizes.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define TPL_SPI_BRW	4		///< SPI bit clock of SMCLK / 4
+#define TPL_LEN		256		///< Bytes per transfer
+
+unsigned char rx[USIM_MODULES][TPL_LEN];	///< Receive buffers [A0, A1, B0, B1]
+usciConfig conf[USIM_MODULES] = {
+	{UCA0_SPI, SPI_8M0_BE, DEF_CTLW1, TPL_SPI_BRW, rx[USIM_A0], 0},
+	{UCA1_SPI, SPI_8M0_BE, DEF_CTLW1, TPL_SPI_BRW, rx[USIM_A1], 0},
+	{UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, TPL_SPI_BRW, rx[USIM_B0], 0},
+	{UCB1_SPI, SPI_8M0_BE, DEF_CTLW1, TPL_SPI_BRW, rx[USIM_B1], 0},
+};
+static const char *const modName[USIM_MODULES] = {"A0", "A1", "B0", "B1"};
+static int (*const spiWrite[USIM_MODULES])(unsigned char *, unsigned int, unsigned int) = {spiA0Write, spiA1Write, spiB0Write, spiB1Write};
+static int (*const spiRead[USIM_MODULES])(unsigned int, unsigned int) = {spiA0Read, spiA1Read, spiB0Read, spiB1Read};
+static int (*const spiTransfer[USIM_MODULES])(unsigned char *, unsigned char *, unsigned int, unsigned int) = {spiA0Transfer, spiA1Transfer, spiB0Transfer, spiB1Transfer};
+
+unsigned char data[TPL_LEN];		///< Test pattern
+unsigned char xfer[TPL_LEN];		///< Transfer receive buffer
+unsigned char out[USIM_BUF_SIZE];	///< Bytes captured from the bus
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Runs one case on every module and compares the figures to A0
+ *
+ * \param	*name	Name of the case
+ * \param	op	0 for a write, 1 for a read, 2 for a full-duplex transfer
+ * \param	*commID	Comm IDs of the module apps
+ ******************************************************************************/
+static void runCase(const char *name, unsigned char op, const int *commID)
+{
+	usciSimStats s0, s1;
+	unsigned long isr[USIM_MODULES], access[USIM_MODULES], cycles[USIM_MODULES];
+	unsigned char m;
+	int ok;
+
+	for(m = 0; m < USIM_MODULES; m++){
+		usciSimGetStats(m, &s0);
+		if(op) usciSimFeed(m, data, TPL_LEN);
+		if(op == 0) spiWrite[m](data, TPL_LEN, commID[m]);
+		else if(op == 1) spiRead[m](TPL_LEN, commID[m]);
+		else spiTransfer[m](data, xfer, TPL_LEN, commID[m]);
+		usciSimIdle(USIM_LPM_TIMEOUT);
+		usciSimGetStats(m, &s1);
+		isr[m] = s1.isrEntries - s0.isrEntries;
+		access[m] = s1.regAccess - s0.regAccess;
+		cycles[m] = (s1.isrCycles - s0.isrCycles) + (s1.pollCycles - s0.pollCycles);
+		if(op == 0) ok = usciSimDrain(m, out, sizeof(out)) == TPL_LEN && !memcmp(out, data, TPL_LEN);
+		else{
+			usciSimDrain(m, out, sizeof(out));
+			ok = !memcmp(op == 1 ? rx[m] : xfer, data, TPL_LEN);
+		}
+		if(isr[m] != isr[0] || access[m] != access[0] || cycles[m] != cycles[0]) ok = 0;
+		printf("test=%s/%s bytes=%u isr_per_byte=%.2f access_per_byte=%.2f cycles_per_byte=%.2f result=%s\n",
+			name, modName[m], TPL_LEN, (double)isr[m] / TPL_LEN, (double)access[m] / TPL_LEN,
+			(double)cycles[m] / TPL_LEN, ok ? "PASS" : "FAIL");
+		if(!ok) fails++;
+	}
+}
+
+int main(void)
+{
+	int commID[USIM_MODULES];
+	unsigned int i;
+	unsigned char m;
+
+	for(i = 0; i < TPL_LEN; i++) data[i] = i * 7 + 3;
+	usciSimReset();
+	__enable_interrupt();
+	for(m = 0; m < USIM_MODULES; m++) commID[m] = registerComm(&conf[m]);
+
+	runCase("spiWrite", 0, commID);
+	runCase("spiRead", 1, commID);
+	runCase("spiTransfer", 2, commID);
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * Full-duplex SPI test: spiB0Transfer exchanges a block with the simulated
+ * slave on SPI B0, once through the ISR and once through DMA (USCI_OPT_DMA),
+ * and spiB0Swap exchanges single bytes (and is refused with an error code,
+ * never a byte, during a transfer or for an unknown comm ID). Each case
+ * checks the bytes sent, the bytes received and that RXBUF never overran:
+ *
+ *	test=<name> bytes= isr_entries= overruns= result=PASS|FAIL
+ *
+ * The in-place case transfers out of and back into the same buffer. Returns
+ * non-zero when a case fails.
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "comm.h"
+
+#define SIM_SPI_BRW	2		///< SPI bit clock of SMCLK / 2
+#define XFER_LEN	16		///< Bytes per transfer
+
+unsigned char rxB0[64];			///< SPI B0 receive buffer
+usciConfig spiConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0, 0};
+usciConfig spiDmaConf = {UCB0_SPI, SPI_8M0_BE, DEF_CTLW1, SIM_SPI_BRW, rxB0, USCI_OPT_DMA};
+
+static usciSimStats before;		///< Module statistics at the start of the case
+static int fails = 0;			///< Number of failed cases
+
+/**************************************************************************//**
+ * \brief	Ends a case and prints its line
+ *
+ * \param	*name	Name of the case
+ * \param	len	Number of bytes exchanged
+ * \param	*out	Bytes captured from the bus
+ * \param	*tx	Bytes expected on the bus
+ * \param	*rx	Bytes received by the library
+ * \param	*in	Bytes fed by the slave
+ * \param	ok	Non-zero when the other checks of the case passed
+ ******************************************************************************/
+static void caseEnd(const char *name, unsigned int len, const unsigned char *out, const unsigned char *tx,
+	const unsigned char *rx, const unsigned char *in, int ok)
+{
+	usciSimStats s;
+
+	usciSimGetStats(USIM_B0, &s);
+	if(memcmp(out, tx, len) || memcmp(rx, in, len) || s.overruns != before.overruns || getUCB0Stat() != OPEN) ok = 0;
+	printf("test=%s bytes=%u isr_entries=%lu overruns=%lu result=%s\n", name, len,
+		s.isrEntries - before.isrEntries, s.overruns - before.overruns, ok ? "PASS" : "FAIL");
+	if(!ok) fails++;
+	usciSimGetStats(USIM_B0, &before);
+}
+
+int main(void)
+{
+	unsigned char tx[XFER_LEN], in[XFER_LEN], rx[XFER_LEN], buf[XFER_LEN], out[USIM_BUF_SIZE];
+	unsigned char swap[2];
+	unsigned int i, n;
+	int spi, spiDma, ret, busy;
+
+	for(i = 0; i < XFER_LEN; i++){
+		tx[i] = 0x30 + i;
+		in[i] = 0xC0 - 3 * i;
+	}
+	usciSimReset();
+	__enable_interrupt();
+	spi = registerComm(&spiConf);
+	spiDma = registerComm(&spiDmaConf);
+	usciSimGetStats(USIM_B0, &before);
+
+	memset(rx, 0, sizeof(rx));
+	usciSimFeed(USIM_B0, in, XFER_LEN);
+	ret = spiB0Transfer(tx, rx, XFER_LEN, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0Transfer", XFER_LEN, out, tx, rx, in, ret == 1 && n == XFER_LEN);
+
+	memset(rx, 0, sizeof(rx));
+	usciSimFeed(USIM_B0, in, XFER_LEN);
+	ret = spiB0Transfer(tx, rx, XFER_LEN, spiDma);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0TransferDma", XFER_LEN, out, tx, rx, in, ret == 1 && n == XFER_LEN);
+
+	memcpy(buf, tx, XFER_LEN);
+	usciSimFeed(USIM_B0, in, XFER_LEN);
+	ret = spiB0Transfer(buf, buf, XFER_LEN, spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0TransferInPlace", XFER_LEN, out, tx, buf, in, ret == 1 && n == XFER_LEN);
+
+	usciSimFeed(USIM_B0, in, 2);
+	swap[0] = spiB0Swap(tx[0], spi);
+	swap[1] = spiB0Swap(tx[1], spi);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0Swap", 2, out, tx, swap, in, n == 2);
+
+	memset(rx, 0, sizeof(rx));
+	usciSimFeed(USIM_B0, in, XFER_LEN);
+	ret = spiB0Transfer(tx, rx, XFER_LEN, spi);
+	busy = spiB0Swap(tx[0], spi);
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	n = usciSimDrain(USIM_B0, out, sizeof(out));
+	caseEnd("spiB0SwapRefused", XFER_LEN, out, tx, rx, in, ret == 1 && busy == USCI_BUSY_ERROR &&
+		spiB0Swap(tx[0], MAX_DEVS + 1) == USCI_ID_ERROR && n == XFER_LEN && !usciSimDrain(USIM_B0, out, sizeof(out)));
+
+	printf("fails=%d\n", fails);
+	return fails != 0;
+}
@@ -0,0 +1,1161 @@
+#include <stdio.h>
+#include <string.h>
+#include "usci_sim.h"
+
+#define USIM_NONE		0xFF		///< No ISR in progress
+#define USIM_TX_EMPTY		0xFFFF		///< TXBUF contents once moved to the shift register
+#define USIM_DMA		USIM_MODULES	///< Vector index of the DMA controller
+#define USIM_TIMER		(USIM_MODULES + 1)	///< Vector index of the Timer A0 compare channels (TIMER0_A1)
+#define USIM_PORT		(USIM_MODULES + 2)	///< Vector index of Port 1
+#define USIM_VECTORS		(USIM_MODULES + 3)	///< Number of simulated interrupt vectors
+#define USIM_BRK_NONE		0			///< No peer break queued
+#define USIM_BRK_PENDING	1			///< Peer break queued before the byte at brkPos
+#define USIM_BRK_BREAK		2			///< Peer break being clocked in
+#define USIM_BRK_SYNC		3			///< Peer sync field being measured (UCABDEN)
+#define USIM_PEER_PAUSED(u)	((u)->rtsPin && (usimPort[USIM_POUT] & (u)->rtsPin))	///< Peer held off by the module RTS output
+#define USIM_IS_I2C(u)		((((u)->reg[USIM_CTLW0] >> 8) & (UCMODE_3 + UCSYNC)) == UCMODE_3 + UCSYNC)	///< Module in I2C mode
+// I2C master bus phases
+#define USIM_I2C_IDLE		0		///< Bus free
+#define USIM_I2C_ADDR		1		///< (Repeated) start and address byte
+#define USIM_I2C_TX		2		///< Transmitting data (clock held low between bytes until TXBUF is written)
+#define USIM_I2C_RX		3		///< Receiving data (clock held low between bytes until RXBUF is read)
+#define USIM_I2C_HOLD		4		///< Address or data NACKed, clock held low until a stop or start is requested
+#define USIM_I2C_STOP		5		///< Stop condition
+
+volatile unsigned int usciSimSR = 0;		///< Simulated CPU status register (GIE/LPM bits)
+
+static usciSimModule usim[USIM_MODULES];	///< Simulated modules [A0, A1, B0, B1]
+static unsigned long usimClock = 0;		///< Simulated SMCLK (and MCLK) cycle count
+static unsigned char usimReady = 0;		///< Simulator initialized flag
+static unsigned char usimInIsr = USIM_NONE;	///< Module whose ISR is currently running
+static unsigned long usimIsrPoll;		///< Cycles the running ISR spent polling STATW (already simulated)
+static unsigned long usimIsrAccess = 0;		///< Register accesses made by the running ISR
+static unsigned int usimExitClear = 0;		///< SR bits to clear on exit of the running ISR
+static unsigned long usimSleep = 0;		///< Cycles the CPU spent in a low power mode
+
+static volatile unsigned short usimDmaReg[USIM_DMA_NREGS];	///< DMA register file
+static volatile void *usimDmaAddr[USIM_DMA_CHANNELS][2];	///< DMA source/destination address registers
+static volatile unsigned char *usimDmaSrc[USIM_DMA_CHANNELS];	///< DMA temporary source address
+static volatile unsigned char *usimDmaDst[USIM_DMA_CHANNELS];	///< DMA temporary destination address
+static unsigned int usimDmaSize[USIM_DMA_CHANNELS];		///< DMA temporary size
+static unsigned char usimDmaArmed[USIM_DMA_CHANNELS];		///< DMA channel enabled (temporaries loaded)
+static unsigned char usimDmaTrig[USIM_DMA_CHANNELS];		///< DMA trigger level on the previous cycle
+static usciSimDmaStats usimDmaStats;				///< DMA statistics
+static volatile unsigned short usimTimer[USIM_TIMER_NREGS];	///< Timer A0 register file
+static unsigned long usimTimerBase = 0;				///< Simulated CPU time of the last timer clear
+static volatile unsigned char usimPort[USIM_PORT_NREGS];	///< Port 1 register file
+static usciSimStats usimBenchStats;				///< Module statistics at the start of the benchmark case
+static usciSimDmaStats usimBenchDma;				///< DMA statistics at the start of the benchmark case
+static unsigned long usimBenchClock;				///< Cycle count at the start of the benchmark case
+
+// The library ISRs are bound weakly so only the compiled-in modules are dispatched
+extern void usciA0Isr(void) __attribute__((weak));
+extern void usciA1Isr(void) __attribute__((weak));
+extern void usciB0Isr(void) __attribute__((weak));
+extern void usciB1Isr(void) __attribute__((weak));
+extern void usciDmaIsr(void) __attribute__((weak));
+extern void usciIdleIsr(void) __attribute__((weak));
+extern void usciCtsIsr(void) __attribute__((weak));
+
+/// Simulated interrupt vector table (indexed by module, then the DMA controller, the timer and Port 1)
+static void (*const usimVector[USIM_VECTORS])(void) = {usciA0Isr, usciA1Isr, usciB0Isr, usciB1Isr, usciDmaIsr, usciIdleIsr, usciCtsIsr};
+/// Interrupt priority order of the vectors (highest first, as on the FR5739 or, with USIM_F5XX_MAP, in the F5510/F5342 order)
+#ifdef USIM_F5XX_MAP
+static const unsigned char usimPriority[USIM_VECTORS] = {USIM_A0, USIM_B0, USIM_TIMER, USIM_DMA, USIM_PORT, USIM_A1, USIM_B1};
+#else
+static const unsigned char usimPriority[USIM_VECTORS] = {USIM_A0, USIM_B0, USIM_TIMER, USIM_DMA, USIM_A1, USIM_B1, USIM_PORT};
+#endif // USIM_F5XX_MAP
+/// Module of each DMA RX/TX trigger pair (DMAxTSEL order of the device)
+static const unsigned char usimDmaTrigMod[USIM_MODULES] = USIM_DMA_TRIG_MODS;
+
+/**************************************************************************//**
+ * \brief	Computes the length of one character frame in SMCLK cycles
+ *
+ * SPI frames are 8 bit clocks of BRW cycles each. UART frames include start,
+ * data, parity and stop bits, each taking BRW cycles (or 16 * UCBRx + UCBRFx
+ * in oversampling mode) plus one extra cycle where the UCBRSx pattern bit is
+ * set (applied MSB first starting with the start bit).
+ *
+ * \param	u	The simulated module
+ * \return	The number of SMCLK cycles per character
+ ******************************************************************************/
+static unsigned long usimFrameCycles(usciSimModule *u)
+{
+	unsigned int ctl0 = u->reg[USIM_CTLW0] >> 8;
+	unsigned int mctlw = u->reg[USIM_MCTLW];
+	unsigned long brw = u->reg[USIM_BRW] ? u->reg[USIM_BRW] : 1;
+	unsigned long cycles = 0;
+	unsigned char bits, i;
+
+	if(ctl0 & UCSYNC) return 8 * brw;				// SPI: 8 bit clocks
+
+	bits = 1 + ((ctl0 & UC7BIT) ? 7 : 8) + ((ctl0 & UCPEN) ? 1 : 0) + ((ctl0 & UCSPB) ? 2 : 1);
+	for(i = 0; i < bits; i++){
+		if(mctlw & UCOS16) cycles += 16 * brw + ((mctlw >> 4) & 0x0F);
+		else cycles += brw;
+		cycles += (mctlw >> (15 - (i & 7))) & 0x01;		// UCBRSx modulation pattern
+	}
+	return cycles;
+}
+
+/**************************************************************************//**
+ * \brief	Places a received byte in RXBUF
+ *
+ * \param	u	The simulated module
+ * \param	byte	The byte clocked in from the line
+ ******************************************************************************/
+static void usimRxDeliver(usciSimModule *u, unsigned char byte)
+{
+	if(u->reg[USIM_IFG] & UCRXIFG){					// RXBUF not yet read: overrun
+		u->reg[USIM_STATW] |= UCOE;
+		if(!(u->reg[USIM_CTLW0] & (UCSYNC << 8))) u->reg[USIM_STATW] |= UCRXERR;	// (UART only, no UCRXERR in SPI mode)
+		u->stats.overruns++;
+	}
+	else u->edge |= UCRXIFG;
+	u->reg[USIM_RXBUF] = byte;
+	u->reg[USIM_IFG] |= UCRXIFG;
+	u->stats.rxBytes++;
+}
+
+/**************************************************************************//**
+ * \brief	Pops the next peer byte from the module input queue
+ *
+ * \param	u	The simulated module
+ * \return	The next peer byte (0xFF if the peer has nothing to send)
+ ******************************************************************************/
+static unsigned char usimPeerByte(usciSimModule *u)
+{
+	unsigned char byte;
+
+	if(u->inHead == u->inTail) return 0xFF;
+	byte = u->in[u->inTail];
+	u->inTail = (u->inTail + 1) % USIM_BUF_SIZE;
+	return byte;
+}
+
+/**************************************************************************//**
+ * \brief	Starts clocking in the next UART frame of the peer
+ *
+ * \param	u	The simulated module
+ * \return	SMCLK cycles of the frame (of the break when one is queued)
+ ******************************************************************************/
+static unsigned long usimRxStart(usciSimModule *u)
+{
+	if(u->brk != USIM_BRK_NONE) u->brk = USIM_BRK_PENDING;	// (restart a break cut by a software reset)
+	if(u->brk == USIM_BRK_PENDING && u->inTail == u->brkPos){
+		u->brk = USIM_BRK_BREAK;
+		return USIM_BREAK_BITS * u->peerBit;
+	}
+	return usimFrameCycles(u);
+}
+
+/**************************************************************************//**
+ * \brief	Ends the UART frame clocked in from the peer
+ *
+ * A break ends as a break character (0x00, UCBRK + UCFE) unless UCABDEN is
+ * set, in which case the sync field is measured at the peer rate: UCxBRW
+ * (and UCBRFx in oversampling mode) get the bit time and the sync byte is
+ * received with UCBRK set. A bit time over the UCxBRW range sets UCSTOE.
+ *
+ * \param	u	The simulated module
+ ******************************************************************************/
+static void usimRxDone(usciSimModule *u)
+{
+	unsigned long bit = u->peerBit;
+
+	if(u->brk == USIM_BRK_BREAK){
+		if(u->reg[USIM_ABCTL] & UCABDEN){
+			u->brk = USIM_BRK_SYNC;
+			u->rxLeft = 10 * bit;				// Start bit, 0x55, stop bit
+			return;
+		}
+		u->brk = USIM_BRK_NONE;
+		u->reg[USIM_STATW] |= UCBRK + UCFE + UCRXERR;
+		usimRxDeliver(u, 0x00);
+		return;
+	}
+	if(u->brk == USIM_BRK_SYNC){
+		u->brk = USIM_BRK_NONE;
+		if(u->reg[USIM_MCTLW] & UCOS16){
+			u->reg[USIM_BRW] = (unsigned short)(bit >> 4);
+			u->reg[USIM_MCTLW] = UCOS16 + ((bit & 0x0F) << 4);
+		}
+		else if(bit <= 0xFFFF){
+			u->reg[USIM_BRW] = (unsigned short)bit;
+			u->reg[USIM_MCTLW] = 0;
+		}
+		else u->reg[USIM_ABCTL] |= UCSTOE;
+		u->reg[USIM_STATW] |= UCBRK;
+	}
+	usimRxDeliver(u, usimPeerByte(u));
+}
+
+/**************************************************************************//**
+ * \brief	Applies the side effects of the last register writes
+ *
+ * Holds the module in reset while UCSWRST is set and moves a written TXBUF
+ * into the (idle) shift register, setting UCTXIFG again.
+ *
+ * \param	u	The simulated module
+ ******************************************************************************/
+static void usimSync(usciSimModule *u)
+{
+	if(u->reg[USIM_CTLW0] & UCSWRST){				// Module held in reset
+		u->txLeft = 0;
+		u->rxLeft = 0;
+		u->busyLeft = 0;
+		u->reg[USIM_TXBUF] = USIM_TX_EMPTY;
+		u->reg[USIM_IE] = 0;
+		u->reg[USIM_IFG] = UCTXIFG;
+		u->reg[USIM_STATW] &= UCLISTEN;
+		u->i2cState = USIM_I2C_IDLE;
+		return;
+	}
+	if(USIM_IS_I2C(u)){						// I2C: the bus phases move TXBUF (see usimI2cTick())
+		if(u->i2cState != USIM_I2C_IDLE) u->reg[USIM_STATW] |= UCBUSY + UCBBUSY;
+		else u->reg[USIM_STATW] &= ~(UCBUSY + UCBBUSY);
+		return;
+	}
+	if(!u->txLeft && u->reg[USIM_TXBUF] != USIM_TX_EMPTY){	// Load the shift register
+		u->txShift = (unsigned char)u->reg[USIM_TXBUF];
+		u->reg[USIM_TXBUF] = USIM_TX_EMPTY;
+		u->txLeft = usimFrameCycles(u);
+		if(!(u->reg[USIM_IFG] & UCTXIFG)) u->edge |= UCTXIFG;
+		u->reg[USIM_IFG] |= UCTXIFG;
+	}
+	if(u->txLeft || u->rxLeft || u->busyLeft) u->reg[USIM_STATW] |= UCBUSY;
+	else u->reg[USIM_STATW] &= ~UCBUSY;
+}
+
+/**************************************************************************//**
+ * \brief	Starts an I2C master bus phase
+ *
+ * \param	u	The simulated module
+ * \param	phase	The bus phase (USIM_I2C_ADDR..USIM_I2C_STOP)
+ * \param	bits	Length of the phase in SCL periods (BRW cycles each)
+ ******************************************************************************/
+static void usimI2cPhase(usciSimModule *u, unsigned char phase, unsigned long bits)
+{
+	u->i2cState = phase;
+	u->txLeft = bits * (u->reg[USIM_BRW] ? u->reg[USIM_BRW] : 1);
+}
+
+/**************************************************************************//**
+ * \brief	Advances an I2C master by one SMCLK cycle
+ *
+ * The peer is a slave acknowledging the address set by usciSimI2cSlave() and
+ * every data byte, returning the usciSimFeed() bytes when read (0xFF once
+ * empty) and capturing the bytes written (usciSimDrain()). A start condition
+ * and address take 10 SCL periods, a data byte 9 and a stop condition 1.
+ * UCTXIFG is set on the start condition of a write and on each byte moved to
+ * the shift register, the clock is held low between bytes while TXBUF is
+ * empty (or RXBUF unread). UCTXSTP is sampled at the end of each byte (so it
+ * must be set while the last byte is under way when receiving), UCTXSTT
+ * starts a repeated start. The end of a stop condition sets UCSTPIFG.
+ *
+ * \param	u	The simulated module
+ ******************************************************************************/
+static void usimI2cTick(usciSimModule *u)
+{
+	volatile unsigned short *ctl = &u->reg[USIM_CTLW0];
+
+	if(u->i2cState != USIM_I2C_IDLE) u->stats.busCycles++;
+	if(u->txLeft){
+		if(--u->txLeft) return;
+		switch(u->i2cState){					// End of a bus phase
+		case USIM_I2C_ADDR:
+			*ctl &= ~UCTXSTT;
+			if(u->i2cSlave != USIM_I2C_ANY && (u->reg[USIM_I2CSA] & 0x03FF) != u->i2cSlave){
+				u->reg[USIM_IFG] |= UCNACKIFG;
+				u->i2cState = USIM_I2C_HOLD;
+			}
+			else u->i2cState = (*ctl & UCTR) ? USIM_I2C_TX : USIM_I2C_RX;
+			break;
+		case USIM_I2C_TX:
+			if(u->outCount < USIM_BUF_SIZE) u->out[u->outCount++] = u->txShift;
+			u->stats.txBytes++;
+			break;
+		case USIM_I2C_RX:
+			usimRxDeliver(u, usimPeerByte(u));
+			if(*ctl & UCTXSTP) u->i2cState = USIM_I2C_HOLD;	// Byte NACKed: stop follows
+			break;
+		case USIM_I2C_STOP:
+			*ctl &= ~UCTXSTP;
+			u->reg[USIM_TXBUF] = USIM_TX_EMPTY;		// (a byte loaded before a NACK is dropped)
+			u->reg[USIM_IFG] |= UCSTPIFG;
+			u->i2cState = USIM_I2C_IDLE;
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Start the next bus phase (the clock is held low otherwise)
+	switch(u->i2cState){
+	case USIM_I2C_TX:
+		if(u->reg[USIM_TXBUF] != USIM_TX_EMPTY){
+			u->txShift = (unsigned char)u->reg[USIM_TXBUF];
+			u->reg[USIM_TXBUF] = USIM_TX_EMPTY;
+			if(!(u->reg[USIM_IFG] & UCTXIFG)) u->edge |= UCTXIFG;
+			u->reg[USIM_IFG] |= UCTXIFG;
+			usimI2cPhase(u, USIM_I2C_TX, 9);
+			break;
+		}
+		// Nothing to send: stop or restart when requested
+		/* fall through */
+	case USIM_I2C_HOLD:
+		if(*ctl & UCTXSTP) usimI2cPhase(u, USIM_I2C_STOP, 1);
+		else if(*ctl & UCTXSTT) usimI2cPhase(u, USIM_I2C_ADDR, 10);
+		break;
+	case USIM_I2C_RX:
+		if(*ctl & UCTXSTT) usimI2cPhase(u, USIM_I2C_ADDR, 10);
+		else if(!(u->reg[USIM_IFG] & UCRXIFG)) usimI2cPhase(u, USIM_I2C_RX, 9);
+		break;
+	case USIM_I2C_IDLE:
+		if(*ctl & UCTXSTT){
+			usimI2cPhase(u, USIM_I2C_ADDR, 10);
+			if(*ctl & UCTR){				// Transmitter: first byte may be loaded
+				if(!(u->reg[USIM_IFG] & UCTXIFG)) u->edge |= UCTXIFG;
+				u->reg[USIM_IFG] |= UCTXIFG;
+			}
+		}
+		else *ctl &= ~UCTXSTP;
+		break;
+	default:
+		break;
+	}
+}
+
+/**************************************************************************//**
+ * \brief	Reads a byte on behalf of the DMA controller
+ *
+ * Reads of a module RXBUF clear UCRXIFG (and the error flags) as a CPU read
+ * would, without being counted as a CPU register access.
+ *
+ * \param	*addr	The source address
+ * \return	The byte read
+ ******************************************************************************/
+static unsigned char usimDmaRead(volatile unsigned char *addr)
+{
+	unsigned char m;
+
+	for(m = 0; m < USIM_MODULES; m++){
+		if(addr == (volatile unsigned char *)&usim[m].reg[USIM_RXBUF]){
+			usim[m].reg[USIM_IFG] &= ~UCRXIFG;
+			usim[m].reg[USIM_STATW] &= ~(UCRXERR + UCOE + UCFE + UCPE + UCBRK);
+			break;
+		}
+	}
+	return *addr;
+}
+
+/**************************************************************************//**
+ * \brief	Writes a byte on behalf of the DMA controller
+ *
+ * Writes to a module TXBUF clear UCTXIFG as a CPU write would, without being
+ * counted as a CPU register access.
+ *
+ * \param	*addr	The destination address
+ * \param	byte	The byte to write
+ ******************************************************************************/
+static void usimDmaWrite(volatile unsigned char *addr, unsigned char byte)
+{
+	unsigned char m;
+
+	for(m = 0; m < USIM_MODULES; m++){
+		if(addr == (volatile unsigned char *)&usim[m].reg[USIM_TXBUF]){
+			usim[m].reg[USIM_IFG] &= ~UCTXIFG;
+			usim[m].reg[USIM_TXBUF] = byte;
+			return;
+		}
+	}
+	*addr = byte;
+}
+
+/**************************************************************************//**
+ * \brief	Gets the level of a DMA trigger source
+ *
+ * \param	tsel	The DMAxTSEL trigger number
+ * \param	edge	Non-zero to get the rising edge (within the cycle) instead
+ * \return	Non-zero when the trigger flag is set (or has risen)
+ ******************************************************************************/
+static unsigned char usimDmaTrigger(unsigned int tsel, unsigned char edge)
+{
+	unsigned int m;
+	unsigned char flag;
+
+	if(tsel < USIM_DMA_TRIG_BASE) return 0;
+	m = (tsel - USIM_DMA_TRIG_BASE) >> 1;
+	if(m >= USIM_MODULES) return 0;
+	m = usimDmaTrigMod[m];
+	flag = (tsel - USIM_DMA_TRIG_BASE) & 0x01 ? UCTXIFG : UCRXIFG;
+	if(edge) return (usim[m].edge & flag) != 0;
+	return (usim[m].reg[USIM_IFG] & flag) != 0;
+}
+
+/**************************************************************************//**
+ * \brief	Advances the DMA controller by one cycle
+ *
+ * Channels run in single transfer, edge triggered mode: a byte is moved on
+ * each rising edge of the selected trigger flag (including a flag which was
+ * cleared and set again within the cycle, e.g. by a TXBUF write). The
+ * temporary address and size registers are loaded when DMAEN is set, DMAIFG
+ * is set and DMAEN cleared when the size reaches zero.
+ ******************************************************************************/
+static void usimDmaTick(void)
+{
+	unsigned int ctl, tsel;
+	unsigned char ch, level;
+
+	for(ch = 0; ch < USIM_DMA_CHANNELS; ch++){
+		ctl = usimDmaReg[USIM_DMAxCTL(ch)];
+		if(ch == 2) tsel = usimDmaReg[USIM_DMACTL1] & 0x1F;
+		else tsel = (usimDmaReg[USIM_DMACTL0] >> (8 * ch)) & 0x1F;
+		level = usimDmaTrigger(tsel, 0);
+
+		if(!(ctl & DMAEN)){
+			usimDmaArmed[ch] = 0;
+			usimDmaTrig[ch] = level;
+			continue;
+		}
+		if(!usimDmaArmed[ch]){					// Load the temporary registers
+			usimDmaSrc[ch] = (volatile unsigned char *)usimDmaAddr[ch][0];
+			usimDmaDst[ch] = (volatile unsigned char *)usimDmaAddr[ch][1];
+			usimDmaSize[ch] = usimDmaReg[USIM_DMAxSZ(ch)];
+			usimDmaArmed[ch] = 1;
+		}
+		if(level && (!usimDmaTrig[ch] || usimDmaTrigger(tsel, 1))){	// Rising edge: move one byte
+			usimDmaWrite(usimDmaDst[ch], usimDmaRead(usimDmaSrc[ch]));
+			if((ctl & DMASRCINCR_3) == DMASRCINCR_3) usimDmaSrc[ch]++;
+			else if((ctl & DMASRCINCR_3) == DMASRCINCR_2) usimDmaSrc[ch]--;
+			if((ctl & DMADSTINCR_3) == DMADSTINCR_3) usimDmaDst[ch]++;
+			else if((ctl & DMADSTINCR_3) == DMADSTINCR_2) usimDmaDst[ch]--;
+			usimDmaStats.transfers++;
+			usimDmaStats.stallCycles += 2;
+			if(--usimDmaSize[ch] == 0){
+				usimDmaReg[USIM_DMAxCTL(ch)] = (ctl & ~DMAEN) | DMAIFG;
+				usimDmaArmed[ch] = 0;
+			}
+			level = usimDmaTrigger(tsel, 0);
+		}
+		usimDmaTrig[ch] = level;
+	}
+	for(ch = 0; ch < USIM_MODULES; ch++) usim[ch].edge = 0;
+}
+
+/**************************************************************************//**
+ * \brief	Checks whether an interrupt vector has a request pending
+ *
+ * \param	vect	The vector index (module index, USIM_DMA, USIM_TIMER or USIM_PORT)
+ * \retval	1	The vector ISR is compiled in and its flags are set
+ * \retval	0	Nothing pending
+ ******************************************************************************/
+static unsigned char usimPending(unsigned char vect)
+{
+	unsigned char ch;
+
+	if(!usimVector[vect]) return 0;
+	if(vect == USIM_PORT) return (usimPort[USIM_PIFG] & usimPort[USIM_PIE]) != 0;
+	if(vect == USIM_TIMER){
+		for(ch = 0; ch < USIM_TIMER_CCRS; ch++){
+			if((usimTimer[USIM_TACCTL1 + ch] & (CCIFG + CCIE)) == CCIFG + CCIE) return 1;
+		}
+		return 0;
+	}
+	if(vect == USIM_DMA){
+		for(ch = 0; ch < USIM_DMA_CHANNELS; ch++){
+			if((usimDmaReg[USIM_DMAxCTL(ch)] & (DMAIFG + DMAIE)) == DMAIFG + DMAIE) return 1;
+		}
+		return 0;
+	}
+	return (usim[vect].reg[USIM_IFG] & usim[vect].reg[USIM_IE]) != 0;
+}
+
+/**************************************************************************//**
+ * \brief	Timer input divider (ID x TAIDEX)
+ *
+ * \return	The number of SMCLK cycles per count
+ ******************************************************************************/
+static unsigned int usimTimerDiv(void)
+{
+	return (1 << ((usimTimer[USIM_TACTL] & ID_3) >> 6)) * ((usimTimer[USIM_TAEX0] & 0x07) + 1);
+}
+
+/**************************************************************************//**
+ * \brief	Applies a pending timer clear and updates the timer counter
+ *
+ * \param	now	The simulated CPU time of the update
+ ******************************************************************************/
+static void usimTimerSync(unsigned long now)
+{
+	if(usimTimer[USIM_TACTL] & TACLR){
+		usimTimer[USIM_TACTL] &= ~TACLR;
+		usimTimerBase = now;
+		usimTimer[USIM_TAR] = 0;
+	}
+	if(usimTimer[USIM_TACTL] & MC_3) usimTimer[USIM_TAR] = (unsigned short)((now - usimTimerBase) / usimTimerDiv());
+}
+
+/**************************************************************************//**
+ * \brief	Advances Timer A0 by one SMCLK cycle
+ *
+ * A compare channel sets its CCIFG on the cycle the counter reaches its
+ * TAxCCRn value (the counter moves every usimTimerDiv() cycles).
+ ******************************************************************************/
+static void usimTimerTick(void)
+{
+	unsigned char ch;
+
+	if(!(usimTimer[USIM_TACTL] & MC_3)) return;
+	usimTimerSync(usimClock);
+	if((usimClock - usimTimerBase) % usimTimerDiv()) return;	// Divided clock: no count on this cycle
+	for(ch = 0; ch < USIM_TIMER_CCRS; ch++){
+		if(usimTimer[USIM_TAR] == usimTimer[USIM_TACCR1 + ch]) usimTimer[USIM_TACCTL1 + ch] |= CCIFG;
+	}
+}
+
+/**************************************************************************//**
+ * \brief	Advances every simulated module by one SMCLK cycle
+ ******************************************************************************/
+static void usimTick(void)
+{
+	usciSimModule *u;
+	unsigned char m;
+
+	for(m = 0; m < USIM_MODULES; m++){
+		u = &usim[m];
+		usimSync(u);
+		if(u->reg[USIM_CTLW0] & UCSWRST) continue;
+		if(USIM_IS_I2C(u)){
+			usimI2cTick(u);
+			usimSync(u);
+			continue;
+		}
+		if(u->txLeft || u->rxLeft) u->stats.busCycles++;
+		if(u->busyLeft) u->busyLeft--;
+
+		// Transmit (and SPI receive) frame
+		if(u->txLeft && --u->txLeft == 0){
+			if(u->outCount < USIM_BUF_SIZE) u->out[u->outCount++] = u->txShift;
+			u->stats.txBytes++;
+			if(u->reg[USIM_STATW] & UCLISTEN) usimRxDeliver(u, u->txShift);
+			else if(u->reg[USIM_CTLW0] & (UCSYNC << 8)) usimRxDeliver(u, usimPeerByte(u));
+			if(u->reg[USIM_CTLW0] & (UCSYNC << 8)) u->busyLeft = u->reg[USIM_BRW] / 2 + 1;	// SPI: UCBUSY set until the trailing clock edge, past UCRXIFG
+			if(!(u->reg[USIM_CTLW0] & (UCSYNC << 8)) && u->reg[USIM_TXBUF] == USIM_TX_EMPTY) u->reg[USIM_IFG] |= UCTXCPTIFG;	// UART: nothing left to send
+		}
+		// UART receive frame
+		if(!(u->reg[USIM_CTLW0] & (UCSYNC << 8))){
+			if(u->rxLeft && --u->rxLeft == 0) usimRxDone(u);
+			if(!u->rxLeft && u->inHead != u->inTail && !USIM_PEER_PAUSED(u)) u->rxLeft = usimRxStart(u);
+		}
+		usimSync(u);
+	}
+	usimDmaTick();
+	usimTimerTick();
+	usimClock++;
+}
+
+/**************************************************************************//**
+ * \brief	Dispatches the highest priority pending module ISR
+ *
+ * An ISR is entered when GIE is set, no other ISR is running and
+ * (IFG & IE) is non-zero for a module whose ISR is compiled in. The
+ * peripherals keep running for the estimated duration of the ISR.
+ ******************************************************************************/
+static void usimDispatch(void)
+{
+	unsigned long cost;
+	unsigned int saved;
+	unsigned char i, m;
+
+	if(usimInIsr != USIM_NONE || !(usciSimSR & GIE)) return;
+	for(i = 0; i < USIM_VECTORS; i++){
+		m = usimPriority[i];
+		if(!usimPending(m)) continue;
+
+		saved = usciSimSR;				// Interrupt entry clears GIE and LPM bits
+		usciSimSR = 0;
+		usimInIsr = m;
+		usimIsrAccess = 0;
+		usimIsrPoll = 0;
+		usimExitClear = 0;
+		usimVector[m]();
+
+		cost = USIM_ISR_CYCLES + usimIsrAccess * USIM_ACCESS_CYCLES;
+		if(m == USIM_DMA){
+			usimDmaStats.isrEntries++;
+			usimDmaStats.isrCycles += cost + usimIsrPoll;
+		}
+		else if(m < USIM_MODULES){
+			usim[m].stats.isrEntries++;
+			usim[m].stats.isrCycles += cost + usimIsrPoll;
+		}
+		while(cost--) usimTick();
+		usimInIsr = USIM_NONE;
+		usciSimSR = saved & ~usimExitClear;		// RETI restores the (modified) SR
+		return;
+	}
+}
+
+/**************************************************************************//**
+ * \brief	Checks whether the simulated system has nothing left to do
+ *
+ * \retval	1	No frame shifting, no pending TX/peer data (unless held off
+ * 			by RTS), no armed timer compare and no ISR pending
+ * \retval	0	Activity remains
+ ******************************************************************************/
+static unsigned char usimQuiet(void)
+{
+	usciSimModule *u;
+	unsigned char m;
+
+	for(m = 0; m < USIM_MODULES; m++){
+		u = &usim[m];
+		if(u->reg[USIM_CTLW0] & UCSWRST) continue;
+		if(u->txLeft || u->rxLeft || u->busyLeft || u->reg[USIM_TXBUF] != USIM_TX_EMPTY) return 0;
+		if(USIM_IS_I2C(u) && (u->i2cState != USIM_I2C_IDLE || (u->reg[USIM_CTLW0] & UCTXSTT))) return 0;
+		if(!(u->reg[USIM_CTLW0] & (UCSYNC << 8)) && u->inHead != u->inTail && !USIM_PEER_PAUSED(u)) return 0;
+		if((usciSimSR & GIE) && usimPending(m)) return 0;
+	}
+	if((usciSimSR & GIE) && usimPending(USIM_DMA)) return 0;
+	for(m = 0; m < USIM_TIMER_CCRS; m++){
+		if((usimTimer[USIM_TACTL] & MC_3) && (usimTimer[USIM_TACCTL1 + m] & (CCIE + CCIFG)) == CCIE) return 0;
+	}
+	if((usciSimSR & GIE) && usimPending(USIM_TIMER)) return 0;
+	if((usciSimSR & GIE) && usimPending(USIM_PORT)) return 0;
+	return 1;
+}
+
+/**************************************************************************//**
+ * \brief	Resets the simulator to its power-on state
+ *
+ * All modules are held in software reset (UCSWRST) with UCTXIFG set,
+ * statistics, peer queues and the cycle counter are cleared. GIE is cleared
+ * as after a POR, so the application must enable interrupts.
+ ******************************************************************************/
+void usciSimReset(void)
+{
+	unsigned char m;
+
+	memset(usim, 0, sizeof(usim));
+	for(m = 0; m < USIM_MODULES; m++){
+		usim[m].reg[USIM_CTLW0] = UCSWRST;
+		usim[m].reg[USIM_TXBUF] = USIM_TX_EMPTY;
+		usim[m].reg[USIM_IFG] = UCTXIFG;
+		usim[m].i2cSlave = USIM_I2C_ANY;
+	}
+	memset((void *)usimDmaReg, 0, sizeof(usimDmaReg));
+	memset((void *)usimDmaAddr, 0, sizeof(usimDmaAddr));
+	memset(usimDmaArmed, 0, sizeof(usimDmaArmed));
+	memset(usimDmaTrig, 0, sizeof(usimDmaTrig));
+	memset(&usimDmaStats, 0, sizeof(usimDmaStats));
+	memset((void *)usimTimer, 0, sizeof(usimTimer));
+	memset((void *)usimPort, 0, sizeof(usimPort));
+	usimTimerBase = 0;
+	usimClock = 0;
+	usimSleep = 0;
+	usimInIsr = USIM_NONE;
+	usciSimSR = 0;
+	usimReady = 1;
+}
+
+/**************************************************************************//**
+ * \brief	Simulated register access
+ *
+ * All register macros in usci_sim.h resolve to this function. The access is
+ * counted and the hardware side effects of the access are applied:
+ * 	- TXBUF: the (pending) write clears UCTXIFG
+ * 	- RXBUF: the read clears UCRXIFG and the receive error flags
+ * 	- STATW: a read is treated as a polling loop iteration and advances the
+ * 	  simulation by USIM_POLL_CYCLES (inside an ISR the peripherals advance
+ * 	  without dispatching other ISRs, the cycles count as ISR time)
+ * 	- CTLW0 (I2C mode): same as STATW while UCTXSTT or UCTXSTP is pending
+ * 	- IV: returns and clears the highest priority enabled flag (I2C
+ * 	  mode: NACK, stop, RX then TX, with the eUSCI_B vector values)
+ *
+ * \param	mod	The module index (USIM_A0..USIM_B1)
+ * \param	reg	The register offset (USIM_CTLW0..USIM_IV)
+ * \return	Pointer to the simulated register
+ ******************************************************************************/
+volatile unsigned short *usciSimReg(unsigned char mod, unsigned char reg)
+{
+	usciSimModule *u = &usim[mod];
+	unsigned short pend;
+
+	if(!usimReady) usciSimReset();
+	usimSync(u);
+	u->stats.regAccess++;
+	if(usimInIsr != USIM_NONE) usimIsrAccess++;
+
+	switch(reg){
+	case USIM_TXBUF:
+		u->reg[USIM_IFG] &= ~UCTXIFG;
+		break;
+	case USIM_RXBUF:
+		u->reg[USIM_IFG] &= ~UCRXIFG;
+		u->reg[USIM_STATW] &= ~(UCRXERR + UCOE + UCFE + UCPE + UCBRK);
+		break;
+	case USIM_CTLW0:
+		if(!USIM_IS_I2C(u) || !(u->reg[USIM_CTLW0] & (UCTXSTT + UCTXSTP))) break;
+		// Waiting on a start/stop condition
+		/* fall through */
+	case USIM_STATW:
+		u->stats.pollCycles += USIM_POLL_CYCLES;
+		if(usimInIsr == USIM_NONE) usciSimRun(USIM_POLL_CYCLES);
+		else{
+			for(pend = 0; pend < USIM_POLL_CYCLES; pend++) usimTick();
+			usimIsrPoll += USIM_POLL_CYCLES;
+		}
+		break;
+	case USIM_IV:
+		pend = u->reg[USIM_IFG] & u->reg[USIM_IE];
+		if(USIM_IS_I2C(u)){
+			if(pend & UCNACKIFG){
+				u->reg[USIM_IV] = USCI_I2C_UCNACKIFG;
+				u->reg[USIM_IFG] &= ~UCNACKIFG;
+			}
+			else if(pend & UCSTPIFG){
+				u->reg[USIM_IV] = USCI_I2C_UCSTPIFG;
+				u->reg[USIM_IFG] &= ~UCSTPIFG;
+			}
+			else if(pend & UCRXIFG){
+				u->reg[USIM_IV] = USCI_I2C_UCRXIFG0;
+				u->reg[USIM_IFG] &= ~UCRXIFG;
+			}
+			else if(pend & UCTXIFG){
+				u->reg[USIM_IV] = USCI_I2C_UCTXIFG0;
+				u->reg[USIM_IFG] &= ~UCTXIFG;
+			}
+			else u->reg[USIM_IV] = 0x00;
+		}
+		else if(pend & UCRXIFG){
+			u->reg[USIM_IV] = 0x02;
+			u->reg[USIM_IFG] &= ~UCRXIFG;
+		}
+		else if(pend & UCTXIFG){
+			u->reg[USIM_IV] = 0x04;
+			u->reg[USIM_IFG] &= ~UCTXIFG;
+		}
+		else if((pend & UCTXCPTIFG) && !(u->reg[USIM_CTLW0] & (UCSYNC << 8))){
+			u->reg[USIM_IV] = 0x08;
+			u->reg[USIM_IFG] &= ~UCTXCPTIFG;
+		}
+		else u->reg[USIM_IV] = 0x00;
+		break;
+	default:
+		break;
+	}
+	return &u->reg[reg];
+}
+
+/**************************************************************************//**
+ * \brief	Runs the simulation for a number of SMCLK cycles
+ *
+ * Pending ISRs are dispatched between cycles (the cycles spent inside an
+ * ISR count towards the total).
+ *
+ * \param	cycles	The number of SMCLK cycles to simulate
+ ******************************************************************************/
+void usciSimRun(unsigned long cycles)
+{
+	unsigned long end;
+
+	if(!usimReady) usciSimReset();
+	end = usimClock + cycles;
+	while(usimClock < end){
+		usimTick();
+		usimDispatch();
+	}
+}
+
+/**************************************************************************//**
+ * \brief	Runs the simulation until all modules are idle
+ *
+ * \param	maxCycles	Upper bound on the number of simulated cycles
+ * \return	The number of cycles simulated
+ ******************************************************************************/
+unsigned long usciSimIdle(unsigned long maxCycles)
+{
+	unsigned long start;
+
+	if(!usimReady) usciSimReset();
+	start = usimClock;
+	while(usimClock - start < maxCycles){
+		usimDispatch();
+		if(usimQuiet()) break;
+		usimTick();
+	}
+	return usimClock - start;
+}
+
+/**************************************************************************//**
+ * \brief	Get method for the simulated SMCLK cycle count
+ *
+ * \return	The number of SMCLK cycles since the last usciSimReset()
+ ******************************************************************************/
+unsigned long usciSimCycles(void)
+{
+	return usimClock;
+}
+
+/**************************************************************************//**
+ * \brief	Get method for the simulated low power mode cycle count
+ *
+ * \return	The number of cycles the CPU spent in LPMx (ISRs excluded) since
+ * 		the last usciSimReset()
+ ******************************************************************************/
+unsigned long usciSimSleepCycles(void)
+{
+	return usimSleep;
+}
+
+/**************************************************************************//**
+ * \brief	Queues bytes to be sent by the simulated peer
+ *
+ * In UART mode the bytes arrive on RXD back-to-back at the module baud rate,
+ * in SPI mode they are returned on SOMI (one per transmitted byte).
+ *
+ * \param	mod	The module index (USIM_A0..USIM_B1)
+ * \param	*data	The peer bytes
+ * \param	len	Number of bytes (bytes exceeding USIM_BUF_SIZE are dropped)
+ ******************************************************************************/
+void usciSimFeed(unsigned char mod, const unsigned char *data, unsigned int len)
+{
+	usciSimModule *u = &usim[mod];
+	unsigned int next;
+
+	if(!usimReady) usciSimReset();
+	while(len--){
+		next = (u->inHead + 1) % USIM_BUF_SIZE;
+		if(next == u->inTail) return;
+		u->in[u->inHead] = *(data++);
+		u->inHead = next;
+	}
+}
+
+/**************************************************************************//**
+ * \brief	Retrieves (and clears) the bytes shifted out by a module
+ *
+ * \param	mod	The module index (USIM_A0..USIM_B1)
+ * \param	*buf	Destination buffer
+ * \param	max	Size of the destination buffer
+ * \return	The number of bytes copied
+ ******************************************************************************/
+unsigned int usciSimDrain(unsigned char mod, unsigned char *buf, unsigned int max)
+{
+	usciSimModule *u = &usim[mod];
+	unsigned int len = u->outCount < max ? u->outCount : max;
+
+	memcpy(buf, u->out, len);
+	u->outCount = 0;
+	return len;
+}
+
+/**************************************************************************//**
+ * \brief	Get method for the statistics of a simulated module
+ *
+ * \param	mod		The module index (USIM_A0..USIM_B1)
+ * \param	*stats	Destination for the statistics snapshot
+ ******************************************************************************/
+void usciSimGetStats(unsigned char mod, usciSimStats *stats)
+{
+	*stats = usim[mod].stats;
+}
+
+/**************************************************************************//**
+ * \brief	Simulated DMA register access
+ *
+ * The access is counted, a read of DMAIV returns and clears the lowest
+ * numbered channel with both DMAIFG and DMAIE set.
+ *
+ * \param	reg	The register offset (USIM_DMACTL0..USIM_DMAxSZ(2))
+ * \return	Pointer to the simulated register
+ ******************************************************************************/
+volatile unsigned short *usciSimDmaReg(unsigned char reg)
+{
+	unsigned char ch;
+
+	if(!usimReady) usciSimReset();
+	usimDmaStats.regAccess++;
+	if(usimInIsr != USIM_NONE) usimIsrAccess++;
+
+	if(reg == USIM_DMAIV){
+		usimDmaReg[USIM_DMAIV] = DMAIV_NONE;
+		for(ch = 0; ch < USIM_DMA_CHANNELS; ch++){
+			if((usimDmaReg[USIM_DMAxCTL(ch)] & (DMAIFG + DMAIE)) == DMAIFG + DMAIE){
+				usimDmaReg[USIM_DMAxCTL(ch)] &= ~DMAIFG;
+				usimDmaReg[USIM_DMAIV] = 2 * (ch + 1);
+				break;
+			}
+		}
+	}
+	return &usimDmaReg[reg];
+}
+
+/**************************************************************************//**
+ * \brief	Simulated DMA address register access (DMAxSA/DMAxDA)
+ *
+ * \param	ch	The DMA channel
+ * \param	dst	0 for the source address, 1 for the destination address
+ * \return	Pointer to the simulated address register
+ ******************************************************************************/
+volatile void **usciSimDmaAddr(unsigned char ch, unsigned char dst)
+{
+	if(!usimReady) usciSimReset();
+	usimDmaStats.regAccess++;
+	if(usimInIsr != USIM_NONE) usimIsrAccess++;
+	return &usimDmaAddr[ch][dst ? 1 : 0];
+}
+
+/**************************************************************************//**
+ * \brief	Get method for the statistics of the simulated DMA controller
+ *
+ * \param	*stats	Destination for the statistics snapshot
+ ******************************************************************************/
+void usciSimGetDmaStats(usciSimDmaStats *stats)
+{
+	*stats = usimDmaStats;
+}
+
+/**************************************************************************//**
+ * \brief	Simulated _bis_SR_register()/__enable_interrupt() intrinsic
+ *
+ * Setting GIE dispatches any pending ISR. Setting CPUOFF (LPMx) runs the
+ * simulation until an ISR clears CPUOFF on exit (see usciSimBicOnExit()) or
+ * USIM_LPM_TIMEOUT cycles have passed.
+ *
+ * \param	bits	The SR bits to set
+ ******************************************************************************/
+void usciSimBisSR(unsigned int bits)
+{
+	unsigned long start = usimClock;
+
+	usciSimSR |= bits;
+	if(usimInIsr != USIM_NONE) return;
+	usimDispatch();
+	while((usciSimSR & CPUOFF) && usimClock - start < USIM_LPM_TIMEOUT){
+		usimTick();
+		usimSleep++;
+		usimDispatch();
+	}
+	usciSimSR &= ~(CPUOFF + SCG0 + SCG1 + OSCOFF);
+}
+
+/**************************************************************************//**
+ * \brief	Simulated __bic_SR_register_on_exit() intrinsic
+ *
+ * \param	bits	The SR bits to clear in the SR restored by RETI
+ ******************************************************************************/
+void usciSimBicOnExit(unsigned int bits)
+{
+	usimExitClear |= bits;
+}
+
+/**************************************************************************//**
+ * \brief	Sets the address of the simulated I2C slave
+ *
+ * \param	mod	The module index (USIM_B0 or USIM_B1)
+ * \param	addr	The (7 or 10 bit) address the slave acknowledges, other
+ * 		addresses being NACKed (USIM_I2C_ANY after usciSimReset())
+ ******************************************************************************/
+void usciSimI2cSlave(unsigned char mod, unsigned int addr)
+{
+	if(!usimReady) usciSimReset();
+	usim[mod].i2cSlave = addr;
+}
+
+/**************************************************************************//**
+ * \brief	Simulated Timer A0 register access (TA0CTL/TA0R/TA0CCTLn/TA0CCRn/TA0IV/TA0EX0)
+ *
+ * The timer counts SMCLK cycles (divided by ID and TAIDEX) while its MC
+ * bits are set. Inside an ISR the count includes the estimated CPU time
+ * already spent by the ISR (entry plus USIM_ACCESS_CYCLES per register
+ * access so far, this read included), so timestamps taken by the ISR see the
+ * same cycle costs as the simulator statistics. A TACLR write takes effect on the next access.
+ * Reading TA0IV returns and clears the highest priority compare flag.
+ *
+ * \param	reg	The register offset (USIM_TACTL..USIM_TAIV)
+ * \return	Pointer to the simulated register
+ ******************************************************************************/
+volatile unsigned short *usciSimTimerReg(unsigned char reg)
+{
+	unsigned long now = usimClock;
+	unsigned char ch;
+
+	if(!usimReady) usciSimReset();
+	if(usimInIsr != USIM_NONE){
+		usimIsrAccess++;
+		now += USIM_ENTRY_CYCLES + usimIsrAccess * USIM_ACCESS_CYCLES;
+	}
+	usimTimerSync(now);
+	if(reg == USIM_TAIV){
+		usimTimer[USIM_TAIV] = TA0IV_NONE;
+		for(ch = 0; ch < USIM_TIMER_CCRS; ch++){
+			if((usimTimer[USIM_TACCTL1 + ch] & (CCIFG + CCIE)) == CCIFG + CCIE){
+				usimTimer[USIM_TACCTL1 + ch] &= ~CCIFG;
+				usimTimer[USIM_TAIV] = TA0IV_TACCR1 + 2 * ch;
+				break;
+			}
+		}
+	}
+	return &usimTimer[reg];
+}
+
+/**************************************************************************//**
+ * \brief	Simulated Port 1 register access (P1IN..P1IFG)
+ *
+ * P1IN holds the CTS lines driven by usciSimCts(), P1OUT the RTS lines
+ * sampled by the peers (see usciSimFlow()).
+ *
+ * \param	reg	The register offset (USIM_PIN..USIM_PIFG)
+ * \return	Pointer to the simulated register
+ ******************************************************************************/
+volatile unsigned char *usciSimPortReg(unsigned char reg)
+{
+	if(!usimReady) usciSimReset();
+	if(usimInIsr != USIM_NONE) usimIsrAccess++;
+	return &usimPort[reg];
+}
+
+/**************************************************************************//**
+ * \brief	Connects the UART peer of a module to RTS/CTS flow control lines
+ *
+ * The peer finishes the character under way but starts no other one while
+ * the rtsPin bit of P1OUT is high (RTS deasserted), and drives the ctsPin
+ * bit of P1IN (low, i.e. ready, until usciSimCts() says otherwise).
+ *
+ * \param	mod	The simulated module
+ * \param	rtsPin	Port 1 bit of the module RTS output (0 for none)
+ * \param	ctsPin	Port 1 bit of the module CTS input (0 for none)
+ ******************************************************************************/
+void usciSimFlow(unsigned char mod, unsigned char rtsPin, unsigned char ctsPin)
+{
+	if(!usimReady) usciSimReset();
+	usim[mod].rtsPin = rtsPin;
+	usim[mod].ctsPin = ctsPin;
+	usimPort[USIM_PIN] &= ~ctsPin;
+}
+
+/**************************************************************************//**
+ * \brief	Sets the CTS line driven by the peer of a module
+ *
+ * A change of level sets the P1IFG bit of the line when it matches the
+ * P1IES edge (1: high to low, i.e. the peer becoming ready).
+ *
+ * \param	mod	The simulated module
+ * \param	ready	Non-zero to assert CTS (line low), 0 to deassert it (high)
+ ******************************************************************************/
+void usciSimCts(unsigned char mod, unsigned char ready)
+{
+	unsigned char pin = usim[mod].ctsPin;
+	unsigned char old = usimPort[USIM_PIN] & pin;
+
+	if(!usimReady) usciSimReset();
+	if(ready) usimPort[USIM_PIN] &= ~pin;
+	else usimPort[USIM_PIN] |= pin;
+	if(old != (usimPort[USIM_PIN] & pin) && ((usimPort[USIM_PIES] & pin) ? old : !old)) usimPort[USIM_PIFG] |= pin;
+}
+
+/**************************************************************************//**
+ * \brief	Queues a break + sync field (0x55) from the UART peer of a module
+ *
+ * The peer runs at its own rate (brw/mctlw as in usciConfig) for the break
+ * and the sync field, the bytes fed afterwards are clocked in at the module
+ * rate (the simulator does not model a rate mismatch otherwise). Only one
+ * break may be queued at a time.
+ *
+ * \param	mod	The simulated module (USIM_A0 or USIM_A1)
+ * \param	brw	Baud rate divisor of the peer
+ * \param	mctlw	Modulation control word of the peer (UCOS16 + UCBRFx used)
+ ******************************************************************************/
+void usciSimBreak(unsigned char mod, unsigned int brw, unsigned int mctlw)
+{
+	static const unsigned char sync = 0x55;
+	usciSimModule *u = &usim[mod];
+
+	if(!usimReady) usciSimReset();
+	u->peerBit = (mctlw & UCOS16) ? 16UL * brw + ((mctlw >> 4) & 0x0F) : brw;
+	if(!u->peerBit) u->peerBit = 1;
+	u->brkPos = u->inHead;
+	u->brk = USIM_BRK_PENDING;
+	usciSimFeed(mod, &sync, 1);
+}
+
+/**************************************************************************//**
+ * \brief	Starts a benchmark case on a module
+ *
+ * Takes a snapshot of the module and DMA statistics and of the cycle count.
+ * The application then issues the transfer(s) of the case (e.g. spiB0Write())
+ * and calls usciSimBenchEnd().
+ *
+ * \param	mod	The module index (USIM_A0..USIM_B1)
+ ******************************************************************************/
+void usciSimBenchStart(unsigned char mod)
+{
+	if(!usimReady) usciSimReset();
+	usimBenchStats = usim[mod].stats;
+	usimBenchDma = usimDmaStats;
+	usimBenchClock = usimClock;
+}
+
+/**************************************************************************//**
+ * \brief	Ends a benchmark case on a module
+ *
+ * Runs the simulation until all modules are idle (see usciSimIdle()), then
+ * computes the figures of the case from the differences to the snapshot of
+ * usciSimBenchStart(). CPU cycles cover the ISRs, status register polling and
+ * DMA stalls, the foreground code of the library calls is not included.
+ *
+ * \param	mod	The module index (USIM_A0..USIM_B1)
+ * \param	bytes	Payload bytes transferred by the case
+ * \param	*res	Destination for the benchmark result
+ ******************************************************************************/
+void usciSimBenchEnd(unsigned char mod, unsigned long bytes, usciSimBench *res)
+{
+	usciSimStats *s = &usim[mod].stats;
+
+	usciSimIdle(USIM_LPM_TIMEOUT);
+	res->bytes = bytes;
+	res->cycles = usimClock - usimBenchClock;
+	res->busCycles = s->busCycles - usimBenchStats.busCycles;
+	res->isrEntries = (s->isrEntries - usimBenchStats.isrEntries)
+		+ (usimDmaStats.isrEntries - usimBenchDma.isrEntries);
+	res->cpuCycles = (s->isrCycles - usimBenchStats.isrCycles)
+		+ (s->pollCycles - usimBenchStats.pollCycles)
+		+ (usimDmaStats.isrCycles - usimBenchDma.isrCycles)
+		+ (usimDmaStats.stallCycles - usimBenchDma.stallCycles);
+	res->regAccess = (s->regAccess - usimBenchStats.regAccess)
+		+ (usimDmaStats.regAccess - usimBenchDma.regAccess);
+}
+
+/**************************************************************************//**
+ * \brief	Prints a benchmark result and checks it against its thresholds
+ *
+ * One line of space separated key=value pairs is written to stdout:
+ * 	bench=<name> bytes= cycles= bus_cycles= bytes_per_s= isr_per_byte=
+ * 	cpu_per_byte= access_per_byte= result=PASS|FAIL[,<failed checks>]
+ *
+ * \param	*name	Name of the case (no spaces, e.g. "spiB0Write/brw4/64")
+ * \param	*res	The benchmark result (see usciSimBenchEnd())
+ * \param	*lim	The thresholds (0 for none)
+ * \return	Result of the threshold checks
+ *
+ * \retval	0	All checks passed
+ * \retval	-1	At least one check failed (or the case moved no bytes)
+ ******************************************************************************/
+int usciSimBenchReport(const char *name, const usciSimBench *res, const usciSimLimits *lim)
+{
+	double bps = res->cycles ? (double)res->bytes * USIM_SMCLK_FREQ / res->cycles : 0;
+	double n = res->bytes ? (double)res->bytes : 1;
+	char fail[40] = "";
+
+	if(!res->bytes) strcat(fail, ",bytes");
+	if(lim && lim->minBytesPerSec && bps < lim->minBytesPerSec) strcat(fail, ",bytes_per_s");
+	if(lim && lim->maxIsrPerKByte && res->isrEntries * 1024 > lim->maxIsrPerKByte * res->bytes) strcat(fail, ",isr");
+	if(lim && lim->maxCpuPerByte && res->cpuCycles > lim->maxCpuPerByte * res->bytes) strcat(fail, ",cpu");
+
+	printf("bench=%s bytes=%lu cycles=%lu bus_cycles=%lu bytes_per_s=%.0f isr_per_byte=%.3f cpu_per_byte=%.1f access_per_byte=%.2f result=%s%s\n",
+		name, res->bytes, res->cycles, res->busCycles, bps, res->isrEntries / n,
+		res->cpuCycles / n, res->regAccess / n, fail[0] ? "FAIL" : "PASS", fail);
+	return fail[0] ? -1 : 0;
+}
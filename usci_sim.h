@@ -0,0 +1,467 @@
+/******************************************************************************
+ * Host-side (Linux) register simulator for the eUSCI modules of the
+ * MSP430FR5739. This header stands in for "msp430fr5739.h" so that comm.c
+ * can be compiled and exercised with a native compiler:
+ *
+ *	gcc -DUSCI_HOST_SIM comm.c usci_sim.c app.c
+ *
+ * Every register macro below routes through usciSimReg() which counts the
+ * access and applies the hardware side effects (TXBUF load, RXBUF read,
+ * software reset...). A simulated shift register per module is clocked by
+ * usciSimRun()/usciSimIdle() at SMCLK rate and the existing USCI ISRs
+ * (usciA0Isr..usciB1Isr) are dispatched whenever (IFG & IE) is non-zero.
+ *
+ * NOTE: Cycle figures are estimates (fixed cost per ISR entry and per
+ * register access), bus time is exact to the simulated SMCLK cycle.
+ ******************************************************************************/
+#ifndef USCI_SIM_H_
+#define USCI_SIM_H_
+
+/**********************************************************
+ * Simulator Configuration
+ **********************************************************/
+#define USIM_MODULES		4		///< Number of simulated USCI modules [A0, A1, B0, B1]
+#define USIM_BUF_SIZE		4096		///< Size of the peer input/capture buffers (per module)
+#define USIM_ISR_CYCLES		11		///< CPU cycles per ISR entry/exit (6 cycle entry + 5 cycle RETI)
+#define USIM_ENTRY_CYCLES	6		///< CPU cycles of the ISR entry (part of USIM_ISR_CYCLES)
+#define USIM_ACCESS_CYCLES	3		///< Estimated CPU cycles per peripheral register access
+#define USIM_POLL_CYCLES	6		///< CPU cycles per polled status register read (BIT + JNZ)
+#define USIM_LPM_TIMEOUT	100000000UL	///< Max cycles spent in a simulated low power mode
+#define USIM_I2C_ANY		0xFFFF		///< Simulated I2C slave address acknowledging every address
+#define USIM_BREAK_BITS		14		///< Bit times of a peer break (13 bit LIN break + 1 bit delimiter)
+//#define USIM_F5XX_MAP			///< Number the DMA triggers and order the interrupt priorities as on the F5510/F5342 (or -DUSIM_F5XX_MAP). The registers, DMA channels and timings stay those of the FR5739, this is not an F5xx simulation
+#ifndef USIM_SMCLK_FREQ
+#define USIM_SMCLK_FREQ		8000000UL	///< Simulated SMCLK frequency (Hz), only used to scale the benchmark bytes/s figures
+#endif
+
+// Simulated module indices (match UCxx_INDEX in comm.h)
+#define USIM_A0			0		///< USCI A0 simulator index
+#define USIM_A1			1		///< USCI A1 simulator index
+#define USIM_B0			2		///< USCI B0 simulator index
+#define USIM_B1			3		///< USCI B1 simulator index
+
+// Simulated register file offsets
+#define USIM_CTLW0		0		///< Control word 0 (CTL1 = low byte, CTL0 = high byte)
+#define USIM_CTLW1		1		///< Control word 1
+#define USIM_BRW		2		///< Baud rate control word
+#define USIM_MCTLW		3		///< Modulation control word (eUSCI_A only)
+#define USIM_STATW		4		///< Status register
+#define USIM_RXBUF		5		///< Receive buffer
+#define USIM_TXBUF		6		///< Transmit buffer
+#define USIM_ABCTL		7		///< Auto baud control (eUSCI_A only)
+#define USIM_I2COA0		8		///< I2C own address (eUSCI_B only)
+#define USIM_I2CSA		9		///< I2C slave address (eUSCI_B only)
+#define USIM_IE			10		///< Interrupt enable
+#define USIM_IFG		11		///< Interrupt flags
+#define USIM_IV			12		///< Interrupt vector
+#define USIM_NREGS		13		///< Number of registers per module
+
+// Simulated DMA controller
+#define USIM_DMA_CHANNELS	3		///< Number of DMA channels (as on the FR5739)
+#ifdef USIM_F5XX_MAP
+#define USIM_DMA_TRIG_BASE	16		///< DMAxTSEL of UCA0RXIFG, followed by UCA0TXIFG, UCB0RX/TX, UCA1RX/TX, UCB1RX/TX (F5510/F5342)
+#define USIM_DMA_TRIG_MODS	{USIM_A0, USIM_B0, USIM_A1, USIM_B1}	///< Module of each RX/TX trigger pair from USIM_DMA_TRIG_BASE
+#else
+#define USIM_DMA_TRIG_BASE	14		///< DMAxTSEL of UCA0RXIFG, followed by UCA0TXIFG, UCA1RX/TX, UCB0RX/TX, UCB1RX/TX (FR5739)
+#define USIM_DMA_TRIG_MODS	{USIM_A0, USIM_A1, USIM_B0, USIM_B1}	///< Module of each RX/TX trigger pair from USIM_DMA_TRIG_BASE
+#endif // USIM_F5XX_MAP
+#define USIM_DMACTL0		0		///< Channel 0/1 trigger select
+#define USIM_DMACTL1		1		///< Channel 2 trigger select
+#define USIM_DMACTL2		2		///< Reserved
+#define USIM_DMACTL4		3		///< DMA module control
+#define USIM_DMAIV		4		///< DMA interrupt vector
+#define USIM_DMAxCTL(ch)	(5 + 2 * (ch))	///< Channel control register
+#define USIM_DMAxSZ(ch)		(6 + 2 * (ch))	///< Channel size register
+#define USIM_DMA_NREGS		11		///< Number of DMA registers
+
+// Simulated Timer A0 (free running timer with compare channels 1 and 2)
+#define USIM_TACTL		0		///< Timer control
+#define USIM_TAR		1		///< Timer counter
+#define USIM_TACCTL1		2		///< Capture/compare 1 control
+#define USIM_TACCTL2		3		///< Capture/compare 2 control
+#define USIM_TACCR1		4		///< Compare 1 value
+#define USIM_TACCR2		5		///< Compare 2 value
+#define USIM_TAIV		6		///< Timer interrupt vector (compare channels)
+#define USIM_TAEX0		7		///< Timer expansion (input divider extension)
+#define USIM_TIMER_NREGS	8		///< Number of timer registers
+#define USIM_TIMER_CCRS		2		///< Number of compare channels (CCR1, CCR2)
+
+// Simulated Port 1 (GPIO lines of the UART RTS/CTS flow control)
+#define USIM_PIN		0		///< Input
+#define USIM_POUT		1		///< Output
+#define USIM_PDIR		2		///< Direction
+#define USIM_PIES		3		///< Interrupt edge select (1: high to low)
+#define USIM_PIE		4		///< Interrupt enable
+#define USIM_PIFG		5		///< Interrupt flag
+#define USIM_PORT_NREGS		6		///< Number of port registers
+
+/// Simulated statistics for a single USCI module
+typedef struct usimstat
+{
+	unsigned long isrEntries;	///< Number of times the module ISR was entered
+	unsigned long regAccess;	///< CPU accesses to the module registers (all contexts)
+	unsigned long isrCycles;	///< Estimated CPU cycles spent inside the module ISR
+	unsigned long pollCycles;	///< CPU cycles spent polling the module status register
+	unsigned long busCycles;	///< SMCLK cycles the module shift register was active
+	unsigned long txBytes;		///< Bytes shifted out of the module
+	unsigned long rxBytes;		///< Bytes shifted into RXBUF
+	unsigned long overruns;		///< Bytes received while RXBUF was still unread
+} usciSimStats;
+
+/// Simulated statistics for the DMA controller
+typedef struct usimdmastat
+{
+	unsigned long transfers;	///< Bytes moved by the DMA controller
+	unsigned long stallCycles;	///< CPU cycles stolen by the DMA transfers (2 per transfer)
+	unsigned long isrEntries;	///< Number of times the DMA ISR was entered
+	unsigned long isrCycles;	///< Estimated CPU cycles spent inside the DMA ISR
+	unsigned long regAccess;	///< CPU accesses to the DMA registers (all contexts)
+} usciSimDmaStats;
+
+/// Result of a benchmark case (see usciSimBenchStart()/usciSimBenchEnd())
+typedef struct usimbench
+{
+	unsigned long bytes;		///< Payload bytes of the case
+	unsigned long cycles;		///< SMCLK cycles from the start of the case until the simulation went idle
+	unsigned long busCycles;	///< SMCLK cycles the module shift register was active
+	unsigned long isrEntries;	///< Module and DMA ISR entries
+	unsigned long cpuCycles;	///< CPU cycles spent in the module and DMA ISRs, polling and DMA stalls
+	unsigned long regAccess;	///< CPU accesses to the module and DMA registers (all contexts)
+} usciSimBench;
+
+/// Pass/fail thresholds of a benchmark case (0 disables a check)
+typedef struct usimlimits
+{
+	unsigned long minBytesPerSec;	///< Lowest acceptable throughput (bytes/s of simulated time at USIM_SMCLK_FREQ)
+	unsigned long maxIsrPerKByte;	///< Highest acceptable number of ISR entries per 1024 bytes
+	unsigned long maxCpuPerByte;	///< Highest acceptable number of CPU cycles per byte
+} usciSimLimits;
+
+/// Simulated eUSCI module (register file, shift register and peer line)
+typedef struct usim
+{
+	volatile unsigned short reg[USIM_NREGS];	///< Register file
+	unsigned char txShift;				///< TX shift register contents
+	unsigned long txLeft;				///< SMCLK cycles left on the current TX frame
+	unsigned long rxLeft;				///< SMCLK cycles left on the current (UART) RX frame
+	unsigned long busyLeft;				///< SMCLK cycles UCBUSY stays set after an SPI frame (trailing half bit clock)
+	unsigned char in[USIM_BUF_SIZE];		///< Peer bytes to be clocked in (UART RXD / SPI SOMI)
+	unsigned int inHead;				///< Peer input queue head
+	unsigned int inTail;				///< Peer input queue tail
+	unsigned char out[USIM_BUF_SIZE];		///< Capture of bytes shifted out
+	unsigned int outCount;				///< Number of captured bytes
+	usciSimStats stats;				///< Module statistics
+	unsigned char edge;				///< UCTXIFG/UCRXIFG set since the last DMA cycle (rising edges)
+	unsigned char i2cState;				///< I2C master bus phase (I2C mode only)
+	unsigned int i2cSlave;				///< Address acknowledged by the simulated I2C slave (or USIM_I2C_ANY)
+	unsigned char rtsPin;				///< Port 1 bit of the module RTS output (the peer pauses while high, 0 for none)
+	unsigned char ctsPin;				///< Port 1 bit of the module CTS input (driven by usciSimCts(), 0 for none)
+	unsigned char brk;				///< Peer break state (USIM_BRK_xxx in usci_sim.c, see usciSimBreak())
+	unsigned int brkPos;				///< Peer input queue index of the sync byte following the break
+	unsigned long peerBit;				///< SMCLK cycles per bit of the peer sending the break + sync field
+} usciSimModule;
+
+/**********************************************************
+ * Simulator API
+ **********************************************************/
+volatile unsigned short *usciSimReg(unsigned char mod, unsigned char reg);
+void usciSimReset(void);
+void usciSimRun(unsigned long cycles);
+unsigned long usciSimIdle(unsigned long maxCycles);
+unsigned long usciSimCycles(void);
+unsigned long usciSimSleepCycles(void);
+void usciSimFeed(unsigned char mod, const unsigned char *data, unsigned int len);
+unsigned int usciSimDrain(unsigned char mod, unsigned char *buf, unsigned int max);
+void usciSimGetStats(unsigned char mod, usciSimStats *stats);
+volatile unsigned short *usciSimDmaReg(unsigned char reg);
+volatile void **usciSimDmaAddr(unsigned char ch, unsigned char dst);
+void usciSimGetDmaStats(usciSimDmaStats *stats);
+void usciSimBisSR(unsigned int bits);
+void usciSimBicOnExit(unsigned int bits);
+void usciSimI2cSlave(unsigned char mod, unsigned int addr);
+volatile unsigned short *usciSimTimerReg(unsigned char reg);
+volatile unsigned char *usciSimPortReg(unsigned char reg);
+void usciSimFlow(unsigned char mod, unsigned char rtsPin, unsigned char ctsPin);
+void usciSimCts(unsigned char mod, unsigned char ready);
+void usciSimBreak(unsigned char mod, unsigned int brw, unsigned int mctlw);
+void usciSimBenchStart(unsigned char mod);
+void usciSimBenchEnd(unsigned char mod, unsigned long bytes, usciSimBench *res);
+int usciSimBenchReport(const char *name, const usciSimBench *res, const usciSimLimits *lim);
+extern volatile unsigned int usciSimSR;
+
+/**********************************************************
+ * Register Access Macros
+ **********************************************************/
+#define USIM_W(m, r)		(*usciSimReg((m), (r)))						///< 16-bit register access
+#define USIM_L(m, r)		(*(volatile unsigned char *)usciSimReg((m), (r)))		///< Register low byte access
+#define USIM_H(m, r)		(*((volatile unsigned char *)usciSimReg((m), (r)) + 1))	///< Register high byte access
+
+// USCI A0
+#define UCA0CTLW0		USIM_W(USIM_A0, USIM_CTLW0)
+#define UCA0CTL0		USIM_H(USIM_A0, USIM_CTLW0)
+#define UCA0CTL1		USIM_L(USIM_A0, USIM_CTLW0)
+#define UCA0CTLW1		USIM_W(USIM_A0, USIM_CTLW1)
+#define UCA0BRW			USIM_W(USIM_A0, USIM_BRW)
+#define UCA0MCTLW		USIM_W(USIM_A0, USIM_MCTLW)
+#define UCA0STATW		USIM_W(USIM_A0, USIM_STATW)
+#define UCA0STAT		USIM_L(USIM_A0, USIM_STATW)
+#define UCA0RXBUF		USIM_W(USIM_A0, USIM_RXBUF)
+#define UCA0TXBUF		USIM_W(USIM_A0, USIM_TXBUF)
+#define UCA0ABCTL		USIM_W(USIM_A0, USIM_ABCTL)
+#define UCA0IE			USIM_W(USIM_A0, USIM_IE)
+#define UCA0IFG			USIM_W(USIM_A0, USIM_IFG)
+#define UCA0IV			USIM_W(USIM_A0, USIM_IV)
+// USCI A1
+#define UCA1CTLW0		USIM_W(USIM_A1, USIM_CTLW0)
+#define UCA1CTL0		USIM_H(USIM_A1, USIM_CTLW0)
+#define UCA1CTL1		USIM_L(USIM_A1, USIM_CTLW0)
+#define UCA1CTLW1		USIM_W(USIM_A1, USIM_CTLW1)
+#define UCA1BRW			USIM_W(USIM_A1, USIM_BRW)
+#define UCA1MCTLW		USIM_W(USIM_A1, USIM_MCTLW)
+#define UCA1STATW		USIM_W(USIM_A1, USIM_STATW)
+#define UCA1STAT		USIM_L(USIM_A1, USIM_STATW)
+#define UCA1RXBUF		USIM_W(USIM_A1, USIM_RXBUF)
+#define UCA1TXBUF		USIM_W(USIM_A1, USIM_TXBUF)
+#define UCA1ABCTL		USIM_W(USIM_A1, USIM_ABCTL)
+#define UCA1IE			USIM_W(USIM_A1, USIM_IE)
+#define UCA1IFG			USIM_W(USIM_A1, USIM_IFG)
+#define UCA1IV			USIM_W(USIM_A1, USIM_IV)
+// USCI B0
+#define UCB0CTLW0		USIM_W(USIM_B0, USIM_CTLW0)
+#define UCB0CTL0		USIM_H(USIM_B0, USIM_CTLW0)
+#define UCB0CTL1		USIM_L(USIM_B0, USIM_CTLW0)
+#define UCB0CTLW1		USIM_W(USIM_B0, USIM_CTLW1)
+#define UCB0BRW			USIM_W(USIM_B0, USIM_BRW)
+#define UCB0STATW		USIM_W(USIM_B0, USIM_STATW)
+#define UCB0STAT		USIM_L(USIM_B0, USIM_STATW)
+#define UCB0RXBUF		USIM_W(USIM_B0, USIM_RXBUF)
+#define UCB0TXBUF		USIM_W(USIM_B0, USIM_TXBUF)
+#define UCB0I2COA0		USIM_W(USIM_B0, USIM_I2COA0)
+#define UCB0I2CSA		USIM_W(USIM_B0, USIM_I2CSA)
+#define UCB0IE			USIM_W(USIM_B0, USIM_IE)
+#define UCB0IFG			USIM_W(USIM_B0, USIM_IFG)
+#define UCB0IV			USIM_W(USIM_B0, USIM_IV)
+// USCI B1 (not present on the FR5739, simulated for the F5xx HALs)
+#define UCB1CTLW0		USIM_W(USIM_B1, USIM_CTLW0)
+#define UCB1CTL0		USIM_H(USIM_B1, USIM_CTLW0)
+#define UCB1CTL1		USIM_L(USIM_B1, USIM_CTLW0)
+#define UCB1CTLW1		USIM_W(USIM_B1, USIM_CTLW1)
+#define UCB1BRW			USIM_W(USIM_B1, USIM_BRW)
+#define UCB1STATW		USIM_W(USIM_B1, USIM_STATW)
+#define UCB1STAT		USIM_L(USIM_B1, USIM_STATW)
+#define UCB1RXBUF		USIM_W(USIM_B1, USIM_RXBUF)
+#define UCB1TXBUF		USIM_W(USIM_B1, USIM_TXBUF)
+#define UCB1I2COA0		USIM_W(USIM_B1, USIM_I2COA0)
+#define UCB1I2CSA		USIM_W(USIM_B1, USIM_I2CSA)
+#define UCB1IE			USIM_W(USIM_B1, USIM_IE)
+#define UCB1IFG			USIM_W(USIM_B1, USIM_IFG)
+#define UCB1IV			USIM_W(USIM_B1, USIM_IV)
+
+// DMA controller
+#define DMACTL0			(*usciSimDmaReg(USIM_DMACTL0))
+#define DMACTL1			(*usciSimDmaReg(USIM_DMACTL1))
+#define DMACTL2			(*usciSimDmaReg(USIM_DMACTL2))
+#define DMACTL4			(*usciSimDmaReg(USIM_DMACTL4))
+#define DMAIV			(*usciSimDmaReg(USIM_DMAIV))
+#define DMA0CTL			(*usciSimDmaReg(USIM_DMAxCTL(0)))
+#define DMA0SZ			(*usciSimDmaReg(USIM_DMAxSZ(0)))
+#define DMA0SA			(*usciSimDmaAddr(0, 0))
+#define DMA0DA			(*usciSimDmaAddr(0, 1))
+#define DMA1CTL			(*usciSimDmaReg(USIM_DMAxCTL(1)))
+#define DMA1SZ			(*usciSimDmaReg(USIM_DMAxSZ(1)))
+#define DMA1SA			(*usciSimDmaAddr(1, 0))
+#define DMA1DA			(*usciSimDmaAddr(1, 1))
+#define DMA2CTL			(*usciSimDmaReg(USIM_DMAxCTL(2)))
+#define DMA2SZ			(*usciSimDmaReg(USIM_DMAxSZ(2)))
+#define DMA2SA			(*usciSimDmaAddr(2, 0))
+#define DMA2DA			(*usciSimDmaAddr(2, 1))
+#define DMA_ADDR(reg, addr)	((reg) = (volatile void *)(addr))	///< DMA address register write (host pointers)
+
+// Timer A0
+#define TA0CTL			(*usciSimTimerReg(USIM_TACTL))
+#define TA0R			(*usciSimTimerReg(USIM_TAR))
+#define TA0CCTL1		(*usciSimTimerReg(USIM_TACCTL1))
+#define TA0CCTL2		(*usciSimTimerReg(USIM_TACCTL2))
+#define TA0CCR1			(*usciSimTimerReg(USIM_TACCR1))
+#define TA0CCR2			(*usciSimTimerReg(USIM_TACCR2))
+#define TA0IV			(*usciSimTimerReg(USIM_TAIV))
+#define TA0EX0			(*usciSimTimerReg(USIM_TAEX0))
+
+// Port 1
+#define P1IN			(*usciSimPortReg(USIM_PIN))
+#define P1OUT			(*usciSimPortReg(USIM_POUT))
+#define P1DIR			(*usciSimPortReg(USIM_PDIR))
+#define P1IES			(*usciSimPortReg(USIM_PIES))
+#define P1IE			(*usciSimPortReg(USIM_PIE))
+#define P1IFG			(*usciSimPortReg(USIM_PIFG))
+
+/**********************************************************
+ * Register Bit Definitions (byte-wise, as used in comm.h)
+ **********************************************************/
+// UCxCTL0 (CTLW0 high byte)
+#define UCPEN			0x80		///< UART: Parity enable
+#define UCPAR			0x40		///< UART: Even parity
+#define UCMSB			0x20		///< MSB first select
+#define UC7BIT			0x10		///< 7-bit character length
+#define UCSPB			0x08		///< UART: Two stop bits
+#define UCMODE1			0x04		///< Mode select bit 1
+#define UCMODE0			0x02		///< Mode select bit 0
+#define UCSYNC			0x01		///< Synchronous mode enable
+#define UCCKPH			0x80		///< SPI: Clock phase select
+#define UCCKPL			0x40		///< SPI: Clock polarity select
+#define UCMST			0x08		///< SPI/I2C: Master mode select
+#define UCA10			0x80		///< I2C: 10-bit own address
+#define UCSLA10			0x40		///< I2C: 10-bit slave address
+#define UCMM			0x20		///< I2C: Multi-master environment
+#define UCMODE_0		0x00		///< Mode 0: UART / 3-pin SPI
+#define UCMODE_1		0x02		///< Mode 1: Idle-line multiprocessor / 4-pin SPI (STE high)
+#define UCMODE_2		0x04		///< Mode 2: Address-bit multiprocessor / 4-pin SPI (STE low)
+#define UCMODE_3		0x06		///< Mode 3: Auto baud UART / I2C
+// UCxCTL1 (CTLW0 low byte)
+#define UCSSEL1			0x80		///< Clock source select bit 1
+#define UCSSEL0			0x40		///< Clock source select bit 0
+#define UCSSEL__UCLK		0x00		///< Clock source: UCLK
+#define UCSSEL__ACLK		0x40		///< Clock source: ACLK
+#define UCSSEL__SMCLK		0x80		///< Clock source: SMCLK
+#define UCRXEIE			0x20		///< UART: Receive erroneous-character interrupt enable
+#define UCBRKIE			0x10		///< UART: Receive break character interrupt enable
+#define UCDORM			0x08		///< UART: Dormant (sleep) mode
+#define UCTXADDR		0x04		///< UART: Transmit address
+#define UCTXBRK			0x02		///< UART: Transmit break
+#define UCTR			0x10		///< I2C: Transmitter/receiver
+#define UCTXNACK		0x08		///< I2C: Transmit NACK
+#define UCTXSTP			0x04		///< I2C: Transmit STOP condition
+#define UCTXSTT			0x02		///< I2C: Transmit START condition
+#define UCSWRST			0x01		///< Software reset enable
+// UCxSTATW
+#define UCLISTEN		0x80		///< Listen (loopback) enable
+#define UCFE			0x40		///< UART: Framing error flag
+#define UCOE			0x20		///< Overrun error flag
+#define UCPE			0x10		///< UART: Parity error flag
+#define UCBRK			0x08		///< UART: Break detect flag
+#define UCRXERR			0x04		///< Receive error flag
+#define UCADDR			0x02		///< UART: Address received
+#define UCIDLE			0x02		///< UART: Idle line detected
+#define UCBUSY			0x01		///< USCI busy flag
+#define UCBBUSY			0x10		///< I2C: Bus busy
+// UCxMCTLW
+#define UCOS16			0x0001		///< Oversampling mode enable
+// UCAxABCTL
+#define UCABDEN			0x01		///< Automatic baud rate detect enable
+#define UCBTOE			0x04		///< Break timeout error
+#define UCSTOE			0x08		///< Synch field timeout error
+// UCxIE / UCxIFG
+#define UCRXIE			0x01		///< Receive interrupt enable
+#define UCTXIE			0x02		///< Transmit interrupt enable
+#define UCSTTIE			0x04		///< Start (I2C) / start bit (UART) interrupt enable
+#define UCSTPIE			0x08		///< I2C: Stop condition interrupt enable
+#define UCTXCPTIE		0x08		///< UART: Transmit complete interrupt enable
+#define UCALIE			0x10		///< I2C: Arbitration lost interrupt enable
+#define UCNACKIE		0x20		///< I2C: NACK interrupt enable
+#define UCRXIFG			0x01		///< Receive interrupt flag
+#define UCTXIFG			0x02		///< Transmit interrupt flag
+#define UCSTTIFG		0x04		///< Start (I2C) / start bit (UART) interrupt flag
+#define UCSTPIFG		0x08		///< I2C: Stop condition interrupt flag
+#define UCTXCPTIFG		0x08		///< UART: Transmit complete interrupt flag
+#define UCALIFG			0x10		///< I2C: Arbitration lost interrupt flag
+#define UCNACKIFG		0x20		///< I2C: NACK interrupt flag
+#define UCRXIFG0		UCRXIFG		///< I2C: Receive interrupt flag 0
+#define UCTXIFG0		UCTXIFG		///< I2C: Transmit interrupt flag 0
+// UCBxIV (I2C mode)
+#define USCI_I2C_UCALIFG	0x0002		///< Arbitration lost
+#define USCI_I2C_UCNACKIFG	0x0004		///< Slave NACK
+#define USCI_I2C_UCSTTIFG	0x0006		///< Start condition (slave mode)
+#define USCI_I2C_UCSTPIFG	0x0008		///< Stop condition
+#define USCI_I2C_UCRXIFG0	0x0016		///< Receive buffer full (slot 0)
+#define USCI_I2C_UCTXIFG0	0x0018		///< Transmit buffer empty (slot 0)
+#define USCI_I2C_UCBIT9IFG	0x001E		///< Ninth bit (highest vector value)
+
+// DMAxCTL
+#define DMADT_0			0x0000		///< Single transfer
+#define DMADSTINCR_0		0x0000		///< Destination address unchanged
+#define DMADSTINCR_2		0x0800		///< Destination address decremented
+#define DMADSTINCR_3		0x0C00		///< Destination address incremented
+#define DMASRCINCR_0		0x0000		///< Source address unchanged
+#define DMASRCINCR_2		0x0200		///< Source address decremented
+#define DMASRCINCR_3		0x0300		///< Source address incremented
+#define DMADSTBYTE		0x0080		///< Destination byte access
+#define DMASRCBYTE		0x0040		///< Source byte access
+#define DMALEVEL		0x0020		///< Level sensitive trigger
+#define DMAEN			0x0010		///< Channel enable
+#define DMAIFG			0x0008		///< Channel interrupt flag
+#define DMAIE			0x0004		///< Channel interrupt enable
+#define DMAABORT		0x0002		///< Transfer aborted (NMI)
+#define DMAREQ			0x0001		///< Software request
+// DMAIV
+#define DMAIV_NONE		0x0000		///< No DMA interrupt pending
+#define DMAIV_DMA0IFG		0x0002		///< Channel 0 complete
+#define DMAIV_DMA1IFG		0x0004		///< Channel 1 complete
+#define DMAIV_DMA2IFG		0x0006		///< Channel 2 complete
+
+// TAxCTL
+#define TASSEL__SMCLK		0x0200		///< Clock source: SMCLK (the only source simulated)
+#define MC__STOP		0x0000		///< Timer halted
+#define MC__CONTINUOUS		0x0020		///< Continuous mode (any MC setting counts continuously)
+#define MC_3			0x0030		///< Mode control mask
+#define TACLR			0x0004		///< Timer clear
+#define ID__1			0x0000		///< Input divider: /1
+#define ID__2			0x0040		///< Input divider: /2
+#define ID__4			0x0080		///< Input divider: /4
+#define ID__8			0x00C0		///< Input divider: /8
+#define ID_3			0x00C0		///< Input divider mask
+// TAxEX0
+#define TAIDEX_0		0x0000		///< Input divider extension: /1
+#define TAIDEX_1		0x0001		///< Input divider extension: /2
+#define TAIDEX_3		0x0003		///< Input divider extension: /4
+#define TAIDEX_7		0x0007		///< Input divider extension: /8
+// TAxCCTLn (compare mode only)
+#define CCIE			0x0010		///< Compare interrupt enable
+#define CCIFG			0x0001		///< Compare interrupt flag (set when TAR reaches TAxCCRn)
+// TAxIV
+#define TA0IV_NONE		0x0000		///< No compare interrupt pending
+#define TA0IV_TACCR1		0x0002		///< Compare 1 (highest priority)
+#define TA0IV_TACCR2		0x0004		///< Compare 2
+
+// Interrupt vectors (only used by the #pragma vector lines, ignored on the host)
+#define USCI_A0_VECTOR		0
+#define USCI_A1_VECTOR		1
+#define USCI_B0_VECTOR		2
+#define USCI_B1_VECTOR		3
+#define DMA_VECTOR		4
+#define TIMER0_A1_VECTOR	5
+#define PORT1_VECTOR		6
+
+// Port bits
+#define BIT0			0x0001
+#define BIT1			0x0002
+#define BIT2			0x0004
+#define BIT3			0x0008
+#define BIT4			0x0010
+#define BIT5			0x0020
+#define BIT6			0x0040
+#define BIT7			0x0080
+
+/**********************************************************
+ * Status Register and Compiler Intrinsics
+ **********************************************************/
+#define GIE			0x0008		///< General interrupt enable
+#define CPUOFF			0x0010		///< CPU off (LPM0)
+#define OSCOFF			0x0020		///< Oscillator off
+#define SCG0			0x0040		///< System clock generator 0 off
+#define SCG1			0x0080		///< System clock generator 1 off
+#define LPM0_bits		(CPUOFF)
+#define LPM3_bits		(SCG1 + SCG0 + CPUOFF)
+
+#define __interrupt
+#define _get_SR_register()		(usciSimSR)
+#define _disable_interrupts()		(usciSimSR &= ~GIE)
+#define __disable_interrupt()		(usciSimSR &= ~GIE)
+#define _enable_interrupts()		usciSimBisSR(GIE)
+#define __enable_interrupt()		usciSimBisSR(GIE)
+#define _bis_SR_register(x)		usciSimBisSR(x)
+#define __bis_SR_register(x)		usciSimBisSR(x)
+#define __bic_SR_register_on_exit(x)	usciSimBicOnExit(x)
+#define __even_in_range(x, y)		(x)
+#define __no_operation()
+
+#endif /* USCI_SIM_H_ */
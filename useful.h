@@ -3,7 +3,7 @@
 #define USEFUL_H_
 
 // Critical Section Code
-#define enter_critical(SR_state)           do {\	
+#define enter_critical(SR_state)           do {\
   (SR_state) = (_get_SR_register() & 0x08); \
   _disable_interrupts(); \
 } while (0) ///< Critical section entrance macro